@@ -1,22 +1,35 @@
 #include "Hooks.hpp"
 #include <cell/gcm.h>
+#include "Utils/Allocator.hpp"
 
 ImportExportDetour* cellGcmSetFlipCommandHk;
 
 void cellGcmSetFlipCommandHook(CellGcmContextData* gcmThis, uint8_t id)
 {
-
+    // One flip per frame, the allocator stats count allocations per frame from here.
+    Allocator::GetDefault().NewFrame();
 
     cellGcmSetFlipCommandHk->GetOriginal<void>(gcmThis, id);
 }
 
 void InstallHooks()
 {
+    // Hooks go live together once they're all found
+    DetourTransaction transaction;
+
     // Swap buffers?? Universal for all games
-    cellGcmSetFlipCommandHk = new ImportExportDetour(ImportExportDetour::Import, "cellGcmSys", 0x21397818, (uintptr_t)cellGcmSetFlipCommandHook);
+    cellGcmSetFlipCommandHk = new ImportExportDetour(ImportExportDetour::Import, "cellGcmSys", 0x21397818, (uintptr_t)cellGcmSetFlipCommandHook, transaction);
+
+    if (!transaction.Commit())
+    {
+        // Nothing got hooked, don't keep detours around that RemoveHooks would try to unhook.
+        delete cellGcmSetFlipCommandHk;
+        cellGcmSetFlipCommandHk = nullptr;
+    }
 }
 
 void RemoveHooks()
 {
     delete cellGcmSetFlipCommandHk;
+    cellGcmSetFlipCommandHk = nullptr;
 }
\ No newline at end of file
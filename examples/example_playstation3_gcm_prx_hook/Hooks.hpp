@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include "Memory/Detour.hpp"
+#include "Memory/DetourTransaction.hpp"
 
 void InstallHooks();
 void RemoveHooks();
\ No newline at end of file
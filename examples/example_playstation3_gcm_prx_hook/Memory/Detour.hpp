@@ -2,9 +2,13 @@
 #include <string>
 #include "Utils/Exports.hpp"
 #include "Memory.hpp"
+#include "TrampolinePool.hpp"
+#include "DetourPatch.hpp"
 
 #define MARK_AS_EXECUTABLE __attribute__((section(".text")))
 
+class DetourTransaction;
+
 class Detour
 {
 public:
@@ -39,56 +43,39 @@ public:
         return original(args...);
     }
 
+    // Function used to patch code, WriteProcessMemory by default. nullptr restores the default.
+    typedef DetourMemoryWriter MemoryWriter;
+    static void SetMemoryWriter(MemoryWriter writer);
+
+    // Trampoline slots available to all detours, and how many are taken by installed hooks.
+    static size_t GetTrampolineCapacity() { return GetTrampolinePool().GetCapacity(); }
+    static size_t GetTrampolineUsedCount() { return GetTrampolinePool().GetUsedCount(); }
+
 
 private:
-    /***
-    * Writes an unconditional branch to the destination address that will branch to the target address.
-    * @param destination Where the branch will be written to.
-    * @param branchTarget The address the branch will jump to.
-    * @param linked Branch is a call or a jump? aka bl or b
-    * @param preserveRegister Preserve the register clobbered after loading the branch address.
-    * @returns size of relocating the instruction in bytes
-    */
-    size_t Jump(void* destination, const void* branchTarget, bool linked, bool preserveRegister);
+    friend class DetourTransaction;
 
-    /***
-    * Writes both conditional and unconditional branches using the count register to the destination address that will branch to the target address.
-    * @param destination Where the branch will be written to.
-    * @param branchTarget The address the branch will jump to.
-    * @param linked Branch is a call or a jump? aka bl or b
-    * @param preserveRegister Preserve the register clobbered after loading the branch address.
-    * @param branchOptions Options for determining when a branch to be followed.
-    * @param conditionRegisterBit The bit of the condition register to compare.
-    * @param registerIndex Register to use when loading the destination address into the count register.
-    * @returns size of relocating the instruction in bytes
-    */
-    size_t JumpWithOptions(void* destination, const void* branchTarget, bool linked, bool preserveRegister,
-        uint32_t branchOptions, uint8_t conditionRegisterBit, uint8_t registerIndex);
+    static const size_t MaxHookSize = DetourPatch::MaxHookSize;
 
-    /***
-    * Copies and fixes relative branch instructions to a new location.
-    * @param destination Where to write the new branch.
-    * @param source Address to the instruction that is being relocated.
-    * @returns size of relocating the instruction in bytes
-    */
-    size_t RelocateBranch(uint32_t* destination, uint32_t* source);
+    // Everything a hook writes, assembled before anything gets written.
+    struct Patch
+    {
+        DetourPatch  Code;
+        uint32_t     Toc;
+    };
 
     /***
-    * Copies an instruction enusuring things such as PC relative offsets are fixed.
-    * @param destination Where to write the new instruction(s).
-    * @param source Address to the instruction that is being copied.
-    * @returns size of relocating the instruction in bytes
+    * First half of Hook(): takes a trampoline slot, saves the original instructions and assembles the patches, without writing anything.
+    * @param patch Receives the trampoline and the branch to the callback.
+    * @returns false if every trampoline slot is taken, or an overwritten instruction can't be relocated into the trampoline
     */
-    size_t RelocateCode(uint32_t* destination, uint32_t* source);
+    bool Prepare(uintptr_t fnAddress, uintptr_t fnCallback, uintptr_t tocOverride, Patch* patch);
 
-    /***
-    * Get's size of method hook in bytes
-    * @param branchTarget The address the branch will jump to.
-    * @param linked Branch is a call or a jump? aka bl or b
-    * @param preserveRegister Preserve the register clobbered after loading the branch address.
-    * @returns size of hook in bytes
-    */
-    size_t GetHookSize(const void* branchTarget, bool linked, bool preserveRegister);
+    // Second half of Hook(), once DetourPatch::CommitAll() wrote the patch: makes the trampoline callable through GetOriginal().
+    void CompleteHook(const Patch& patch);
+
+    // Releases what Prepare() took, for a hook that never got written.
+    void CancelPatch();
 
     /***
     * Retrieve infomation about address which contains bytes and name of hook owner
@@ -103,12 +90,15 @@ protected:
     void*        m_HookAddress;               // The function we are hooking.
     uint8_t*     m_TrampolineAddress;         // Pointer to the trampoline for this detour.
     uint32_t     m_TrampolineOpd[2];          // opd_s of the trampoline for this detour.
-    uint8_t      m_OriginalInstructions[30];  // Any bytes overwritten by the hook.
+    uint8_t      m_OriginalInstructions[MaxHookSize];  // Any bytes overwritten by the hook.
     size_t       m_OriginalLength;            // The amount of bytes overwritten by the hook.
 
     // Shared
-    MARK_AS_EXECUTABLE static uint8_t   s_TrampolineBuffer[1024];
-    static size_t                       s_TrampolineSize;
+    MARK_AS_EXECUTABLE static uint8_t   s_TrampolineBuffer[TrampolinePool::SlotSize * 64];
+    static MemoryWriter                 s_MemoryWriter;
+
+    // Slots of s_TrampolineBuffer. Built on first use, see Detour.cpp.
+    static TrampolinePool& GetTrampolinePool();
 };
 
 // list of fnids https://github.com/aerosoul94/ida_gel/blob/master/src/ps3/ps3.xml
@@ -118,18 +108,31 @@ public:
     enum HookType { Import = 0, Export = 1 };
 public:
     ImportExportDetour(HookType type, const std::string& libaryName, uint32_t fnid, uintptr_t fnCallback);
+
+    // Queues the hook in the transaction, it gets installed with the others by DetourTransaction::Commit().
+    ImportExportDetour(HookType type, const std::string& libaryName, uint32_t fnid, uintptr_t fnCallback, DetourTransaction& transaction);
     virtual ~ImportExportDetour();
 
     virtual void Hook(uintptr_t fnAddress, uintptr_t fnCallback, uintptr_t tocOverride = 0) override;
     virtual bool UnHook() override;
 
+    // Lookups go through an index of the process import/export tables built on first use.
     opd_s* FindExportByName(const char* module, uint32_t fnid);
     opd_s* FindImportByName(const char* module, uint32_t fnid);
 
+    // Drops the indexes so the next lookup rebuilds them, ex: after the process tables changed.
+    static void InvalidateStubIndex();
+
 private:
-    void HookByFnid(HookType type, const std::string& libaryName, uint32_t fnid, uintptr_t fnCallback);
+    void HookByFnid(HookType type, const std::string& libaryName, uint32_t fnid, uintptr_t fnCallback, DetourTransaction* transaction);
+
+    static uint32_t* GetProcessPrxInfo();
 
 private:
     std::string m_LibaryName;
     uint32_t m_Fnid;
+
+    // Shared
+    static StubIndex s_ImportIndex;
+    static StubIndex s_ExportIndex;
 };
\ No newline at end of file
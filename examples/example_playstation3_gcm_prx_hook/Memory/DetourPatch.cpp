@@ -0,0 +1,72 @@
+#include "DetourPatch.hpp"
+#include "PowerPC.hpp"
+#include <string.h>
+
+static void* AddressToPointer(uint32_t address)
+{
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(address));
+}
+
+bool DetourPatch::Assemble(const uint32_t* code, uint32_t hookAddress, uint32_t hookTarget, uint32_t trampolineAddress)
+{
+    HookAddress = hookAddress;
+    TrampolineAddress = trampolineAddress;
+
+    // The branch to the function that we are hooking, its size is how much of the original gets overwritten.
+    HookSize = PowerPC::AssembleBranch(reinterpret_cast<uint32_t*>(Hook), hookAddress, hookTarget, false, false);
+    memcpy(Original, code, HookSize);
+
+    // Copy and fix the overwritten instructions.
+    TrampolineSize = 0;
+    for (size_t i = 0; i < (HookSize / sizeof(uint32_t)); i++)
+    {
+        // The function starts with a loop branch whose target the trampoline can't reach without clobbering the counter.
+        const size_t RelocatedSize = PowerPC::Relocate(reinterpret_cast<uint32_t*>(&Trampoline[TrampolineSize]), code[i],
+            hookAddress + static_cast<uint32_t>(i * sizeof(uint32_t)), trampolineAddress + static_cast<uint32_t>(TrampolineSize));
+        if (RelocatedSize == 0)
+            return false;
+        TrampolineSize += RelocatedSize;
+    }
+
+    // Trampoline branches back to the original function after the branch we used to hook.
+    TrampolineSize += PowerPC::AssembleBranch(reinterpret_cast<uint32_t*>(&Trampoline[TrampolineSize]), trampolineAddress + static_cast<uint32_t>(TrampolineSize),
+        hookAddress + static_cast<uint32_t>(HookSize), false, true);
+    return true;
+}
+
+bool DetourPatch::WriteTrampoline(DetourMemoryWriter writer, uint32_t pid) const
+{
+    return writer(pid, AddressToPointer(TrampolineAddress), Trampoline, TrampolineSize) == 0;
+}
+
+bool DetourPatch::WriteHook(DetourMemoryWriter writer, uint32_t pid) const
+{
+    return writer(pid, AddressToPointer(HookAddress), Hook, HookSize) == 0;
+}
+
+bool DetourPatch::Restore(DetourMemoryWriter writer, uint32_t pid) const
+{
+    return writer(pid, AddressToPointer(HookAddress), Original, HookSize) == 0;
+}
+
+bool DetourPatch::CommitAll(const DetourPatch* const* patches, size_t count, DetourMemoryWriter writer, uint32_t pid)
+{
+    // Trampolines first, nothing branches to them yet: a failure leaves every function untouched.
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!patches[i]->WriteTrampoline(writer, pid))
+            return false;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!patches[i]->WriteHook(writer, pid))
+        {
+            for (size_t j = 0; j <= i; j++)
+                patches[j]->Restore(writer, pid);
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "TrampolinePool.hpp"
+
+// What a Detour writes to install a hook: assembled locally, then committed with a single write per region.
+// Doesn't depend on anything from the PS3 SDK, addresses are the ones the code runs at and the writer comes from the caller.
+
+/***
+* Function used to patch code, called once per region. WriteProcessMemory on the console.
+* @returns 0 (SUCCEEDED) once the whole region is written
+*/
+typedef int (*DetourMemoryWriter)(uint32_t pid, void* address, const void* data, size_t size);
+
+struct DetourPatch
+{
+    static const size_t MaxHookSize = 30;
+
+    uint32_t     HookAddress;                           // The function we are hooking.
+    uint32_t     TrampolineAddress;                     // Slot the trampoline gets written to.
+    uint8_t      Trampoline[TrampolinePool::SlotSize];  // The overwritten instructions relocated, then the branch back.
+    uint8_t      Hook[MaxHookSize];                     // The branch to the callback.
+    uint8_t      Original[MaxHookSize];                 // Any bytes overwritten by the hook.
+    size_t       TrampolineSize;
+    size_t       HookSize;
+
+    /***
+    * Assembles the trampoline and the hook without writing anything.
+    * A callback within ±32 MB is reached with a single 'b', so only one instruction of the original gets overwritten.
+    * @param code The first instructions of the function, at least MaxHookSize bytes. Code is readable: the function itself on the console.
+    * @param hookAddress Address of the function.
+    * @param hookTarget The address the hook will jump to.
+    * @param trampolineAddress Address of the trampoline slot.
+    * @returns false if an overwritten instruction can't be relocated into the trampoline (see PowerPC::Relocate)
+    */
+    bool Assemble(const uint32_t* code, uint32_t hookAddress, uint32_t hookTarget, uint32_t trampolineAddress);
+
+    // One write each. The trampoline goes first: nothing branches to it until the hook is written.
+    bool WriteTrampoline(DetourMemoryWriter writer, uint32_t pid) const;
+    bool WriteHook(DetourMemoryWriter writer, uint32_t pid) const;
+
+    // Writes the original instructions back over the hook.
+    bool Restore(DetourMemoryWriter writer, uint32_t pid) const;
+
+    /***
+    * Commits a set of patches: every trampoline first, then every hook back to back.
+    * If a write fails the hooks written so far are restored, the failed one included since its write may have landed in part.
+    * @returns false if a write failed, none of the functions is hooked then
+    */
+    static bool CommitAll(const DetourPatch* const* patches, size_t count, DetourMemoryWriter writer, uint32_t pid);
+};
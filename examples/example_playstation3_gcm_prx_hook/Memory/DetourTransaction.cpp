@@ -0,0 +1,101 @@
+#include "DetourTransaction.hpp"
+
+DetourTransaction::DetourTransaction()
+    : m_Failed(false)
+{
+}
+
+DetourTransaction::~DetourTransaction()
+{
+    Abort();
+}
+
+bool DetourTransaction::Add(Detour* detour, uintptr_t fnAddress, uintptr_t fnCallback, uintptr_t tocOverride)
+{
+    if (m_Failed)
+        return false;
+
+    if (detour == nullptr || fnAddress == 0 || fnCallback == 0)
+    {
+        m_Failed = true;
+        return false;
+    }
+
+    // Preparing a detour twice would release the slot of its queued hook.
+    for (size_t i = 0; i < m_Entries.size(); i++)
+    {
+        if (m_Entries[i].Target == detour)
+        {
+            m_Failed = true;
+            return false;
+        }
+    }
+
+    m_Entries.push_back(Entry());
+    Entry& Added = m_Entries.back();
+    Added.Target = detour;
+
+    if (!detour->Prepare(fnAddress, fnCallback, tocOverride, &Added.Staging))
+    {
+        m_Entries.pop_back();
+        m_Failed = true;
+        return false;
+    }
+
+    // Both hooks would save the original bytes, whichever is written last would relocate the other's branch.
+    uintptr_t AddedStart = reinterpret_cast<uintptr_t>(detour->m_HookAddress);
+    uintptr_t AddedEnd = AddedStart + detour->m_OriginalLength;
+
+    for (size_t i = 0; i + 1 < m_Entries.size(); i++)
+    {
+        const Detour* Other = m_Entries[i].Target;
+        uintptr_t OtherStart = reinterpret_cast<uintptr_t>(Other->m_HookAddress);
+        uintptr_t OtherEnd = OtherStart + Other->m_OriginalLength;
+
+        if (AddedStart < OtherEnd && OtherStart < AddedEnd)
+        {
+            detour->CancelPatch();
+            m_Entries.pop_back();
+            m_Failed = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DetourTransaction::Commit()
+{
+    if (m_Failed)
+    {
+        Abort();
+        return false;
+    }
+
+    // Trampolines first then the hooks back to back, a failure restores whatever got written.
+    std::vector<const DetourPatch*> Patches(m_Entries.size());
+    for (size_t i = 0; i < m_Entries.size(); i++)
+        Patches[i] = &m_Entries[i].Staging.Code;
+
+    if (!DetourPatch::CommitAll(Patches.data(), Patches.size(), Detour::s_MemoryWriter, sys_process_getpid()))
+    {
+        // Only the slots are left to release.
+        Abort();
+        return false;
+    }
+
+    for (size_t i = 0; i < m_Entries.size(); i++)
+        m_Entries[i].Target->CompleteHook(m_Entries[i].Staging);
+
+    m_Entries.clear();
+    return true;
+}
+
+void DetourTransaction::Abort()
+{
+    for (size_t i = 0; i < m_Entries.size(); i++)
+        m_Entries[i].Target->CancelPatch();
+
+    m_Entries.clear();
+    m_Failed = false;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Detour.hpp"
+#undef vector
+#include <vector>
+
+/***
+* Installs a set of detours together.
+* Add() assembles each hook and takes its trampoline slot without writing anything, Commit() then writes every trampoline
+* followed by every hook back to back, so game threads don't run with only part of the set installed for longer than it takes to write the branches.
+* If any hook can't be installed none of them are: Commit() restores what it already wrote.
+* Detours added to a transaction must outlive it.
+*/
+class DetourTransaction
+{
+public:
+    DetourTransaction();
+    DetourTransaction(DetourTransaction const&) = delete;
+    DetourTransaction& operator=(DetourTransaction const&) = delete;
+    ~DetourTransaction(); // Aborts a transaction that wasn't committed
+
+    /***
+    * Queues a hook, see Detour::Hook. A detour that is already hooked gets unhooked right away.
+    * @returns false if the hook can't be installed (no function, no trampoline slot left, overlaps another hook of the transaction), the transaction then fails
+    */
+    bool Add(Detour* detour, uintptr_t fnAddress, uintptr_t fnCallback, uintptr_t tocOverride = 0);
+
+    /***
+    * Writes every queued hook. The transaction is empty afterwards and can be reused.
+    * @returns false if the transaction failed, nothing is hooked then
+    */
+    bool Commit();
+
+    // Drops every queued hook without writing anything.
+    void Abort();
+
+    size_t GetCount() const { return m_Entries.size(); }
+    bool HasFailed() const { return m_Failed; }
+
+private:
+    struct Entry
+    {
+        Detour*          Target;
+        Detour::Patch    Staging;
+    };
+
+    std::vector<Entry> m_Entries;
+    bool               m_Failed;
+};
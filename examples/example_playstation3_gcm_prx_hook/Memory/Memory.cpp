@@ -6,36 +6,85 @@ uint32_t GetCurrentToc()
     return entry_point[1];
 }
 
-int WriteProcessMemory(uint32_t pid, void* address, const void* data, size_t size)
+ProcessMemory::Path ProcessMemory::s_ReadPath = ProcessMemory::Path_Unknown;
+ProcessMemory::Path ProcessMemory::s_WritePath = ProcessMemory::Path_Unknown;
+
+ProcessMemory::ProcessMemory(uint32_t pid)
+    : m_Pid(pid)
 {
-    static bool useHenSyscalls = false;
+}
+
+ProcessMemory& ProcessMemory::GetCurrent()
+{
+    static ProcessMemory current(sys_process_getpid());
+    return current;
+}
+
+void ProcessMemory::SetPaths(Path readPath, Path writePath)
+{
+    s_ReadPath = readPath;
+    s_WritePath = writePath;
+}
+
+int ProcessMemory::ReadRange(uint32_t address, void* destination, size_t size)
+{
+    switch (s_ReadPath)
+    {
+        case Path_Debug:
+            return sys_dbg_read_process_memory(m_Pid, (void*)address, destination, size);
+        case Path_PS3MAPI:
+            return PS3MAPIGetMemory(m_Pid, (void*)address, destination, size);
+        case Path_Direct:
+            memcpy(destination, (const void*)address, size);
+            return SUCCEEDED;
+        default:
+            break;
+    }
 
-    if (!useHenSyscalls)
+    // Only the first access pays for probing
+    int result = sys_dbg_read_process_memory(m_Pid, (void*)address, destination, size);
+    if (result == SUCCEEDED)
     {
-        int canWrite = sys_dbg_write_process_memory(pid, address, data, size);
-        if (canWrite == SUCCEEDED)
-        {
-            return canWrite;
-        }
+        s_ReadPath = Path_Debug;
+        return result;
     }
 
-    useHenSyscalls = true;
-    return PS3MAPISetMemory(pid, address, data, size);
+    s_ReadPath = Path_PS3MAPI;
+    return PS3MAPIGetMemory(m_Pid, (void*)address, destination, size);
 }
 
-int ReadProcessMemory(uint32_t pid, void* address, void* data, size_t size)
+int ProcessMemory::WriteRange(uint32_t address, const void* source, size_t size)
 {
-    static bool useHenSyscalls = false;
+    switch (s_WritePath)
+    {
+        case Path_Debug:
+            return sys_dbg_write_process_memory(m_Pid, (void*)address, source, size);
+        case Path_PS3MAPI:
+            return PS3MAPISetMemory(m_Pid, (void*)address, source, size);
+        case Path_Direct:
+            memcpy((void*)address, source, size);
+            return SUCCEEDED;
+        default:
+            break;
+    }
 
-    if (!useHenSyscalls)
+    int result = sys_dbg_write_process_memory(m_Pid, (void*)address, source, size);
+    if (result == SUCCEEDED)
     {
-        int canRead = sys_dbg_read_process_memory(pid, address, data, size);
-        if (canRead == SUCCEEDED)
-        {
-            return canRead;
-        }
+        s_WritePath = Path_Debug;
+        return result;
     }
 
-    useHenSyscalls = true;
-    return PS3MAPIGetMemory(pid, address, data, size);
-}
\ No newline at end of file
+    s_WritePath = Path_PS3MAPI;
+    return PS3MAPISetMemory(m_Pid, (void*)address, source, size);
+}
+
+int WriteProcessMemory(uint32_t pid, void* address, const void* data, size_t size)
+{
+    return ProcessMemory(pid).WriteRange(reinterpret_cast<uint32_t>(address), data, size);
+}
+
+int ReadProcessMemory(uint32_t pid, void* address, void* data, size_t size)
+{
+    return ProcessMemory(pid).ReadRange(reinterpret_cast<uint32_t>(address), data, size);
+}
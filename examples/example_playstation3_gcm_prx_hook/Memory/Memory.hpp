@@ -1,44 +1,63 @@
 #pragma once
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <ppu_asm_intrinsics.h> // __ALWAYS_INLINE
 #include <sys/process.h>
 #include "Utils/SystemCalls.hpp"
+#include "StubIndex.hpp"
+#include "MemoryReader.hpp"
 
-struct opd_s
+/***
+* Reads and writes the memory of a process through the first syscall path that works: sys_dbg, then PS3MAPI (HEN).
+* The path is probed on first use and then kept for every access, reads and writes are probed separately.
+*/
+class ProcessMemory : public MemoryReader
 {
-    uint32_t func;
-    uint32_t toc;
-};
+public:
+    enum Path
+    {
+        Path_Unknown,   // Not probed yet
+        Path_Debug,     // sys_dbg_read/write_process_memory
+        Path_PS3MAPI,   // PS3MAPIGetMemory/SetMemory
+        Path_Direct     // memcpy, only for memory of the current process that is known to be mapped with the right access
+    };
 
-struct importStub_s
-{
-    int16_t ssize;
-    int16_t header1;
-    int16_t header2;
-    int16_t imports;
-    int32_t zero1;
-    int32_t zero2;
-    const char* name;
-    uint32_t* fnid;
-    opd_s** stub;
-    int32_t zero3;
-    int32_t zero4;
-    int32_t zero5;
-    int32_t zero6;
-};
+public:
+    explicit ProcessMemory(uint32_t pid);
 
-struct exportStub_s
-{
-    int16_t ssize;
-    int16_t header1;
-    int16_t header2;
-    int16_t exports; // number of exports
-    int32_t zero1;
-    int32_t zero2;
-    const char* name;
-    uint32_t* fnid;
-    opd_s** stub;
+    // Accessor of the process the prx is loaded in.
+    static ProcessMemory& GetCurrent();
+
+    virtual int ReadRange(uint32_t address, void* destination, size_t size);
+    int WriteRange(uint32_t address, const void* source, size_t size);
+
+    template<typename T>
+    T Read(uint32_t address)
+    {
+        T data;
+        ReadRange(address, &data, sizeof(T));
+        return data;
+    }
+
+    template<typename T>
+    int Write(uint32_t address, T data)
+    {
+        return WriteRange(address, &data, sizeof(T));
+    }
+
+    uint32_t GetPid() const { return m_Pid; }
+
+    // Paths are shared by every accessor, they depend on the system rather than the process.
+    static Path GetReadPath() { return s_ReadPath; }
+    static Path GetWritePath() { return s_WritePath; }
+    static void SetPaths(Path readPath, Path writePath);
+
+private:
+    uint32_t m_Pid;
+
+    static Path s_ReadPath;
+    static Path s_WritePath;
 };
 
 uint32_t GetCurrentToc();
@@ -48,15 +67,13 @@ int ReadProcessMemory(uint32_t pid, void* address, void* data, size_t size);
 template<typename T>
 inline T GetMem(uint32_t address)
 {
-    T data;
-    ReadProcessMemory(sys_process_getpid(), (void*)address, &data, sizeof(T));
-    return data;
+    return ProcessMemory::GetCurrent().Read<T>(address);
 }
 
 template<typename T>
 inline void SetMem(uint32_t address, T data)
 {
-    WriteProcessMemory(sys_process_getpid(), (void*)address, &data, sizeof(T));
+    ProcessMemory::GetCurrent().Write<T>(address, data);
 }
 
 template <typename R, typename... TArgs>
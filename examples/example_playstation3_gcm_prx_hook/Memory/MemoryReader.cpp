@@ -0,0 +1,49 @@
+#include "MemoryReader.hpp"
+#include <string.h>
+
+int MemoryReader::ReadScatter(const ReadRequest* requests, size_t count)
+{
+    uint8_t staging[ScatterWindowSize];
+    int firstError = SUCCEEDED;
+
+    size_t first = 0;
+    while (first < count)
+    {
+        // Grow the run while it still fits in the staging buffer
+        uint32_t start = requests[first].Address;
+        uint32_t end = start + requests[first].Size;
+        size_t last = first + 1;
+
+        while (last < count)
+        {
+            uint32_t runStart = requests[last].Address < start ? requests[last].Address : start;
+            uint32_t runEnd = requests[last].Address + requests[last].Size > end ? requests[last].Address + requests[last].Size : end;
+            if (runEnd - runStart > ScatterWindowSize)
+                break;
+
+            start = runStart;
+            end = runEnd;
+            last++;
+        }
+
+        if (last - first > 1 && ReadRange(start, staging, end - start) == SUCCEEDED)
+        {
+            for (size_t i = first; i < last; i++)
+                memcpy(requests[i].Destination, &staging[requests[i].Address - start], requests[i].Size);
+        }
+        else
+        {
+            // Single request, or the merged read failed: read each on its own so one bad address doesn't fail its neighbours
+            for (size_t i = first; i < last; i++)
+            {
+                int result = ReadRange(requests[i].Address, requests[i].Destination, requests[i].Size);
+                if (result != SUCCEEDED && firstError == SUCCEEDED)
+                    firstError = result;
+            }
+        }
+
+        first = last;
+    }
+
+    return firstError;
+}
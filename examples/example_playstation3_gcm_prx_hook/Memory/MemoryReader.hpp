@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef SUCCEEDED
+#define SUCCEEDED 0 // As in sys/return_code.h, which this header doesn't need
+#endif
+
+/***
+* Source of process memory reads: ProcessMemory on the console, a plain buffer in host-side tests.
+* Doesn't depend on anything from the PS3 SDK.
+*/
+class MemoryReader
+{
+public:
+    struct ReadRequest
+    {
+        uint32_t     Address;
+        void*        Destination;
+        uint32_t     Size;
+    };
+
+    // Requests closer than this get fetched with a single read. Smaller than a page: the gap between two mapped addresses is mapped too.
+    static const uint32_t ScatterWindowSize = 256;
+
+public:
+    virtual ~MemoryReader() {}
+
+    /***
+    * Reads a block of memory.
+    * @returns SUCCEEDED, or an error code
+    */
+    virtual int ReadRange(uint32_t address, void* destination, size_t size) = 0;
+
+    /***
+    * Reads many values, neighbouring requests are merged into a single read. Requests sorted by address merge best.
+    * @returns SUCCEEDED, or the error of the first request that couldn't be read. Every other request is still read.
+    */
+    int ReadScatter(const ReadRequest* requests, size_t count);
+};
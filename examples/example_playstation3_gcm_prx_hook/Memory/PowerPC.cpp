@@ -0,0 +1,166 @@
+#include "PowerPC.hpp"
+#include <string.h>
+
+namespace PowerPC
+{
+    // Decoding table, first match wins.
+    // Branch displacements are stored in place (low bits are AA/LK), DisplacementBits counts from bit 2.
+    struct DecodeEntry
+    {
+        uint32_t        Mask;
+        uint32_t        Match;
+        InstructionType Type;
+        uint8_t         DisplacementBits;
+    };
+
+    static const DecodeEntry s_DecodeTable[] =
+    {
+        // [Opcode]            [Address]           [Absolute] [Linked]
+        //   0-5                 6-29                  30        31
+        { POWERPC_OPCODE_MASK, POWERPC_OPCODE_B, InstructionType_Branch, 24 },
+
+        // [Opcode]   [Branch Options]     [Condition Register]         [Address]      [Absolute] [Linked]
+        //   0-5           6-10                    11-15                  16-29            30        31
+        { POWERPC_OPCODE_MASK, POWERPC_OPCODE_BC, InstructionType_BranchConditional, 14 },
+
+        // [Opcode]   [Branch Options]     [Condition Register]   [Hint]   [Extended Opcode]   [Linked]
+        //   0-5           6-10                    11-15            16-20         21-30             31
+        { POWERPC_OPCODE_MASK | POWERPC_EXOPCODE(0x3FF), POWERPC_OPCODE_BCCTR | POWERPC_EXOPCODE_BCLR, InstructionType_BranchConditionalToRegister, 0 },
+        { POWERPC_OPCODE_MASK | POWERPC_EXOPCODE(0x3FF), POWERPC_OPCODE_BCCTR | POWERPC_EXOPCODE_BCCTR, InstructionType_BranchConditionalToRegister, 0 },
+    };
+
+    Instruction Decode(uint32_t instruction)
+    {
+        Instruction Decoded;
+        memset(&Decoded, 0, sizeof(Decoded));
+        Decoded.Raw = instruction;
+        Decoded.Type = InstructionType_Other;
+
+        for (size_t i = 0; i < sizeof(s_DecodeTable) / sizeof(s_DecodeTable[0]); i++)
+        {
+            const DecodeEntry& Entry = s_DecodeTable[i];
+            if ((instruction & Entry.Mask) != Entry.Match)
+                continue;
+
+            Decoded.Type = Entry.Type;
+            Decoded.Linked = (instruction & POWERPC_BRANCH_LINKED) != 0;
+
+            if (Entry.Type == InstructionType_Branch)
+                Decoded.BranchOptions = POWERPC_BRANCH_OPTIONS_ALWAYS;
+            else
+            {
+                Decoded.BranchOptions = (instruction >> POWERPC_BIT32(10)) & MASK_N_BITS(5);
+                Decoded.ConditionRegisterBit = (instruction >> POWERPC_BIT32(15)) & MASK_N_BITS(5);
+            }
+
+            if (Entry.DisplacementBits)
+            {
+                // Sign extend the displacement from its top bit.
+                const uint32_t TotalBits = Entry.DisplacementBits + 2;
+                int32_t Displacement = instruction & (MASK_N_BITS(Entry.DisplacementBits) << 2);
+                if (Displacement >> (TotalBits - 1))
+                    Displacement |= ~MASK_N_BITS(TotalBits);
+
+                Decoded.Displacement = Displacement;
+                Decoded.Absolute = (instruction & POWERPC_BRANCH_ABSOLUTE) != 0;
+            }
+            break;
+        }
+
+        return Decoded;
+    }
+
+    static size_t Emit(uint32_t* destination, size_t offset, const uint32_t* instructions, size_t size)
+    {
+        if (destination)
+            memcpy(reinterpret_cast<uint8_t*>(destination) + offset, instructions, size);
+        return offset + size;
+    }
+
+    size_t AssembleFarBranch(uint32_t* destination, uint32_t branchTarget, bool linked, bool preserveRegister,
+        uint8_t branchOptions, uint8_t conditionRegisterBit, uint8_t registerIndex)
+    {
+        uint32_t BranchFarAsm[] = {
+            POWERPC_LIS(registerIndex, POWERPC_HI(branchTarget)),                               // lis   %rX, branchTarget@hi
+            POWERPC_ORI(registerIndex, registerIndex, POWERPC_LO(branchTarget)),                // ori   %rX, %rX, branchTarget@lo
+            POWERPC_MTCTR(registerIndex),                                                       // mtctr %rX
+            POWERPC_BCCTR(branchOptions, conditionRegisterBit, linked)                          // bcctr (bcctr 20, 0 == bctr)
+        };
+
+        uint32_t BranchFarAsmPreserve[] = {
+            POWERPC_STD(registerIndex, -0x30, POWERPC_REGISTERINDEX_R1),                        // std   %rX, -0x30(%r1)
+            POWERPC_LIS(registerIndex, POWERPC_HI(branchTarget)),                               // lis   %rX, branchTarget@hi
+            POWERPC_ORI(registerIndex, registerIndex, POWERPC_LO(branchTarget)),                // ori   %rX, %rX, branchTarget@lo
+            POWERPC_MTCTR(registerIndex),                                                       // mtctr %rX
+            POWERPC_LD(registerIndex, -0x30, POWERPC_REGISTERINDEX_R1),                         // ld    %rX, -0x30(%r1)
+            POWERPC_BCCTR(branchOptions, conditionRegisterBit, linked)                          // bcctr (bcctr 20, 0 == bctr)
+        };
+
+        if (preserveRegister)
+            return Emit(destination, 0, BranchFarAsmPreserve, sizeof(BranchFarAsmPreserve));
+        return Emit(destination, 0, BranchFarAsm, sizeof(BranchFarAsm));
+    }
+
+    bool IsInBranchRange(uint32_t instructionAddress, uint32_t branchTarget)
+    {
+        const int32_t Displacement = static_cast<int32_t>(branchTarget - instructionAddress);
+        return (Displacement & 3) == 0 && Displacement >= MinBranchDisplacement && Displacement <= MaxBranchDisplacement;
+    }
+
+    size_t AssembleBranch(uint32_t* destination, uint32_t instructionAddress, uint32_t branchTarget, bool linked, bool preserveRegister)
+    {
+        if (!IsInBranchRange(instructionAddress, branchTarget))
+            return AssembleFarBranch(destination, branchTarget, linked, preserveRegister);
+
+        // Doesn't touch any register, so there is nothing to preserve.
+        const uint32_t BranchAsm = POWERPC_B(branchTarget - instructionAddress, false, linked);
+        return Emit(destination, 0, &BranchAsm, sizeof(BranchAsm));
+    }
+
+    size_t Relocate(uint32_t* destination, uint32_t instruction, uint32_t instructionAddress, uint32_t relocatedAddress)
+    {
+        const Instruction Decoded = Decode(instruction);
+
+        // Absolute branches and anything not relative to the program counter stay valid anywhere.
+        if ((Decoded.Type != InstructionType_Branch && Decoded.Type != InstructionType_BranchConditional) || Decoded.Absolute)
+            return Emit(destination, 0, &instruction, sizeof(instruction));
+
+        const uint32_t BranchTarget = instructionAddress + Decoded.Displacement;
+        const bool Unconditional = (Decoded.BranchOptions & POWERPC_BRANCH_OPTIONS_ALWAYS) == POWERPC_BRANCH_OPTIONS_ALWAYS;
+
+        // bl $+4 / bcl 20, 31, $+4: only there to read the program counter with mflr.
+        // Load the original return address instead of branching, so what follows computes the same addresses.
+        if (Unconditional && Decoded.Linked && BranchTarget == instructionAddress + sizeof(uint32_t))
+        {
+            uint32_t LoadLinkRegisterAsm[] = {
+                POWERPC_STD(POWERPC_REGISTERINDEX_R0, -0x30, POWERPC_REGISTERINDEX_R1),                         // std   %r0, -0x30(%r1)
+                POWERPC_LIS(POWERPC_REGISTERINDEX_R0, POWERPC_HI(BranchTarget)),                                // lis   %r0, BranchTarget@hi
+                POWERPC_ORI(POWERPC_REGISTERINDEX_R0, POWERPC_REGISTERINDEX_R0, POWERPC_LO(BranchTarget)),      // ori   %r0, %r0, BranchTarget@lo
+                POWERPC_MTLR(POWERPC_REGISTERINDEX_R0),                                                         // mtlr  %r0
+                POWERPC_LD(POWERPC_REGISTERINDEX_R0, -0x30, POWERPC_REGISTERINDEX_R1),                          // ld    %r0, -0x30(%r1)
+            };
+            return Emit(destination, 0, LoadLinkRegisterAsm, sizeof(LoadLinkRegisterAsm));
+        }
+
+        if (Unconditional)
+            return AssembleBranch(destination, relocatedAddress, BranchTarget, Decoded.Linked, true);
+
+        // Conditional: bcctr can't decrement the count register (bdnz...), so keep the original condition on a short hop over a jump to the fallthrough:
+        //   bc    BO, BI, +8
+        //   b     +(4 + branch size)
+        //   <branch to the target>
+        const uint32_t BranchAddress = relocatedAddress + 2 * sizeof(uint32_t);
+
+        // A far branch to the target would load it into the count register, losing the counter of a bdnz loop on the first taken iteration.
+        if ((Decoded.BranchOptions & POWERPC_BRANCH_OPTIONS_NO_DECREMENT) == 0 && !IsInBranchRange(BranchAddress, BranchTarget))
+            return 0;
+
+        const size_t BranchSize = AssembleBranch(nullptr, BranchAddress, BranchTarget, Decoded.Linked, true);
+        uint32_t ConditionAsm[] = {
+            POWERPC_BC(Decoded.BranchOptions, Decoded.ConditionRegisterBit, 8, false, false),
+            POWERPC_B(4 + BranchSize, false, false),
+        };
+        size_t Size = Emit(destination, 0, ConditionAsm, sizeof(ConditionAsm));
+        return Size + AssembleBranch(destination ? destination + Size / sizeof(uint32_t) : nullptr, BranchAddress, BranchTarget, Decoded.Linked, true);
+    }
+}
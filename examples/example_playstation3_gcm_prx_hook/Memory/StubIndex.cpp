@@ -0,0 +1,127 @@
+#include "StubIndex.hpp"
+#include <string.h>
+
+StubIndex::StubIndex()
+    : m_Entries(nullptr), m_Mask(0), m_Count(0), m_Built(false)
+{
+}
+
+StubIndex::~StubIndex()
+{
+    Clear();
+}
+
+uint32_t StubIndex::HashLibrary(const char* library)
+{
+    // FNV-1a
+    uint32_t hash = 0x811C9DC5;
+    while (*library)
+    {
+        hash ^= static_cast<uint8_t>(*library++);
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+uint32_t StubIndex::HashKey(uint32_t libraryHash, uint32_t fnid)
+{
+    // fnids are already hashes of the function names, a multiply spreads the pair over the low bits used as index.
+    return (libraryHash ^ fnid) * 0x9E3779B1;
+}
+
+void StubIndex::Clear()
+{
+    delete[] m_Entries;
+    m_Entries = nullptr;
+    m_Mask = 0;
+    m_Count = 0;
+    m_Built = false;
+}
+
+void StubIndex::Reserve(size_t count)
+{
+    Clear();
+
+    // Keep the load factor under 1/2 so probe chains stay short.
+    uint32_t size = 16;
+    while (size < count * 2)
+        size <<= 1;
+
+    m_Entries = new Entry[size];
+    memset(m_Entries, 0, size * sizeof(Entry));
+    m_Mask = size - 1;
+}
+
+void StubIndex::Insert(const char* library, uint32_t fnid, opd_s* stub)
+{
+    const uint32_t libraryHash = HashLibrary(library);
+
+    for (uint32_t i = HashKey(libraryHash, fnid) & m_Mask; ; i = (i + 1) & m_Mask)
+    {
+        Entry& entry = m_Entries[i];
+        if (entry.Library == nullptr)
+        {
+            entry.Library = library;
+            entry.LibraryHash = libraryHash;
+            entry.Fnid = fnid;
+            entry.Stub = stub;
+            m_Count++;
+            return;
+        }
+
+        if (entry.LibraryHash == libraryHash && entry.Fnid == fnid && !strcmp(entry.Library, library))
+            return;
+    }
+}
+
+void StubIndex::BuildImports(const importStub_s* table)
+{
+    size_t count = 0;
+    for (const importStub_s* importStub = table; importStub && importStub->ssize == IMPORT_STUB_SIZE; importStub++)
+        count += importStub->imports;
+
+    Reserve(count);
+
+    for (const importStub_s* importStub = table; importStub && importStub->ssize == IMPORT_STUB_SIZE; importStub++)
+    {
+        for (int16_t i = 0; i < importStub->imports; i++)
+            Insert(importStub->name, importStub->fnid[i], importStub->stub[i]);
+    }
+
+    m_Built = true;
+}
+
+void StubIndex::BuildExports(const exportStub_s* table)
+{
+    size_t count = 0;
+    for (const exportStub_s* exportStub = table; exportStub && exportStub->ssize == EXPORT_STUB_SIZE; exportStub++)
+        count += exportStub->exports;
+
+    Reserve(count);
+
+    for (const exportStub_s* exportStub = table; exportStub && exportStub->ssize == EXPORT_STUB_SIZE; exportStub++)
+    {
+        for (int16_t i = 0; i < exportStub->exports; i++)
+            Insert(exportStub->name, exportStub->fnid[i], exportStub->stub[i]);
+    }
+
+    m_Built = true;
+}
+
+opd_s* StubIndex::Find(const char* library, uint32_t fnid) const
+{
+    if (m_Entries == nullptr)
+        return nullptr;
+
+    const uint32_t libraryHash = HashLibrary(library);
+
+    for (uint32_t i = HashKey(libraryHash, fnid) & m_Mask; ; i = (i + 1) & m_Mask)
+    {
+        const Entry& entry = m_Entries[i];
+        if (entry.Library == nullptr)
+            return nullptr;
+
+        if (entry.LibraryHash == libraryHash && entry.Fnid == fnid && !strcmp(entry.Library, library))
+            return entry.Stub;
+    }
+}
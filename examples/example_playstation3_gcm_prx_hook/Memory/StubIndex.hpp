@@ -0,0 +1,97 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+struct opd_s
+{
+    uint32_t func;
+    uint32_t toc;
+};
+
+struct importStub_s
+{
+    int16_t ssize;
+    int16_t header1;
+    int16_t header2;
+    int16_t imports;
+    int32_t zero1;
+    int32_t zero2;
+    const char* name;
+    uint32_t* fnid;
+    opd_s** stub;
+    int32_t zero3;
+    int32_t zero4;
+    int32_t zero5;
+    int32_t zero6;
+};
+
+struct exportStub_s
+{
+    int16_t ssize;
+    int16_t header1;
+    int16_t header2;
+    int16_t exports; // number of exports
+    int32_t zero1;
+    int32_t zero2;
+    const char* name;
+    uint32_t* fnid;
+    opd_s** stub;
+};
+
+#define IMPORT_STUB_SIZE 0x2C00
+#define EXPORT_STUB_SIZE 0x1C00
+
+/***
+* Hash table of the stubs of an import or export table keyed by (library, fnid).
+* Built in a single pass over the fnids of the table, so looking up many functions doesn't rescan every stub and compare every library name.
+* Only reads the table it's given: doesn't depend on anything from the PS3 SDK.
+*/
+class StubIndex
+{
+public:
+    StubIndex();
+    ~StubIndex();
+
+    /***
+    * Indexes every stub of a table, replacing what was indexed before.
+    * When a (library, fnid) pair shows up more than once the first stub wins, like a linear scan of the table would.
+    * @param table First stub of the table, the table ends at the first stub with a different size. nullptr indexes nothing.
+    */
+    void BuildImports(const importStub_s* table);
+    void BuildExports(const exportStub_s* table);
+
+    /***
+    * Looks up a function.
+    * @param library Name of the library, ex: "cellGcmSys".
+    * @param fnid Function NID.
+    * @returns the opd of the function, nullptr if it isn't in the table
+    */
+    opd_s* Find(const char* library, uint32_t fnid) const;
+
+    // Frees the table, IsBuilt() returns false until the next build.
+    void Clear();
+
+    bool IsBuilt() const { return m_Built; }
+    size_t GetCount() const { return m_Count; }
+
+private:
+    struct Entry
+    {
+        const char*  Library;          // nullptr when the entry is empty
+        uint32_t     LibraryHash;
+        uint32_t     Fnid;
+        opd_s*       Stub;
+    };
+
+    static uint32_t HashLibrary(const char* library);
+    static uint32_t HashKey(uint32_t libraryHash, uint32_t fnid);
+
+    void Reserve(size_t count);
+    void Insert(const char* library, uint32_t fnid, opd_s* stub);
+
+private:
+    Entry*       m_Entries;
+    uint32_t     m_Mask;                   // Table size - 1, the size is a power of two
+    size_t       m_Count;
+    bool         m_Built;
+};
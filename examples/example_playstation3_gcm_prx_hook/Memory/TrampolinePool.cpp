@@ -0,0 +1,50 @@
+#include "TrampolinePool.hpp"
+
+TrampolinePool::TrampolinePool(uint8_t* buffer, size_t bufferSize)
+    : m_Buffer(buffer), m_SlotCount(bufferSize / SlotSize), m_UsedCount(0), m_FreeHead(InvalidSlot)
+{
+    if (m_SlotCount > MaxSlots)
+        m_SlotCount = MaxSlots;
+
+    // Chain every slot, lowest address first
+    for (size_t i = m_SlotCount; i > 0; i--)
+    {
+        m_Next[i - 1] = m_FreeHead;
+        m_InUse[i - 1] = false;
+        m_FreeHead = static_cast<uint16_t>(i - 1);
+    }
+}
+
+uint8_t* TrampolinePool::Allocate()
+{
+    if (m_FreeHead == InvalidSlot)
+        return nullptr;
+
+    uint16_t slot = m_FreeHead;
+    m_FreeHead = m_Next[slot];
+    m_InUse[slot] = true;
+    m_UsedCount++;
+
+    return m_Buffer + slot * SlotSize;
+}
+
+bool TrampolinePool::Free(uint8_t* slot)
+{
+    if (slot < m_Buffer || slot >= m_Buffer + m_SlotCount * SlotSize)
+        return false;
+
+    size_t offset = static_cast<size_t>(slot - m_Buffer);
+    if (offset % SlotSize != 0)
+        return false;
+
+    uint16_t index = static_cast<uint16_t>(offset / SlotSize);
+    if (!m_InUse[index])
+        return false;
+
+    m_InUse[index] = false;
+    m_Next[index] = m_FreeHead;
+    m_FreeHead = index;
+    m_UsedCount--;
+
+    return true;
+}
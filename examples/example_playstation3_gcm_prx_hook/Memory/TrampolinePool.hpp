@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/***
+* Hands out fixed size trampoline slots from a caller provided buffer.
+* Freed slots go on a free list and get reused, so hooks can be installed and removed any number of times.
+* The bookkeeping lives outside of the buffer: slots are executable memory that can only be written through WriteProcessMemory.
+*/
+class TrampolinePool
+{
+public:
+    static const size_t SlotSize = 160;     // Largest trampoline: 4 relocated instructions (PowerPC::MaxRelocatedSize each) + the jump back (24 bytes)
+    static const size_t MaxSlots = 256;
+
+public:
+    TrampolinePool(uint8_t* buffer, size_t bufferSize);
+
+    /***
+    * Takes a slot of SlotSize bytes.
+    * @returns the slot, nullptr if every slot is in use
+    */
+    uint8_t* Allocate();
+
+    /***
+    * Returns a slot to the pool.
+    * @param slot Pointer returned by Allocate().
+    * @returns false if slot doesn't belong to the pool or is already free
+    */
+    bool Free(uint8_t* slot);
+
+    size_t GetCapacity() const { return m_SlotCount; }
+    size_t GetUsedCount() const { return m_UsedCount; }
+
+private:
+    static const uint16_t InvalidSlot = 0xFFFF;
+
+    uint8_t*     m_Buffer;
+    size_t       m_SlotCount;
+    size_t       m_UsedCount;
+    uint16_t     m_FreeHead;               // First free slot, InvalidSlot when the pool is full
+    uint16_t     m_Next[MaxSlots];         // Next free slot of each free slot
+    bool         m_InUse[MaxSlots];
+};
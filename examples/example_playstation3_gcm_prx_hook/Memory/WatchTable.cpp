@@ -0,0 +1,184 @@
+#include "WatchTable.hpp"
+
+static const uint32_t s_TypeSizes[] = { 1, 1, 2, 2, 4, 4, 8, 8, 4, 8, 0 };
+
+WatchTable::WatchTable(MemoryReader& memory)
+    : m_Memory(memory), m_Count(0), m_RangeCount(0), m_Dirty(false), m_Snapshot(nullptr), m_Previous(nullptr), m_SnapshotSize(0)
+{
+    memset(m_Watches, 0, sizeof(m_Watches));
+    memset(m_ChangedBits, 0, sizeof(m_ChangedBits));
+    memset(m_ValidBits, 0, sizeof(m_ValidBits));
+}
+
+WatchTable::~WatchTable()
+{
+    delete[] m_Snapshot;
+    delete[] m_Previous;
+}
+
+int WatchTable::Add(uint32_t address, Type type, uint16_t refreshInterval, uint32_t size)
+{
+    uint32_t watchSize = type == Type_Bytes ? size : s_TypeSizes[type];
+    if (watchSize == 0 || watchSize > MaxRangeSize)
+        return InvalidHandle;
+
+    for (size_t i = 0; i < MaxWatches; i++)
+    {
+        if (m_Watches[i].Used)
+            continue;
+
+        Watch& watch = m_Watches[i];
+        watch.Address = address;
+        watch.Size = watchSize;
+        watch.Offset = 0;
+        watch.Interval = refreshInterval != 0 ? refreshInterval : 1;
+        watch.WatchType = static_cast<uint8_t>(type);
+        watch.Used = true;
+
+        m_Count++;
+        m_Dirty = true;
+        return static_cast<int>(i);
+    }
+
+    return InvalidHandle;
+}
+
+void WatchTable::Remove(int handle)
+{
+    if (handle < 0 || handle >= static_cast<int>(MaxWatches) || !m_Watches[handle].Used)
+        return;
+
+    m_Watches[handle].Used = false;
+    m_ChangedBits[handle >> 5] &= ~(1u << (handle & 31));
+    m_ValidBits[handle >> 5] &= ~(1u << (handle & 31));
+
+    m_Count--;
+    m_Dirty = true;
+}
+
+void WatchTable::Clear()
+{
+    for (size_t i = 0; i < MaxWatches; i++)
+        m_Watches[i].Used = false;
+
+    memset(m_ChangedBits, 0, sizeof(m_ChangedBits));
+    memset(m_ValidBits, 0, sizeof(m_ValidBits));
+
+    m_Count = 0;
+    m_Dirty = true;
+}
+
+void WatchTable::Rebuild()
+{
+    // Insertion sort, watches get added in roughly increasing address order
+    size_t count = 0;
+    for (size_t i = 0; i < MaxWatches; i++)
+    {
+        if (!m_Watches[i].Used)
+            continue;
+
+        size_t j = count++;
+        while (j > 0 && m_Watches[m_Order[j - 1]].Address > m_Watches[i].Address)
+        {
+            m_Order[j] = m_Order[j - 1];
+            j--;
+        }
+        m_Order[j] = static_cast<uint16_t>(i);
+    }
+
+    // Coalesce neighbours, overlapping watches share their bytes
+    m_RangeCount = 0;
+    uint32_t snapshotSize = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Watch& watch = m_Watches[m_Order[i]];
+        Range* range = m_RangeCount > 0 ? &m_Ranges[m_RangeCount - 1] : nullptr;
+
+        uint32_t end = watch.Address + watch.Size;
+        if (range == nullptr || watch.Address > range->Address + range->Size + MaxGap || end - range->Address > MaxRangeSize)
+        {
+            range = &m_Ranges[m_RangeCount++];
+            range->Address = watch.Address;
+            range->Size = 0;
+            range->Offset = snapshotSize;
+            range->Interval = watch.Interval;
+            range->FirstWatch = static_cast<uint16_t>(i);
+            range->WatchCount = 0;
+        }
+
+        if (end - range->Address > range->Size)
+        {
+            snapshotSize += end - range->Address - range->Size;
+            range->Size = end - range->Address;
+        }
+
+        if (watch.Interval < range->Interval)
+            range->Interval = watch.Interval;
+        range->WatchCount++;
+    }
+
+    // Everything gets read again on the next update, ranges changed shape
+    for (size_t i = 0; i < m_RangeCount; i++)
+    {
+        Range& range = m_Ranges[i];
+        range.Countdown = 0;
+
+        for (size_t j = range.FirstWatch; j < range.FirstWatch + range.WatchCount; j++)
+        {
+            Watch& watch = m_Watches[m_Order[j]];
+            watch.Offset = range.Offset + (watch.Address - range.Address);
+        }
+    }
+
+    memset(m_ValidBits, 0, sizeof(m_ValidBits));
+
+    if (snapshotSize > m_SnapshotSize)
+    {
+        delete[] m_Snapshot;
+        delete[] m_Previous;
+        m_Snapshot = new uint8_t[snapshotSize];
+        m_Previous = new uint8_t[snapshotSize];
+        m_SnapshotSize = snapshotSize;
+    }
+
+    m_Dirty = false;
+}
+
+void WatchTable::Update()
+{
+    if (m_Dirty)
+        Rebuild();
+
+    memset(m_ChangedBits, 0, sizeof(m_ChangedBits));
+
+    for (size_t i = 0; i < m_RangeCount; i++)
+    {
+        Range& range = m_Ranges[i];
+        if (range.Countdown > 0)
+        {
+            range.Countdown--;
+            continue;
+        }
+        range.Countdown = range.Interval - 1;
+
+        // Keep the last values to compare against, a failed read leaves them untouched
+        memcpy(m_Previous + range.Offset, m_Snapshot + range.Offset, range.Size);
+        if (m_Memory.ReadRange(range.Address, m_Snapshot + range.Offset, range.Size) != SUCCEEDED)
+        {
+            memcpy(m_Snapshot + range.Offset, m_Previous + range.Offset, range.Size);
+            continue;
+        }
+
+        for (size_t j = range.FirstWatch; j < range.FirstWatch + range.WatchCount; j++)
+        {
+            uint16_t handle = m_Order[j];
+            const Watch& watch = m_Watches[handle];
+            uint32_t bit = 1u << (handle & 31);
+
+            if (!(m_ValidBits[handle >> 5] & bit) || memcmp(m_Snapshot + watch.Offset, m_Previous + watch.Offset, watch.Size) != 0)
+                m_ChangedBits[handle >> 5] |= bit;
+            m_ValidBits[handle >> 5] |= bit;
+        }
+    }
+}
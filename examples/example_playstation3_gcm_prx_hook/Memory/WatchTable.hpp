@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "MemoryReader.hpp"
+
+/***
+* Watches typed values in process memory for debug overlays, read through a MemoryReader (ProcessMemory on the console).
+* Watched addresses are sorted and coalesced into contiguous ranges, each range is read with a single call into a snapshot once it's due.
+* After each Update() a bitset tells which values changed since the previous one, so only those need to be formatted again.
+* The table is a few KB, don't put it on the stack of a small thread.
+*/
+class WatchTable
+{
+public:
+    enum Type
+    {
+        Type_Int8, Type_UInt8,
+        Type_Int16, Type_UInt16,
+        Type_Int32, Type_UInt32,
+        Type_Int64, Type_UInt64,
+        Type_Float, Type_Double,
+        Type_Bytes,             // Raw block, size given to Add()
+    };
+
+    static const int      InvalidHandle = -1;
+    static const size_t   MaxWatches = 256;
+    static const uint32_t MaxGap = 64;          // Largest gap between two watches read as one range. Smaller than a page, so it's mapped.
+    static const uint32_t MaxRangeSize = 1024;  // Largest single read
+
+public:
+    explicit WatchTable(MemoryReader& memory);
+    WatchTable(WatchTable const&) = delete;
+    WatchTable& operator=(WatchTable const&) = delete;
+    ~WatchTable();
+
+    /***
+    * Watches a value.
+    * @param refreshInterval Read every n Update() calls. Values sharing a range are read as often as the most frequent of them.
+    * @param size Size of Type_Bytes watches, ignored otherwise.
+    * @returns handle of the watch, InvalidHandle if the table is full
+    */
+    int Add(uint32_t address, Type type, uint16_t refreshInterval = 1, uint32_t size = 0);
+    void Remove(int handle);
+    void Clear();
+
+    // Reads the ranges that are due, to be called once per frame.
+    void Update();
+
+    // Value changed during the last Update(). Every watch reports a change on its first read after watches were added or removed.
+    bool HasChanged(int handle) const { return (m_ChangedBits[handle >> 5] & (1u << (handle & 31))) != 0; }
+    // Value was read at least once.
+    bool IsValid(int handle) const { return (m_ValidBits[handle >> 5] & (1u << (handle & 31))) != 0; }
+    // One bit per handle, MaxWatches / 32 words.
+    const uint32_t* GetChangedBits() const { return m_ChangedBits; }
+
+    const void* GetData(int handle) const { return m_Snapshot + m_Watches[handle].Offset; }
+    uint32_t GetSize(int handle) const { return m_Watches[handle].Size; }
+    Type GetType(int handle) const { return static_cast<Type>(m_Watches[handle].WatchType); }
+
+    template<typename T>
+    T Get(int handle) const
+    {
+        T value;
+        memcpy(&value, GetData(handle), sizeof(T));
+        return value;
+    }
+
+    size_t GetCount() const { return m_Count; }
+    size_t GetRangeCount() const { return m_RangeCount; }
+
+private:
+    struct Watch
+    {
+        uint32_t     Address;
+        uint32_t     Size;
+        uint32_t     Offset;            // In the snapshot
+        uint16_t     Interval;
+        uint8_t      WatchType;
+        bool         Used;
+    };
+
+    struct Range
+    {
+        uint32_t     Address;
+        uint32_t     Size;
+        uint32_t     Offset;            // In the snapshot
+        uint16_t     Interval;
+        uint16_t     Countdown;         // Updates left before the next read, 0: due
+        uint16_t     FirstWatch;        // In m_Order
+        uint16_t     WatchCount;
+    };
+
+    // Sorts the watches by address and coalesces them into ranges, allocates the snapshot.
+    void Rebuild();
+
+private:
+    MemoryReader&    m_Memory;
+
+    Watch            m_Watches[MaxWatches];
+    uint16_t         m_Order[MaxWatches];       // Used watches sorted by address
+    Range            m_Ranges[MaxWatches];
+    size_t           m_Count;
+    size_t           m_RangeCount;
+    bool             m_Dirty;
+
+    uint8_t*         m_Snapshot;                // Values as of the last read
+    uint8_t*         m_Previous;                // Values as of the read before
+    uint32_t         m_SnapshotSize;
+
+    uint32_t         m_ChangedBits[MaxWatches / 32];
+    uint32_t         m_ValidBits[MaxWatches / 32];
+};
@@ -0,0 +1,183 @@
+#include "Allocator.hpp"
+#include <string.h>
+#include <new>
+#include "Exports.hpp"
+
+// Payload sizes, multiples of Allocator::Alignment
+static const uint16_t s_SizeClasses[Allocator::SizeClassCount] = { 16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048 };
+
+Allocator::Allocator()
+{
+    sys_lwmutex_attribute_t mutexAttributes;
+    sys_lwmutex_attribute_initialize(mutexAttributes);
+    sys_lwmutex_attribute_name_set(mutexAttributes.name, "alloc");
+    sys_lwmutex_create(&m_Mutex, &mutexAttributes);
+
+    memset(m_FreeLists, 0, sizeof(m_FreeLists));
+    memset(m_ChunkCursor, 0, sizeof(m_ChunkCursor));
+    memset(m_ChunkEnd, 0, sizeof(m_ChunkEnd));
+    memset(&m_Stats, 0, sizeof(m_Stats));
+
+    uint8_t sizeClass = 0;
+    for (size_t i = 0; i < ARRAYSIZE(m_SizeClassLookup); i++)
+    {
+        while (i * Alignment > s_SizeClasses[sizeClass])
+            sizeClass++;
+        m_SizeClassLookup[i] = sizeClass;
+    }
+}
+
+Allocator& Allocator::GetDefault()
+{
+    // Constructed in place rather than as a global: operator new can be called before global constructors run,
+    // and it must stay usable until the very last delete.
+    static uint64_t s_Storage[(sizeof(Allocator) + sizeof(uint64_t) - 1) / sizeof(uint64_t)];
+    static Allocator* s_Default = nullptr;
+
+    if (s_Default == nullptr)
+        s_Default = new (s_Storage) Allocator();
+    return *s_Default;
+}
+
+void Allocator::OnAllocate(size_t size)
+{
+    m_Stats.LiveBytes += size;
+    if (m_Stats.LiveBytes > m_Stats.PeakBytes)
+        m_Stats.PeakBytes = m_Stats.LiveBytes;
+
+    m_Stats.LiveAllocations++;
+    m_Stats.TotalAllocations++;
+    m_Stats.FrameAllocations++;
+}
+
+void* Allocator::AllocateSmall(size_t size, uint16_t sizeClass)
+{
+    uint8_t* block;
+
+    if (m_FreeLists[sizeClass] != nullptr)
+    {
+        block = reinterpret_cast<uint8_t*>(m_FreeLists[sizeClass]) - HeaderSize;
+        m_FreeLists[sizeClass] = m_FreeLists[sizeClass]->Next;
+    }
+    else
+    {
+        const size_t blockSize = HeaderSize + s_SizeClasses[sizeClass];
+
+        // What's left of the previous chunk is too small for a block of this class, it stays unused
+        if (m_ChunkCursor[sizeClass] == nullptr || m_ChunkCursor[sizeClass] + blockSize > m_ChunkEnd[sizeClass])
+        {
+            uint8_t* chunk = static_cast<uint8_t*>(memalign(Alignment, ChunkSize));
+            if (chunk == nullptr)
+                return nullptr;
+
+            m_ChunkCursor[sizeClass] = chunk;
+            m_ChunkEnd[sizeClass] = chunk + ChunkSize;
+            m_Stats.ReservedBytes += ChunkSize;
+        }
+
+        block = m_ChunkCursor[sizeClass];
+        m_ChunkCursor[sizeClass] += blockSize;
+    }
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block);
+    header->SizeClass = sizeClass;
+    header->Offset = 0;
+    header->Size = static_cast<uint32_t>(size);
+
+    OnAllocate(size);
+    return block + HeaderSize;
+}
+
+void* Allocator::AllocateLarge(size_t size, size_t alignment)
+{
+    // The header sits right before the user pointer, which stays aligned
+    const size_t offset = alignment > HeaderSize ? alignment : HeaderSize;
+
+    uint8_t* block = static_cast<uint8_t*>(memalign(alignment, size + offset));
+    if (block == nullptr)
+        return nullptr;
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(block + offset - HeaderSize);
+    header->SizeClass = LargeSizeClass;
+    header->Offset = static_cast<uint32_t>(offset);
+    header->Size = static_cast<uint32_t>(size);
+
+    m_Stats.ReservedBytes += size + offset;
+    m_Stats.LargeAllocations++;
+    OnAllocate(size);
+    return block + offset;
+}
+
+void* Allocator::Allocate(size_t size)
+{
+    return AllocateAligned(size, Alignment);
+}
+
+void* Allocator::AllocateAligned(size_t size, size_t alignment)
+{
+    void* ptr;
+
+    sys_lwmutex_lock(&m_Mutex, 0);
+    if (size <= MaxSmallSize && alignment <= Alignment)
+        ptr = AllocateSmall(size, m_SizeClassLookup[(size + Alignment - 1) / Alignment]);
+    else
+        ptr = AllocateLarge(size, alignment > Alignment ? alignment : Alignment);
+    sys_lwmutex_unlock(&m_Mutex);
+
+    return ptr;
+}
+
+void Allocator::Free(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    BlockHeader* header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - HeaderSize);
+
+    sys_lwmutex_lock(&m_Mutex, 0);
+
+    m_Stats.LiveBytes -= header->Size;
+    m_Stats.LiveAllocations--;
+
+    if (header->SizeClass == LargeSizeClass)
+    {
+        m_Stats.ReservedBytes -= header->Size + header->Offset;
+        m_Stats.LargeAllocations--;
+        free(static_cast<uint8_t*>(ptr) - header->Offset);
+    }
+    else
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->Next = m_FreeLists[header->SizeClass];
+        m_FreeLists[header->SizeClass] = block;
+    }
+
+    sys_lwmutex_unlock(&m_Mutex);
+}
+
+void Allocator::NewFrame()
+{
+    sys_lwmutex_lock(&m_Mutex, 0);
+    m_Stats.LastFrameAllocations = m_Stats.FrameAllocations;
+    m_Stats.FrameAllocations = 0;
+    sys_lwmutex_unlock(&m_Mutex);
+}
+
+Allocator::Stats Allocator::GetStats()
+{
+    sys_lwmutex_lock(&m_Mutex, 0);
+    Stats stats = m_Stats;
+    sys_lwmutex_unlock(&m_Mutex);
+
+    return stats;
+}
+
+void* Allocator::ImGuiAlloc(size_t size, void* user_data)
+{
+    return static_cast<Allocator*>(user_data)->Allocate(size);
+}
+
+void Allocator::ImGuiFree(void* ptr, void* user_data)
+{
+    static_cast<Allocator*>(user_data)->Free(ptr);
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/synchronization.h>
+
+/***
+* Size class allocator backing operator new (see NewDeleteOverride.hpp), and optionally Dear ImGui:
+*   ImGui::SetAllocatorFunctions(Allocator::ImGuiAlloc, Allocator::ImGuiFree, &Allocator::GetDefault());
+* Small blocks are carved out of chunks taken from the system heap, and recycled through a free list per size class,
+* so the sprx stops leaving many small holes in the heap it shares with the game. Larger blocks go to the system heap directly.
+* Every block is 16 bytes aligned.
+*/
+class Allocator
+{
+public:
+    struct Stats
+    {
+        size_t       LiveBytes;              // Requested bytes currently allocated
+        size_t       PeakBytes;              // Highest LiveBytes
+        size_t       ReservedBytes;          // Chunks taken from the system heap, plus the large blocks
+        uint32_t     LiveAllocations;
+        uint32_t     TotalAllocations;
+        uint32_t     LargeAllocations;       // Currently allocated blocks too large for a size class
+        uint32_t     FrameAllocations;       // Allocations since the last NewFrame()
+        uint32_t     LastFrameAllocations;   // Allocations during the previous frame
+    };
+
+    static const size_t Alignment = 16;
+    static const size_t ChunkSize = 32 * 1024;
+    static const size_t SizeClassCount = 14;
+    static const size_t MaxSmallSize = 2048;
+
+public:
+    Allocator();
+    Allocator(Allocator const&) = delete;
+    Allocator& operator=(Allocator const&) = delete;
+
+    // Allocator used by operator new, created on first use. The first use isn't thread safe: module_start calls it before starting any thread.
+    static Allocator& GetDefault();
+
+    void* Allocate(size_t size);
+    void* AllocateAligned(size_t size, size_t alignment);
+    void Free(void* ptr);
+
+    // Call once per frame to get allocations per frame.
+    void NewFrame();
+    Stats GetStats();
+
+    // ImGuiMemAllocFunc/ImGuiMemFreeFunc, user_data is the Allocator.
+    static void* ImGuiAlloc(size_t size, void* user_data);
+    static void ImGuiFree(void* ptr, void* user_data);
+
+private:
+    // Right before every block
+    struct BlockHeader
+    {
+        uint16_t     SizeClass;              // LargeSizeClass for blocks from the system heap
+        uint16_t     Reserved0;
+        uint32_t     Size;                   // Requested size
+        uint32_t     Offset;                 // From the start of the system block to the user pointer, large blocks only, up to the alignment
+        uint32_t     Reserved1;
+    };
+
+    struct FreeBlock
+    {
+        FreeBlock*   Next;
+    };
+
+    static const uint16_t LargeSizeClass = 0xFFFF;
+    static const size_t   HeaderSize = sizeof(BlockHeader);
+
+    void* AllocateSmall(size_t size, uint16_t sizeClass);
+    void* AllocateLarge(size_t size, size_t alignment);
+    void OnAllocate(size_t size);
+
+private:
+    sys_lwmutex_t    m_Mutex;
+    FreeBlock*       m_FreeLists[SizeClassCount];
+    uint8_t*         m_ChunkCursor[SizeClassCount];     // Next block to carve out of the current chunk of each class
+    uint8_t*         m_ChunkEnd[SizeClassCount];
+    uint8_t          m_SizeClassLookup[MaxSmallSize / Alignment + 1];   // (size + 15) / 16 -> size class
+    Stats            m_Stats;
+};
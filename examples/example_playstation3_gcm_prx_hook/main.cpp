@@ -15,6 +15,11 @@ sys_ppu_thread_t gMainPpuThreadId = SYS_PPU_THREAD_ID_INVALID;
 CDECL_BEGIN
 int module_start(unsigned int args, void* argp)
 {
+    // Create the allocator behind operator new before there's a second thread that could race to create it too.
+    // This prx doesn't link Dear ImGui. One that does installs the allocator for it here as well, before any context exists:
+    //   ImGui::SetAllocatorFunctions(Allocator::ImGuiAlloc, Allocator::ImGuiFree, &Allocator::GetDefault());
+    Allocator::GetDefault();
+
     sys_ppu_thread_create(&gMainPpuThreadId, [](uint64_t arg) -> void
     {
         InstallHooks();
@@ -113,6 +113,8 @@ void sysutilCallback(uint64_t uiStatus, uint64_t uiParam, void* pvUserData)
    // For unused parameter warnings
    (void)uiParam;
 
+   ImGui_ImplPlaystation3_HandleEvent(uiStatus, uiParam);
+
    switch (uiStatus)
    {
    case CELL_SYSUTIL_REQUEST_EXITGAME:
@@ -1,40 +1,802 @@
 #include "../imgui.h"
+#include "../imgui_internal.h"     // ImDrawListSharedData::VtxArena
 #include "imgui_impl_gcm.h"
+#include "imgui_impl_gcm_internal.h"  // Stream ring, texture swizzling
 #include <cell/gcm.h>
+#include <sys/timer.h>
 
+// Shader binaries, compiled offline with sce-cgc and linked in with ppu-lv2-objcopy (see imgui_impl_gcm_*.cg)
+extern struct _CGprogram _binary_imgui_impl_gcm_vp_vpo_start;
+extern struct _CGprogram _binary_imgui_impl_gcm_fp_fpo_start;
+extern struct _CGprogram _binary_imgui_impl_gcm_fp_alpha_fpo_start;
+extern struct _CGprogram _binary_imgui_impl_gcm_fp_color_fpo_start;
 
-bool        ImGui_ImplGcm_Init()
+// cellGcmCgInitProgram() patches the embedded binaries in place: only ever do it once per process.
+static bool g_ProgramsInitialized = false;
+
+#define IMGUI_IMPL_GCM_ALIGNMENT        128   // Textures need 128 bytes, fragment program ucode 64 bytes, vertex arrays 16 bytes
+
+enum ImGui_ImplGcm_FragmentProgramType
+{
+	ImGui_ImplGcm_FragmentProgram_Rgba,     // color * texel
+	ImGui_ImplGcm_FragmentProgram_Alpha,    // (color.rgb, color.a * texel.a), for single channel (CELL_GCM_TEXTURE_B8) textures
+	ImGui_ImplGcm_FragmentProgram_Color,    // color, for draw commands without a texture
+	ImGui_ImplGcm_FragmentProgram_COUNT
+};
+
+struct ImGui_ImplGcm_FragmentProgram
+{
+	CGprogram               Program;
+	uint32_t                UCodeOffset;            // Ucode copy in local memory
+	uint8_t                 TextureUnit;            // Unused by ImGui_ImplGcm_FragmentProgram_Color
+};
+
+// Header of a block of the zero-copy vertex arena, vertices follow it. Size includes the header.
+struct ImGui_ImplGcm_VtxArenaBlock
+{
+	uint32_t                Size;
+	uint32_t                Next;                   // Offset of the next free or pending block, 0 = none
+	uint32_t                Fence;                  // Pending blocks: label value after which the RSX no longer reads it
+	uint32_t                _Padding;
+};
+
+// Zero-copy vertex arena: first-fit allocator over a block of main memory mapped for the RSX, backing ImDrawList::VtxBuffer.
+// Its bookkeeping lives at the start of the block itself, so it stays valid as long as the block does
+// (draw lists belong to the Dear ImGui context, which may outlive the backend).
+// Freed blocks may still be read by frames in flight: they wait in the pending list, oldest first, until the label passes their fence.
+struct ImGui_ImplGcm_VtxArena
 {
+	ImDrawVtxArena          Hook;                   // Registered in ImDrawListSharedData::VtxArena
+	uint8_t*                Base;
+	uint32_t                Size;
+	uint32_t                Offset;                 // RSX offset of Base (CELL_GCM_LOCATION_MAIN)
+	uint32_t                FreeList;               // Offset of the first free block, sorted by address, 0 = none
+	uint32_t                PendingFirst;           // Offset of the oldest pending block, 0 = none
+	uint32_t                PendingLast;
+	uint32_t                LiveBytes;
+	volatile uint32_t*      Label;                  // The backend's label, written by every ImGui_ImplGcm_RenderDrawData() call
+	uint32_t                LastFence;              // Fence of the last frame submitted, 0 = none since the label was reset
+	CellGcmContextData*     Context;                // Flushed before waiting, NULL once the backend is shut down
+	unsigned int            Waits;                  // Times AllocFunc had to wait for the RSX, reported by the next ImGui_ImplGcm_RenderDrawData()
+};
 
+struct ImGui_ImplGcm_Data
+{
+	uint8_t*                    LocalMemory;
+	uint32_t                    LocalMemorySize;
+	uint32_t                    LocalMemoryUsed;
+	bool                        DeviceObjectsCreated;
+	bool                        ShadersCreated;         // Shaders and their ucode are kept across InvalidateDeviceObjects()/CreateDeviceObjects()
+	uint32_t                    ShadersMemorySize;      // Local memory used by fragment program ucode, at the start of the block
+
+	CGprogram                   VertexProgram;
+	void*                       VertexProgramUCode;
+	CGparameter                 ProjMtxParam;
+	uint8_t                     AttribPosition;
+	uint8_t                     AttribUV;
+	uint8_t                     AttribColor;
+	ImGui_ImplGcm_FragmentProgram FragmentPrograms[ImGui_ImplGcm_FragmentProgram_COUNT];
+
+	CellGcmTexture              FontTexture;
+	bool                        FontTextureSwizzle;     // See ImGui_ImplGcm_SetFontTextureSwizzle()
+
+	ImGui_ImplGcm_StreamRing    StreamRing;             // Vertices followed by indices, sub-allocated every frame
+	uint8_t                     LabelIndex;
+	CellGcmContextData*         LastContext;            // Context given to the last ImGui_ImplGcm_RenderDrawData() call
+	ImGui_ImplGcm_VtxArena*     VtxArena;
+
+	ImGui_ImplGcm_FrameStats    FrameStats;
+
+	ImGui_ImplGcm_Data() { memset(this, 0, sizeof(*this)); }
+};
+
+// Tracks what was last emitted into the command buffer so consecutive ImDrawCmd with identical state don't re-emit it.
+struct ImGui_ImplGcm_RenderState
+{
+	const CellGcmTexture*   Texture;
+	int                     FragmentProgram;        // ImGui_ImplGcm_FragmentProgramType, -1 = none
+	uint32_t                VtxOffset;
+	uint8_t                 VtxLocation;
+	uint16_t                Scissor[4];
+	bool                    VtxOffsetValid;
+	bool                    ScissorValid;
+	const uint32_t*         CommandMark;
+
+	ImGui_ImplGcm_RenderState() { memset(this, 0, sizeof(*this)); }
+};
+
+// Backend data stored in io.BackendRendererUserData to allow support for multiple Dear ImGui contexts
+// It is STRONGLY preferred that you use docking branch with multi-viewports (== single Dear ImGui context + multiple windows) instead of multiple Dear ImGui contexts.
+static ImGui_ImplGcm_Data* ImGui_ImplGcm_GetBackendData()
+{
+	return ImGui::GetCurrentContext() ? (ImGui_ImplGcm_Data*)ImGui::GetIO().BackendRendererUserData : NULL;
 }
 
-void        ImGui_ImplGcm_Shutdown()
+// Sub-allocate from the local memory block given to ImGui_ImplGcm_Init(). Everything is released at once by ImGui_ImplGcm_InvalidateDeviceObjects().
+static void* ImGui_ImplGcm_AllocLocal(uint32_t size, uint32_t* out_offset)
 {
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	uint32_t start = (bd->LocalMemoryUsed + IMGUI_IMPL_GCM_ALIGNMENT - 1) & ~(IMGUI_IMPL_GCM_ALIGNMENT - 1);
+	if (start + size > bd->LocalMemorySize)
+		return NULL;
+	bd->LocalMemoryUsed = start + size;
 
+	void* ptr = bd->LocalMemory + start;
+	if (cellGcmAddressToOffset(ptr, out_offset) != CELL_OK)
+		return NULL;
+	return ptr;
 }
 
-void        ImGui_ImplGcm_NewFrame()
+// Count command buffer bytes written since the last call. The context callback may have wrapped 'current' back to 'begin' in between.
+static void ImGui_ImplGcm_CountCommandBytes(ImGui_ImplGcm_Data* bd, ImGui_ImplGcm_RenderState* rs, CellGcmContextData* ctx)
 {
+	if (ctx->current >= rs->CommandMark)
+		bd->FrameStats.CommandBytes += (uint32_t)((const uint8_t*)ctx->current - (const uint8_t*)rs->CommandMark);
+	else
+		bd->FrameStats.CommandBytes += (uint32_t)((const uint8_t*)ctx->current - (const uint8_t*)ctx->begin);
+	rs->CommandMark = ctx->current;
+}
 
+// ImGui_ImplGcm_StreamRingWaitFunc, user_data is the context RenderDrawData() is writing to.
+static void ImGui_ImplGcm_StreamRingWait(const ImGui_ImplGcm_StreamRing* ring, uint32_t fence, void* user_data)
+{
+	// Kick the pending commands (the label write included) before spinning, otherwise we would wait forever.
+	cellGcmFlush((CellGcmContextData*)user_data);
+	while (!ImGui_ImplGcm_StreamRingFencePassed(ring, fence))
+		sys_timer_usleep(30);
 }
 
-void        ImGui_ImplGcm_RenderDrawData(ImDrawData* draw_data)
+// Wait until the RSX is done with everything submitted by ImGui_ImplGcm_RenderDrawData() so far.
+static void ImGui_ImplGcm_WaitIdle(ImGui_ImplGcm_Data* bd)
 {
+	ImGui_ImplGcm_StreamRing* ring = &bd->StreamRing;
+	if (ring->InFlightCount == 0)
+		return;
+	cellGcmFlush(bd->LastContext);
+	while (!ImGui_ImplGcm_StreamRingFencePassed(ring, ring->LastFence))
+		sys_timer_usleep(30);
+	ring->InFlightCount = 0;
+}
 
+static inline ImGui_ImplGcm_VtxArenaBlock* ImGui_ImplGcm_VtxArenaGetBlock(ImGui_ImplGcm_VtxArena* arena, uint32_t offset)
+{
+	return (ImGui_ImplGcm_VtxArenaBlock*)(arena->Base + offset);
 }
 
-// Use if you want to reset your rendering device without losing ImGui state.
-void        ImGui_ImplGcm_DestroyDeviceObjects()
+static inline bool ImGui_ImplGcm_VtxArenaFencePassed(const ImGui_ImplGcm_VtxArena* arena, uint32_t fence)
+{
+	return fence == 0 || (int32_t)(*arena->Label - fence) >= 0; // Wrap-around safe
+}
+
+// Put a block back in the free list, in address order, merging with the following and preceding free blocks
+static void ImGui_ImplGcm_VtxArenaRelease(ImGui_ImplGcm_VtxArena* arena, uint32_t offset)
+{
+	ImGui_ImplGcm_VtxArenaBlock* block = ImGui_ImplGcm_VtxArenaGetBlock(arena, offset);
+	uint32_t prev = 0;
+	uint32_t* link = &arena->FreeList;
+	while (*link != 0 && *link < offset)
+	{
+		prev = *link;
+		link = &ImGui_ImplGcm_VtxArenaGetBlock(arena, *link)->Next;
+	}
+	block->Next = *link;
+	*link = offset;
+	if (block->Next != 0 && offset + block->Size == block->Next)
+	{
+		ImGui_ImplGcm_VtxArenaBlock* next = ImGui_ImplGcm_VtxArenaGetBlock(arena, block->Next);
+		block->Size += next->Size;
+		block->Next = next->Next;
+	}
+	if (prev != 0)
+	{
+		ImGui_ImplGcm_VtxArenaBlock* prev_block = ImGui_ImplGcm_VtxArenaGetBlock(arena, prev);
+		if (prev + prev_block->Size == offset)
+		{
+			prev_block->Size += block->Size;
+			prev_block->Next = block->Next;
+		}
+	}
+}
+
+// Release pending blocks the RSX is done with (all of them when 'all' is set, once the RSX is known to be idle)
+static void ImGui_ImplGcm_VtxArenaReclaim(ImGui_ImplGcm_VtxArena* arena, bool all)
+{
+	while (arena->PendingFirst != 0)
+	{
+		const uint32_t offset = arena->PendingFirst;
+		ImGui_ImplGcm_VtxArenaBlock* block = ImGui_ImplGcm_VtxArenaGetBlock(arena, offset);
+		if (!all && !ImGui_ImplGcm_VtxArenaFencePassed(arena, block->Fence))
+			break;
+		arena->PendingFirst = block->Next;
+		if (arena->PendingFirst == 0)
+			arena->PendingLast = 0;
+		ImGui_ImplGcm_VtxArenaRelease(arena, offset);
+	}
+}
+
+static void* ImGui_ImplGcm_VtxArenaAlloc(size_t sz, void* user_data)
+{
+	ImGui_ImplGcm_VtxArena* arena = (ImGui_ImplGcm_VtxArena*)user_data;
+	const uint32_t need = (uint32_t)((sz + sizeof(ImGui_ImplGcm_VtxArenaBlock) + 15) & ~(size_t)15);
+	ImGui_ImplGcm_VtxArenaReclaim(arena, false);
+	for (;;)
+	{
+		uint32_t* link = &arena->FreeList;
+		while (*link != 0)
+		{
+			ImGui_ImplGcm_VtxArenaBlock* block = ImGui_ImplGcm_VtxArenaGetBlock(arena, *link);
+			if (block->Size >= need)
+			{
+				// Split when the remainder is worth keeping, otherwise hand out the whole block
+				if (block->Size - need >= 64)
+				{
+					ImGui_ImplGcm_VtxArenaBlock* rest = ImGui_ImplGcm_VtxArenaGetBlock(arena, *link + need);
+					rest->Size = block->Size - need;
+					rest->Next = block->Next;
+					block->Size = need;
+					*link += need;
+				}
+				else
+				{
+					*link = block->Next;
+				}
+				block->Next = 0;
+				arena->LiveBytes += block->Size;
+				return block + 1;
+			}
+			link = &block->Next;
+		}
+		if (arena->PendingFirst == 0)
+			return NULL; // Full: ImDrawList falls back to the heap
+
+		// Only the frames still reading freed blocks stand in the way: wait for the oldest one, not for the RSX to go idle
+		const uint32_t fence = ImGui_ImplGcm_VtxArenaGetBlock(arena, arena->PendingFirst)->Fence;
+		if (arena->Context)
+			cellGcmFlush(arena->Context);
+		while (!ImGui_ImplGcm_VtxArenaFencePassed(arena, fence))
+			sys_timer_usleep(30);
+		arena->Waits++;
+		ImGui_ImplGcm_VtxArenaReclaim(arena, false);
+	}
+}
+
+// The RSX may still be reading the block for frames in flight: it only becomes free again once the label passes the last submitted frame.
+static void ImGui_ImplGcm_VtxArenaFree(void* ptr, void* user_data)
+{
+	if (ptr == NULL)
+		return;
+	ImGui_ImplGcm_VtxArena* arena = (ImGui_ImplGcm_VtxArena*)user_data;
+	ImGui_ImplGcm_VtxArenaBlock* block = (ImGui_ImplGcm_VtxArenaBlock*)ptr - 1;
+	const uint32_t offset = (uint32_t)((uint8_t*)block - arena->Base);
+	arena->LiveBytes -= block->Size;
+	if (ImGui_ImplGcm_VtxArenaFencePassed(arena, arena->LastFence))
+	{
+		ImGui_ImplGcm_VtxArenaRelease(arena, offset);
+		return;
+	}
+	block->Fence = arena->LastFence;
+	block->Next = 0;
+	if (arena->PendingLast != 0)
+		ImGui_ImplGcm_VtxArenaGetBlock(arena, arena->PendingLast)->Next = offset;
+	else
+		arena->PendingFirst = offset;
+	arena->PendingLast = offset;
+}
+
+bool ImGui_ImplGcm_Init(void* local_memory, unsigned int local_memory_size, unsigned char label_index)
+{
+	ImGuiIO& io = ImGui::GetIO();
+	IM_ASSERT(io.BackendRendererUserData == NULL && "Already initialized a renderer backend!");
+	IM_ASSERT(local_memory != NULL && ((uintptr_t)local_memory & (IMGUI_IMPL_GCM_ALIGNMENT - 1)) == 0);
+
+	// Setup backend capabilities flags
+	ImGui_ImplGcm_Data* bd = IM_NEW(ImGui_ImplGcm_Data)();
+	io.BackendRendererUserData = (void*)bd;
+	io.BackendRendererName = "imgui_impl_gcm";
+	io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;  // We can honor the ImDrawCmd::VtxOffset field, allowing for large meshes.
+
+	bd->LocalMemory = (uint8_t*)local_memory;
+	bd->LocalMemorySize = local_memory_size;
+	bd->LabelIndex = label_index;
+
+	return true;
+}
+
+void ImGui_ImplGcm_Shutdown()
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	IM_ASSERT(bd != NULL && "No renderer backend to shutdown, or already shutdown?");
+	ImGuiIO& io = ImGui::GetIO();
+
+	ImGui_ImplGcm_DestroyDeviceObjects();
+	if (bd->VtxArena)
+	{
+		ImGui::GetDrawListSharedData()->VtxArena = NULL; // Lists already in the arena keep using it until they are freed
+		bd->VtxArena->Context = NULL;
+	}
+	io.BackendRendererName = NULL;
+	io.BackendRendererUserData = NULL;
+	IM_DELETE(bd);
+}
+
+void ImGui_ImplGcm_NewFrame()
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	IM_ASSERT(bd != NULL && "Did you call ImGui_ImplGcm_Init()?");
+
+	if (!bd->DeviceObjectsCreated)
+		ImGui_ImplGcm_CreateDeviceObjects();
+
+	// Draw lists move to fresh arena blocks as they get rebuilt (see ImDrawVtxArena), hand them the ones the RSX is done with.
+	if (bd->VtxArena)
+		ImGui_ImplGcm_VtxArenaReclaim(bd->VtxArena, false);
+}
+
+void ImGui_ImplGcm_SetFontTextureSwizzle(bool swizzle)
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	IM_ASSERT(bd != NULL && "Did you call ImGui_ImplGcm_Init()?");
+	bd->FontTextureSwizzle = swizzle;
+}
+
+bool ImGui_ImplGcm_SetVertexArena(void* io_memory, unsigned int io_memory_size)
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	IM_ASSERT(bd != NULL && "Did you call ImGui_ImplGcm_Init()?");
+	IM_ASSERT(bd->VtxArena == NULL && "Vertex arena already set!");
+
+	const uint32_t header_size = (sizeof(ImGui_ImplGcm_VtxArena) + 15) & ~15;
+	if (io_memory == NULL || io_memory_size < header_size + 1024)
+		return false;
+	ImGui_ImplGcm_VtxArena* arena = (ImGui_ImplGcm_VtxArena*)io_memory;
+	memset(arena, 0, sizeof(*arena));
+	arena->Base = (uint8_t*)io_memory;
+	arena->Size = io_memory_size;
+	if (cellGcmAddressToOffset(io_memory, &arena->Offset) != CELL_OK)
+		return false;
+
+	// One free block spanning the whole memory after the header
+	arena->FreeList = header_size;
+	ImGui_ImplGcm_VtxArenaBlock* block = ImGui_ImplGcm_VtxArenaGetBlock(arena, header_size);
+	block->Size = (io_memory_size - header_size) & ~15;
+	block->Next = 0;
+
+	arena->Hook.AllocFunc = ImGui_ImplGcm_VtxArenaAlloc;
+	arena->Hook.FreeFunc = ImGui_ImplGcm_VtxArenaFree;
+	arena->Hook.UserData = arena;
+	arena->Label = cellGcmGetLabelAddress(bd->LabelIndex);
+	ImGui::GetDrawListSharedData()->VtxArena = &arena->Hook;
+	bd->VtxArena = arena;
+	return true;
+}
+
+static void ImGui_ImplGcm_SetupRenderState(CellGcmContextData* ctx, ImGui_ImplGcm_RenderState* rs, ImDrawData* draw_data, int fb_width, int fb_height)
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+
+	// Setup render state: alpha-blending enabled, no face culling, no depth testing, no stencil, scissor enabled.
+	// There is no way to read back RSX state, so the caller is responsible for restoring whatever it needs after this.
+	cellGcmSetBlendEnable(ctx, CELL_GCM_TRUE);
+	cellGcmSetBlendFunc(ctx, CELL_GCM_SRC_ALPHA, CELL_GCM_ONE_MINUS_SRC_ALPHA, CELL_GCM_ONE, CELL_GCM_ONE_MINUS_SRC_ALPHA);
+	cellGcmSetBlendEquation(ctx, CELL_GCM_FUNC_ADD, CELL_GCM_FUNC_ADD);
+	cellGcmSetCullFaceEnable(ctx, CELL_GCM_FALSE);
+	cellGcmSetDepthTestEnable(ctx, CELL_GCM_FALSE);
+	cellGcmSetStencilTestEnable(ctx, CELL_GCM_FALSE);
+	cellGcmSetAlphaTestEnable(ctx, CELL_GCM_FALSE);
+	cellGcmSetColorMask(ctx, CELL_GCM_COLOR_MASK_R | CELL_GCM_COLOR_MASK_G | CELL_GCM_COLOR_MASK_B | CELL_GCM_COLOR_MASK_A);
+
+	// Setup viewport, assuming the bound surface uses CELL_GCM_WINDOW_ORIGIN_TOP like the SDK samples.
+	float scale[4] = { fb_width * 0.5f, fb_height * -0.5f, 0.5f, 0.0f };
+	float offset[4] = { fb_width * 0.5f, fb_height * 0.5f, 0.5f, 0.0f };
+	cellGcmSetViewport(ctx, 0, 0, (uint16_t)fb_width, (uint16_t)fb_height, 0.0f, 1.0f, scale, offset);
+
+	// Setup orthographic projection matrix (row-major, as expected by cellGcmSetVertexProgramParameter)
+	// Our visible imgui space lies from draw_data->DisplayPos (top left) to draw_data->DisplayPos+data_data->DisplaySize (bottom right). DisplayPos is (0,0) for single viewport apps.
+	float L = draw_data->DisplayPos.x;
+	float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+	float T = draw_data->DisplayPos.y;
+	float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+	const float ortho_projection[16] =
+	{
+		2.0f / (R - L),     0.0f,               0.0f,   (R + L) / (L - R),
+		0.0f,               2.0f / (T - B),     0.0f,   (T + B) / (B - T),
+		0.0f,               0.0f,               0.5f,   0.5f,
+		0.0f,               0.0f,               0.0f,   1.0f,
+	};
+
+	// Setup shaders
+	cellGcmSetVertexProgram(ctx, bd->VertexProgram, bd->VertexProgramUCode);
+	cellGcmSetVertexProgramParameter(ctx, bd->ProjMtxParam, ortho_projection);
+
+	// Forget everything bound by a previous pass (or by a user callback). The fragment program is picked per texture.
+	rs->Texture = NULL;
+	rs->FragmentProgram = -1;
+	rs->VtxOffsetValid = false;
+	rs->ScissorValid = false;
+}
+
+static void ImGui_ImplGcm_SetupVertexArrays(CellGcmContextData* ctx, uint8_t location, uint32_t vtx_offset)
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	cellGcmSetVertexDataArray(ctx, bd->AttribPosition, 0, sizeof(ImDrawVert), 2, CELL_GCM_VERTEX_F, location, vtx_offset + IM_OFFSETOF(ImDrawVert, pos));
+	cellGcmSetVertexDataArray(ctx, bd->AttribUV, 0, sizeof(ImDrawVert), 2, CELL_GCM_VERTEX_F, location, vtx_offset + IM_OFFSETOF(ImDrawVert, uv));
+	cellGcmSetVertexDataArray(ctx, bd->AttribColor, 0, sizeof(ImDrawVert), 4, CELL_GCM_VERTEX_UB, location, vtx_offset + IM_OFFSETOF(ImDrawVert, col));
+}
+
+static void ImGui_ImplGcm_SetupTexture(CellGcmContextData* ctx, uint8_t unit, const CellGcmTexture* texture)
+{
+	cellGcmSetTexture(ctx, unit, texture);
+	cellGcmSetTextureControl(ctx, unit, CELL_GCM_TRUE, 0 << 8, 12 << 8, CELL_GCM_TEXTURE_MAX_ANISO_1);
+	cellGcmSetTextureFilter(ctx, unit, 0, CELL_GCM_TEXTURE_LINEAR, CELL_GCM_TEXTURE_LINEAR, CELL_GCM_TEXTURE_CONVOLUTION_QUINCUNX);
+	cellGcmSetTextureAddress(ctx, unit, CELL_GCM_TEXTURE_CLAMP_TO_EDGE, CELL_GCM_TEXTURE_CLAMP_TO_EDGE, CELL_GCM_TEXTURE_CLAMP_TO_EDGE, CELL_GCM_TEXTURE_UNSIGNED_REMAP_NORMAL, CELL_GCM_TEXTURE_ZFUNC_NEVER, 0);
+}
+
+// Single channel textures go through the alpha-only fragment program, other textures through the RGBA one, no texture through the color one.
+static int ImGui_ImplGcm_GetFragmentProgramForTexture(const CellGcmTexture* texture)
+{
+	if (texture == NULL)
+		return ImGui_ImplGcm_FragmentProgram_Color;
+	const uint8_t base_format = texture->format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN);
+	return (base_format == CELL_GCM_TEXTURE_B8) ? ImGui_ImplGcm_FragmentProgram_Alpha : ImGui_ImplGcm_FragmentProgram_Rgba;
+}
+
+void ImGui_ImplGcm_RenderDrawData(ImDrawData* draw_data, CellGcmContextData* context)
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	memset(&bd->FrameStats, 0, sizeof(bd->FrameStats));
+
+	// Avoid rendering when minimized
+	int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+	int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+	if (fb_width <= 0 || fb_height <= 0 || draw_data->TotalVtxCount == 0 || !bd->DeviceObjectsCreated)
+		return;
+
+	CellGcmContextData* ctx = context ? context : gCellGcmCurrentContext;
+	bd->LastContext = ctx;
+	ImGui_ImplGcm_RenderState rs;
+	rs.CommandMark = ctx->current;
+
+	// Vertices and indices of every list are packed back to back into this frame's region of the stream ring
+	// (except vertices already living in the zero-copy arena, which the RSX reads in place)
+	ImGui_ImplGcm_StreamRing* ring = &bd->StreamRing;
+	uint32_t vtx_bytes = 0;
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+		if (draw_data->CmdLists[n]->_VtxArena == NULL)
+			vtx_bytes += (uint32_t)(draw_data->CmdLists[n]->VtxBuffer.Size * sizeof(ImDrawVert));
+	const uint32_t idx_bytes = (uint32_t)(draw_data->TotalIdxCount * sizeof(ImDrawIdx));
+	const uint32_t idx_start = (vtx_bytes + 15) & ~15;
+	const uint32_t frame_size = (idx_start + idx_bytes + 15) & ~15;
+	const uint32_t frame_begin = ImGui_ImplGcm_StreamRingAlloc(ring, frame_size, ImGui_ImplGcm_StreamRingWait, ctx, &bd->FrameStats.RingWaits);
+	if (frame_begin == (uint32_t)-1)
+	{
+		IM_ASSERT(0 && "Vertex/index data does not fit in local memory, give a bigger block to ImGui_ImplGcm_Init()");
+		return;
+	}
+	const uint32_t frame_offset = ring->Offset + frame_begin;
+
+	ImDrawVert* vtx_dst = (ImDrawVert*)(ring->Data + frame_begin);
+	ImDrawIdx* idx_dst = (ImDrawIdx*)(ring->Data + frame_begin + idx_start);
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList* cmd_list = draw_data->CmdLists[n];
+		if (cmd_list->_VtxArena == NULL)
+		{
+			memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+			vtx_dst += cmd_list->VtxBuffer.Size;
+		}
+		else
+		{
+			bd->FrameStats.ZeroCopyBytes += (uint32_t)(cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+		}
+		memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+		idx_dst += cmd_list->IdxBuffer.Size;
+	}
+	bd->FrameStats.UploadBytes = vtx_bytes + idx_bytes;
+	cellGcmSetInvalidateVertexCache(ctx);
+
+	// Setup desired GCM state
+	ImGui_ImplGcm_SetupRenderState(ctx, &rs, draw_data, fb_width, fb_height);
+
+	// Will project scissor/clipping rectangles into framebuffer space
+	ImVec2 clip_off = draw_data->DisplayPos;         // (0,0) unless using multi-viewports
+	ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
+
+	// Render command lists
+	// (Because we merged all buffers into a single one, we maintain our own offset into them)
+	uint32_t global_vtx_offset = 0;
+	uint32_t global_idx_offset = 0;
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList* cmd_list = draw_data->CmdLists[n];
+		const bool vtx_in_arena = (cmd_list->_VtxArena != NULL);
+		const uint8_t vtx_location = vtx_in_arena ? CELL_GCM_LOCATION_MAIN : CELL_GCM_LOCATION_LOCAL;
+		const uint32_t vtx_base = vtx_in_arena ? bd->VtxArena->Offset + (uint32_t)((uint8_t*)cmd_list->VtxBuffer.Data - bd->VtxArena->Base) : frame_offset + global_vtx_offset * sizeof(ImDrawVert);
+		for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
+		{
+			const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+			if (pcmd->UserCallback != NULL)
+			{
+				// User callback, registered via ImDrawList::AddCallback()
+				// (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
+				if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
+					ImGui_ImplGcm_SetupRenderState(ctx, &rs, draw_data, fb_width, fb_height);
+				else
+				{
+					pcmd->UserCallback(cmd_list, pcmd);
+					ImGui_ImplGcm_SetupRenderState(ctx, &rs, draw_data, fb_width, fb_height);
+				}
+				continue;
+			}
+
+			// Project scissor/clipping rectangles into framebuffer space
+			ImVec2 clip_min((pcmd->ClipRect.x - clip_off.x) * clip_scale.x, (pcmd->ClipRect.y - clip_off.y) * clip_scale.y);
+			ImVec2 clip_max((pcmd->ClipRect.z - clip_off.x) * clip_scale.x, (pcmd->ClipRect.w - clip_off.y) * clip_scale.y);
+			if (clip_min.x < 0.0f) { clip_min.x = 0.0f; }
+			if (clip_min.y < 0.0f) { clip_min.y = 0.0f; }
+			if (clip_max.x > fb_width) { clip_max.x = (float)fb_width; }
+			if (clip_max.y > fb_height) { clip_max.y = (float)fb_height; }
+			if (clip_max.x <= clip_min.x || clip_max.y <= clip_min.y)
+				continue;
+
+			// Apply scissor/clipping rectangle
+			const uint16_t scissor[4] = { (uint16_t)clip_min.x, (uint16_t)clip_min.y, (uint16_t)(clip_max.x - clip_min.x), (uint16_t)(clip_max.y - clip_min.y) };
+			if (!rs.ScissorValid || memcmp(scissor, rs.Scissor, sizeof(scissor)) != 0)
+			{
+				cellGcmSetScissor(ctx, scissor[0], scissor[1], scissor[2], scissor[3]);
+				memcpy(rs.Scissor, scissor, sizeof(scissor));
+				rs.ScissorValid = true;
+				bd->FrameStats.StateChanges++;
+			}
+
+			// Bind fragment program and texture
+			const CellGcmTexture* texture = (const CellGcmTexture*)pcmd->GetTexID();
+			if (texture != rs.Texture || rs.FragmentProgram == -1)
+			{
+				const int fragment_program = ImGui_ImplGcm_GetFragmentProgramForTexture(texture);
+				const ImGui_ImplGcm_FragmentProgram& fp = bd->FragmentPrograms[fragment_program];
+				if (fragment_program != rs.FragmentProgram)
+				{
+					cellGcmSetFragmentProgram(ctx, fp.Program, fp.UCodeOffset);
+					rs.FragmentProgram = fragment_program;
+					bd->FrameStats.StateChanges++;
+				}
+				if (texture != NULL) // The color program samples nothing, texture units can stay as they are
+				{
+					ImGui_ImplGcm_SetupTexture(ctx, fp.TextureUnit, texture);
+					bd->FrameStats.StateChanges++;
+				}
+				rs.Texture = texture;
+			}
+
+			// Bind vertices (only moves when switching list or when a list goes past 64K vertices)
+			const uint32_t vtx_offset = vtx_base + pcmd->VtxOffset * sizeof(ImDrawVert);
+			if (!rs.VtxOffsetValid || vtx_offset != rs.VtxOffset || vtx_location != rs.VtxLocation)
+			{
+				ImGui_ImplGcm_SetupVertexArrays(ctx, vtx_location, vtx_offset);
+				rs.VtxOffset = vtx_offset;
+				rs.VtxLocation = vtx_location;
+				rs.VtxOffsetValid = true;
+				bd->FrameStats.StateChanges++;
+			}
+
+			// Draw
+			const uint32_t idx_offset = frame_offset + idx_start + (pcmd->IdxOffset + global_idx_offset) * sizeof(ImDrawIdx);
+			cellGcmSetDrawIndexArray(ctx, CELL_GCM_PRIMITIVE_TRIANGLES, pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? CELL_GCM_DRAW_INDEX_ARRAY_TYPE_16 : CELL_GCM_DRAW_INDEX_ARRAY_TYPE_32, CELL_GCM_LOCATION_LOCAL, idx_offset);
+			bd->FrameStats.DrawCalls++;
+			ImGui_ImplGcm_CountCommandBytes(bd, &rs, ctx);
+		}
+		global_idx_offset += cmd_list->IdxBuffer.Size;
+		if (!vtx_in_arena)
+			global_vtx_offset += cmd_list->VtxBuffer.Size;
+	}
+
+	// Release this frame's region once the RSX back end is done with it (and the arena blocks it read, once they get freed)
+	const uint32_t fence = ImGui_ImplGcm_StreamRingSubmit(ring, frame_begin, frame_begin + frame_size);
+	cellGcmSetWriteBackEndLabel(ctx, bd->LabelIndex, fence);
+	ImGui_ImplGcm_CountCommandBytes(bd, &rs, ctx);
+	if (bd->VtxArena)
+	{
+		bd->VtxArena->LastFence = fence;
+		bd->VtxArena->Context = ctx;
+		bd->FrameStats.VtxArenaWaits = bd->VtxArena->Waits;
+		bd->VtxArena->Waits = 0;
+	}
+}
+
+void ImGui_ImplGcm_GetFrameStats(ImGui_ImplGcm_FrameStats* out_stats)
 {
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	IM_ASSERT(bd != NULL && "Did you call ImGui_ImplGcm_Init()?");
+	*out_stats = bd->FrameStats;
+}
+
+static bool ImGui_ImplGcm_CreateShaders()
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	if (bd->ShadersCreated)
+		return true;
+
+	CGprogram fragment_programs[ImGui_ImplGcm_FragmentProgram_COUNT];
+	fragment_programs[ImGui_ImplGcm_FragmentProgram_Rgba] = &_binary_imgui_impl_gcm_fp_fpo_start;
+	fragment_programs[ImGui_ImplGcm_FragmentProgram_Alpha] = &_binary_imgui_impl_gcm_fp_alpha_fpo_start;
+	fragment_programs[ImGui_ImplGcm_FragmentProgram_Color] = &_binary_imgui_impl_gcm_fp_color_fpo_start;
+	bd->VertexProgram = &_binary_imgui_impl_gcm_vp_vpo_start;
+	if (!g_ProgramsInitialized)
+	{
+		cellGcmCgInitProgram(bd->VertexProgram);
+		for (int n = 0; n < ImGui_ImplGcm_FragmentProgram_COUNT; n++)
+			cellGcmCgInitProgram(fragment_programs[n]);
+		g_ProgramsInitialized = true;
+	}
 
+	// The vertex program ucode is sent through the command buffer, the fragment program ones are fetched by the RSX from local memory.
+	// They are uploaded once at the start of the block, InvalidateDeviceObjects() leaves them there.
+	IM_ASSERT(bd->LocalMemoryUsed == 0);
+	uint32_t ucode_size;
+	cellGcmCgGetUCode(bd->VertexProgram, &bd->VertexProgramUCode, &ucode_size);
+	for (int n = 0; n < ImGui_ImplGcm_FragmentProgram_COUNT; n++)
+	{
+		ImGui_ImplGcm_FragmentProgram& fp = bd->FragmentPrograms[n];
+		fp.Program = fragment_programs[n];
+
+		void* ucode;
+		cellGcmCgGetUCode(fp.Program, &ucode, &ucode_size);
+		IM_ASSERT(ucode_size > 0 && (ucode_size & 15) == 0 && "Unexpected fragment program binary, RSX fragment instructions are 16 bytes each");
+		void* ucode_local = ImGui_ImplGcm_AllocLocal(ucode_size, &fp.UCodeOffset);
+		if (ucode_local == NULL)
+		{
+			bd->LocalMemoryUsed = 0;
+			return false;
+		}
+		memcpy(ucode_local, ucode, ucode_size);
+		CGparameter texture_param = cellGcmCgGetNamedParameter(fp.Program, "Texture");
+		fp.TextureUnit = texture_param ? (uint8_t)(cellGcmCgGetParameterResource(fp.Program, texture_param) - CG_TEXUNIT0) : 0;
+	}
+
+	bd->ProjMtxParam = cellGcmCgGetNamedParameter(bd->VertexProgram, "ProjMtx");
+	bd->AttribPosition = (uint8_t)(cellGcmCgGetParameterResource(bd->VertexProgram, cellGcmCgGetNamedParameter(bd->VertexProgram, "position")) - CG_ATTR0);
+	bd->AttribUV = (uint8_t)(cellGcmCgGetParameterResource(bd->VertexProgram, cellGcmCgGetNamedParameter(bd->VertexProgram, "texcoord")) - CG_ATTR0);
+	bd->AttribColor = (uint8_t)(cellGcmCgGetParameterResource(bd->VertexProgram, cellGcmCgGetNamedParameter(bd->VertexProgram, "color")) - CG_ATTR0);
+	bd->ShadersMemorySize = bd->LocalMemoryUsed;
+	bd->ShadersCreated = true;
+	return true;
 }
 
-void        ImGui_ImplGcm_InvalidateDeviceObjects()
+static void ImGui_ImplGcm_DestroyShaders()
 {
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	memset(bd->FragmentPrograms, 0, sizeof(bd->FragmentPrograms));
+	bd->LocalMemoryUsed = bd->ShadersMemorySize = 0;
+	bd->ShadersCreated = false;
+}
 
+// Custom rects besides Dear ImGui's own (mouse cursors, baked lines), added with AddCustomRectRegular()/AddCustomRectFontGlyph()
+static bool ImGui_ImplGcm_AtlasHasUserCustomRects(const ImFontAtlas* atlas)
+{
+	for (int n = 0; n < atlas->CustomRects.Size; n++)
+		if (n != atlas->PackIdMouseCursors && n != atlas->PackIdLines)
+			return true;
+	return false;
 }
 
-bool        ImGui_ImplGcm_CreateDeviceObjects()
+static bool ImGui_ImplGcm_CreateFontsTexture()
 {
+	// Build texture atlas
+	// Glyphs only need coverage: load as Alpha8 and expand in the fragment program (see imgui_impl_gcm_fp_alpha.cg), 1/4 of the RGBA32 footprint.
+	// Atlases with colored content keep using RGBA32: io.Fonts->TexPixelsUseColors, or custom rects, which the application
+	// fills after the build with no way for us to tell whether it used colors.
+	// Building resets TexPixelsUseColors, so the atlas is built (with the default font if none was added) before reading it.
+	ImGuiIO& io = ImGui::GetIO();
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	if (!io.Fonts->IsBuilt())
+		io.Fonts->Build();
+	const bool use_colors = io.Fonts->TexPixelsUseColors || ImGui_ImplGcm_AtlasHasUserCustomRects(io.Fonts);
+	const int bytes_per_pixel = use_colors ? 4 : 1;
+	unsigned char* pixels;
+	int width, height;
+	if (use_colors)
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	else
+		io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+
+	// Upload texture to local memory
+	CellGcmTexture* tex = &bd->FontTexture;
+	void* tex_data = ImGui_ImplGcm_AllocLocal(width * height * bytes_per_pixel, &tex->offset);
+	if (tex_data == NULL)
+		return false;
+
+	// Swizzled textures sample with much better cache locality, but need power of two dimensions (see ImFontAtlasFlags_NoPowerOfTwoHeight)
+	const bool swizzle = bd->FontTextureSwizzle && ImIsPowerOfTwo(width) && ImIsPowerOfTwo(height);
+	const uint8_t layout = swizzle ? CELL_GCM_TEXTURE_SZ : CELL_GCM_TEXTURE_LN;
+	if (swizzle)
+		ImGui_ImplGcm_SwizzleTexture(tex_data, pixels, width, height, bytes_per_pixel);
+	else
+		memcpy(tex_data, pixels, width * height * bytes_per_pixel);
+
+	if (use_colors)
+	{
+		// IM_COL32() is stored as A,B,G,R bytes on the big-endian PPU: swap the red and blue channels back when sampling.
+		tex->format = CELL_GCM_TEXTURE_A8R8G8B8 | layout | CELL_GCM_TEXTURE_NR;
+		tex->remap = CELL_GCM_TEXTURE_REMAP_REMAP << 14 | CELL_GCM_TEXTURE_REMAP_REMAP << 12 | CELL_GCM_TEXTURE_REMAP_REMAP << 10 | CELL_GCM_TEXTURE_REMAP_REMAP << 8 |
+			CELL_GCM_TEXTURE_REMAP_FROM_R << 6 | CELL_GCM_TEXTURE_REMAP_FROM_G << 4 | CELL_GCM_TEXTURE_REMAP_FROM_B << 2 | CELL_GCM_TEXTURE_REMAP_FROM_A;
+	}
+	else
+	{
+		// B8 lands in the blue channel: broadcast it to all four so the alpha fragment program can read it from .a
+		tex->format = CELL_GCM_TEXTURE_B8 | layout | CELL_GCM_TEXTURE_NR;
+		tex->remap = CELL_GCM_TEXTURE_REMAP_REMAP << 14 | CELL_GCM_TEXTURE_REMAP_REMAP << 12 | CELL_GCM_TEXTURE_REMAP_REMAP << 10 | CELL_GCM_TEXTURE_REMAP_REMAP << 8 |
+			CELL_GCM_TEXTURE_REMAP_FROM_B << 6 | CELL_GCM_TEXTURE_REMAP_FROM_B << 4 | CELL_GCM_TEXTURE_REMAP_FROM_B << 2 | CELL_GCM_TEXTURE_REMAP_FROM_B;
+	}
+	tex->mipmap = 1;
+	tex->dimension = CELL_GCM_TEXTURE_DIMENSION_2;
+	tex->cubemap = CELL_GCM_FALSE;
+	tex->width = (uint16_t)width;
+	tex->height = (uint16_t)height;
+	tex->depth = 1;
+	tex->location = CELL_GCM_LOCATION_LOCAL;
+	tex->pitch = swizzle ? 0 : width * bytes_per_pixel;
+
+	// Store our identifier
+	io.Fonts->SetTexID((ImTextureID)tex);
 
-}
\ No newline at end of file
+	return true;
+}
+
+// Use if you want to reset your rendering device without losing ImGui state.
+void ImGui_ImplGcm_DestroyDeviceObjects()
+{
+	ImGui_ImplGcm_InvalidateDeviceObjects();
+	ImGui_ImplGcm_DestroyShaders();
+}
+
+void ImGui_ImplGcm_InvalidateDeviceObjects()
+{
+	ImGuiIO& io = ImGui::GetIO();
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	if (!bd->DeviceObjectsCreated)
+		return;
+
+	// All device objects live in the caller's local memory block: forgetting about them is enough, once the RSX stopped reading them.
+	ImGui_ImplGcm_WaitIdle(bd);
+	if (bd->VtxArena)
+	{
+		// The label restarts from 0 with the next ring
+		ImGui_ImplGcm_VtxArenaReclaim(bd->VtxArena, true);
+		bd->VtxArena->LastFence = 0;
+	}
+	io.Fonts->SetTexID(NULL);
+	memset(&bd->FontTexture, 0, sizeof(bd->FontTexture));
+	memset(&bd->StreamRing, 0, sizeof(bd->StreamRing));
+	bd->LocalMemoryUsed = bd->ShadersMemorySize;
+	bd->DeviceObjectsCreated = false;
+}
+
+bool ImGui_ImplGcm_CreateDeviceObjects()
+{
+	ImGui_ImplGcm_Data* bd = ImGui_ImplGcm_GetBackendData();
+	if (bd->DeviceObjectsCreated)
+		ImGui_ImplGcm_InvalidateDeviceObjects();
+
+	if (!ImGui_ImplGcm_CreateShaders())
+		return false;
+	if (!ImGui_ImplGcm_CreateFontsTexture())
+	{
+		bd->LocalMemoryUsed = bd->ShadersMemorySize;
+		return false;
+	}
+
+	// Whatever is left of the local memory block is used for vertices and indices
+	uint32_t stream_start = (bd->LocalMemoryUsed + IMGUI_IMPL_GCM_ALIGNMENT - 1) & ~(IMGUI_IMPL_GCM_ALIGNMENT - 1);
+	if (stream_start >= bd->LocalMemorySize)
+	{
+		bd->LocalMemoryUsed = bd->ShadersMemorySize;
+		return false;
+	}
+	uint32_t stream_size = bd->LocalMemorySize - stream_start;
+	uint32_t stream_offset;
+	uint8_t* stream_data = (uint8_t*)ImGui_ImplGcm_AllocLocal(stream_size, &stream_offset);
+	ImGui_ImplGcm_StreamRingInit(&bd->StreamRing, stream_data, stream_offset, stream_size, cellGcmGetLabelAddress(bd->LabelIndex));
+	bd->DeviceObjectsCreated = true;
+
+	return true;
+}
@@ -1,11 +1,42 @@
 #include "../imgui.h"      // IMGUI_IMPL_API
 
-IMGUI_API bool        ImGui_ImplGcm_Init();
+struct CellGcmContextData;
+
+// ImTextureID is a pointer to a CellGcmTexture living in RSX local memory.
+// The font atlas is uploaded as a single channel texture (CELL_GCM_TEXTURE_B8), or as A8R8G8B8 when io.Fonts->TexPixelsUseColors is set
+// or the atlas has custom rects (AddCustomRectRegular(), AddCustomRectFontGlyph()): fill those through GetTexDataAsRGBA32().
+
+// Counters gathered by the last call to ImGui_ImplGcm_RenderDrawData().
+struct ImGui_ImplGcm_FrameStats
+{
+    unsigned int    DrawCalls;          // cellGcmSetDrawIndexArray() calls emitted
+    unsigned int    StateChanges;       // Texture, scissor and vertex array binds emitted (redundant ones are skipped)
+    unsigned int    CommandBytes;       // Bytes written into the command buffer
+    unsigned int    UploadBytes;        // Vertex + index bytes copied into local memory
+    unsigned int    ZeroCopyBytes;      // Vertex bytes read by the RSX straight from the draw lists (see ImGui_ImplGcm_SetVertexArena)
+    unsigned int    RingWaits;          // Times the PPU had to wait for the RSX to release a region of the vertex/index ring
+    unsigned int    VtxArenaWaits;      // Times the PPU had to wait for the RSX to release vertex arena blocks while building this frame
+};
+
+// local_memory: block of RSX local memory owned by the backend (fragment program ucode, font texture, vertex/index ring). Must be 128 bytes aligned.
+// label_index: RSX label (64..255) reserved for the backend, used to know when the RSX is done with a frame's vertices.
+IMGUI_API bool        ImGui_ImplGcm_Init(void* local_memory, unsigned int local_memory_size, unsigned char label_index = 255);
 IMGUI_API void        ImGui_ImplGcm_Shutdown();
 IMGUI_API void        ImGui_ImplGcm_NewFrame();
-IMGUI_API void        ImGui_ImplGcm_RenderDrawData(ImDrawData* draw_data);
+IMGUI_API void        ImGui_ImplGcm_RenderDrawData(ImDrawData* draw_data, CellGcmContextData* context = NULL);  // NULL: gCellGcmCurrentContext
+IMGUI_API void        ImGui_ImplGcm_GetFrameStats(ImGui_ImplGcm_FrameStats* out_stats);
+
+// Store the font atlas in the RSX swizzled layout instead of a linear one, for better texture cache hits. Off by default.
+// Applies the next time device objects are created. Atlases with a non power of two height stay linear.
+IMGUI_API void        ImGui_ImplGcm_SetFontTextureSwizzle(bool swizzle);
+
+// Zero-copy vertices (optional): ImDrawList::VtxBuffer storage gets allocated from this block of main memory, which the RSX then reads in place.
+// The block must already be mapped with cellGcmMapMainMemory() and outlive the Dear ImGui context. Lists that don't fit fall back to the heap and get copied as usual.
+// Draw lists move to a fresh block every frame and blocks are reused once the label shows the RSX is done with them, so the PPU never waits on
+// the previous frame: size the block for IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT + 1 frames of vertices. A smaller one waits for the oldest frame in flight.
+IMGUI_API bool        ImGui_ImplGcm_SetVertexArena(void* io_memory, unsigned int io_memory_size);
 
 // Use if you want to reset your rendering device without losing ImGui state.
 IMGUI_API void        ImGui_ImplGcm_DestroyDeviceObjects();
 IMGUI_API void        ImGui_ImplGcm_InvalidateDeviceObjects();
-IMGUI_API bool        ImGui_ImplGcm_CreateDeviceObjects();
\ No newline at end of file
+IMGUI_API bool        ImGui_ImplGcm_CreateDeviceObjects();
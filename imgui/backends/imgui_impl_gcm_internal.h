@@ -0,0 +1,154 @@
+// dear imgui: Renderer Backend for PlayStation 3 GCM, internals that don't depend on the PS3 SDK
+// Vertex/index ring bookkeeping and texture swizzling, shared by imgui_impl_gcm.cpp and the host-side tests in tests/.
+// Not part of the backend API: only include it from those.
+
+#pragma once
+#include "../imgui.h"
+#include "../imgui_internal.h"      // ImIsPowerOfTwo()
+#include <stdint.h>
+#include <string.h>
+
+#define IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT 3     // Frames the PPU may run ahead of the RSX before RenderDrawData() waits on the label
+
+// Region of the stream ring written by one frame, released once the RSX back end wrote Fence into the label.
+struct ImGui_ImplGcm_StreamFrame
+{
+	uint32_t                Fence;
+	uint32_t                Begin;
+	uint32_t                End;
+};
+
+// Persistent vertex/index ring in local memory. Frames are allocated back to back and wrap around to the start;
+// reusing a region waits for the RSX to have passed the label written after the frame that used it, instead of cellGcmFinish().
+// Label can point to any memory, the ring logic itself never touches the command buffer.
+struct ImGui_ImplGcm_StreamRing
+{
+	uint8_t*                    Data;
+	uint32_t                    Offset;                 // RSX offset of Data
+	uint32_t                    Size;
+	uint32_t                    Head;                   // Next write position
+	volatile uint32_t*          Label;
+	uint32_t                    LastFence;
+	ImGui_ImplGcm_StreamFrame   InFlight[IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT];
+	int                         InFlightFirst;
+	int                         InFlightCount;
+};
+
+// Called by ImGui_ImplGcm_StreamRingAlloc() when it needs the RSX to pass 'fence', returns once ImGui_ImplGcm_StreamRingFencePassed() is true.
+typedef void (*ImGui_ImplGcm_StreamRingWaitFunc)(const ImGui_ImplGcm_StreamRing* ring, uint32_t fence, void* user_data);
+
+static inline void ImGui_ImplGcm_StreamRingInit(ImGui_ImplGcm_StreamRing* ring, uint8_t* data, uint32_t offset, uint32_t size, volatile uint32_t* label)
+{
+	memset(ring, 0, sizeof(*ring));
+	ring->Data = data;
+	ring->Offset = offset;
+	ring->Size = size;
+	ring->Label = label;
+	*ring->Label = 0;
+}
+
+static inline bool ImGui_ImplGcm_StreamRingFencePassed(const ImGui_ImplGcm_StreamRing* ring, uint32_t fence)
+{
+	return (int32_t)(*ring->Label - fence) >= 0; // Wrap-around safe
+}
+
+static inline bool ImGui_ImplGcm_StreamRingOverlaps(const ImGui_ImplGcm_StreamRing* ring, uint32_t begin, uint32_t end)
+{
+	for (int n = 0; n < ring->InFlightCount; n++)
+	{
+		const ImGui_ImplGcm_StreamFrame& frame = ring->InFlight[(ring->InFlightFirst + n) % IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT];
+		if (begin < frame.End && frame.Begin < end)
+			return true;
+	}
+	return false;
+}
+
+// Reserve 'size' bytes for this frame. Returns the offset of the region inside the ring, or (uint32_t)-1 if it can never fit.
+// Retires frames the RSX is done with, and waits on the label for the oldest one when it is still using the space we need
+// (or when IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT frames are already queued) through 'wait_func'. 'out_waits' is incremented for every wait.
+static inline uint32_t ImGui_ImplGcm_StreamRingAlloc(ImGui_ImplGcm_StreamRing* ring, uint32_t size, ImGui_ImplGcm_StreamRingWaitFunc wait_func, void* wait_user_data, unsigned int* out_waits)
+{
+	if (size > ring->Size)
+		return (uint32_t)-1;
+	uint32_t begin = (ring->Head + size <= ring->Size) ? ring->Head : 0;
+
+	while (ring->InFlightCount > 0)
+	{
+		const ImGui_ImplGcm_StreamFrame& oldest = ring->InFlight[ring->InFlightFirst];
+		if (!ImGui_ImplGcm_StreamRingFencePassed(ring, oldest.Fence))
+		{
+			if (ring->InFlightCount < IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT && !ImGui_ImplGcm_StreamRingOverlaps(ring, begin, begin + size))
+				break;
+			(*out_waits)++;
+			wait_func(ring, oldest.Fence, wait_user_data);
+		}
+		ring->InFlightFirst = (ring->InFlightFirst + 1) % IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT;
+		ring->InFlightCount--;
+	}
+
+	ring->Head = begin + size;
+	return begin;
+}
+
+// Close the frame allocated by the last ImGui_ImplGcm_StreamRingAlloc() call. The caller writes the returned value into the label once the RSX is done with the region.
+static inline uint32_t ImGui_ImplGcm_StreamRingSubmit(ImGui_ImplGcm_StreamRing* ring, uint32_t begin, uint32_t end)
+{
+	IM_ASSERT(ring->InFlightCount < IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT);
+	ImGui_ImplGcm_StreamFrame& frame = ring->InFlight[(ring->InFlightFirst + ring->InFlightCount) % IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT];
+	frame.Fence = ++ring->LastFence;
+	frame.Begin = begin;
+	frame.End = end;
+	ring->InFlightCount++;
+	return frame.Fence;
+}
+
+// Spread the bits of 'v' over the set bits of 'mask', lowest first.
+static inline uint32_t ImGui_ImplGcm_DepositBits(uint32_t v, uint32_t mask)
+{
+	uint32_t r = 0;
+	for (uint32_t bit = 1; mask != 0 && v != 0; bit <<= 1)
+		if (mask & bit)
+		{
+			if (v & 1)
+				r |= bit;
+			v >>= 1;
+			mask &= ~bit;
+		}
+	return r;
+}
+
+// Copy a linear texture into the RSX swizzled layout. Width and height must be powers of two.
+// The RSX interleaves x and y bits (x first) while both have some left, the remaining bits of the larger dimension go on top.
+// Rather than computing the address of every texel we walk a row by incrementing x within its bit mask: (x | ~mask) + 1 carries over the y bits.
+static inline void ImGui_ImplGcm_SwizzleTexture(void* dst, const void* src, int width, int height, int bytes_per_pixel)
+{
+	IM_ASSERT(ImIsPowerOfTwo(width) && ImIsPowerOfTwo(height));
+	uint32_t mask_x = 0, mask_y = 0;
+	uint32_t bit = 1;
+	for (int w = width, h = height; w > 1 || h > 1; w >>= 1, h >>= 1)
+	{
+		if (w > 1) { mask_x |= bit; bit <<= 1; }
+		if (h > 1) { mask_y |= bit; bit <<= 1; }
+	}
+
+	for (int y = 0; y < height; y++)
+	{
+		const uint32_t offset_y = ImGui_ImplGcm_DepositBits((uint32_t)y, mask_y);
+		uint32_t offset_x = 0;
+		if (bytes_per_pixel == 4)
+		{
+			const uint32_t* src_row = (const uint32_t*)src + y * width;
+			uint32_t* dst_pixels = (uint32_t*)dst;
+			for (int x = 0; x < width; x++, offset_x = ((offset_x | ~mask_x) + 1) & mask_x)
+				dst_pixels[offset_y | offset_x] = src_row[x];
+		}
+		else
+		{
+			IM_ASSERT(bytes_per_pixel == 1);
+			const uint8_t* src_row = (const uint8_t*)src + y * width;
+			uint8_t* dst_pixels = (uint8_t*)dst;
+			for (int x = 0; x < width; x++, offset_x = ((offset_x | ~mask_x) + 1) & mask_x)
+				dst_pixels[offset_y | offset_x] = src_row[x];
+		}
+	}
+}
@@ -1,6 +1,14 @@
 
 #include "../imgui.h"
+#include "../imgui_internal.h"     // IM_STATIC_ASSERT
 #include "imgui_impl_playstation3.h"
+#include "imgui_impl_playstation3_internal.h"  // Clock conversion, pad translation, sample queue
+#include <cell/pad.h>
+#include <sys/ppu_thread.h>
+#include <sys/timer.h>
+#include <sys/sys_time.h>
+#include <sysutil/sysutil_common.h>
+#include <sysutil/sysutil_sysparam.h>
 
 
 // check for proper cursor handling
@@ -11,12 +19,38 @@
 static void ImGui_ImplPlaystation3_InitPlatformInterface();
 static void ImGui_ImplPlaystation3_ShutdownPlatformInterface();
 
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_MAX_PADS == CELL_PAD_MAX_PORT_NUM);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_SELECT == CELL_PAD_CTRL_SELECT && IMGUI_IMPL_PLAYSTATION3_PAD_L3 == CELL_PAD_CTRL_L3);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_R3 == CELL_PAD_CTRL_R3 && IMGUI_IMPL_PLAYSTATION3_PAD_START == CELL_PAD_CTRL_START);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_UP == CELL_PAD_CTRL_UP && IMGUI_IMPL_PLAYSTATION3_PAD_RIGHT == CELL_PAD_CTRL_RIGHT);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_DOWN == CELL_PAD_CTRL_DOWN && IMGUI_IMPL_PLAYSTATION3_PAD_LEFT == CELL_PAD_CTRL_LEFT);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_L2 == CELL_PAD_CTRL_L2 && IMGUI_IMPL_PLAYSTATION3_PAD_R2 == CELL_PAD_CTRL_R2);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_L1 == CELL_PAD_CTRL_L1 && IMGUI_IMPL_PLAYSTATION3_PAD_R1 == CELL_PAD_CTRL_R1);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_TRIANGLE == CELL_PAD_CTRL_TRIANGLE && IMGUI_IMPL_PLAYSTATION3_PAD_CIRCLE == CELL_PAD_CTRL_CIRCLE);
+IM_STATIC_ASSERT(IMGUI_IMPL_PLAYSTATION3_PAD_CROSS == CELL_PAD_CTRL_CROSS && IMGUI_IMPL_PLAYSTATION3_PAD_SQUARE == CELL_PAD_CTRL_SQUARE);
+
 struct ImGui_ImplPlaystation3_Data
 {
+   ImGui_ImplPlaystation3_ClockFunc ClockFunc;
+   void*                       ClockUserData;
+   ImU64                       TicksPerSecond;
+   ImU64                       Time;
+   ImVec2                      DisplaySize;                // Resolution of the active video mode, queried again after WantUpdateDisplaySize
+   bool                        WantUpdateDisplaySize;
    bool                        HasGamepad;
    bool                        WantUpdateHasGamepad;
-
-   ImGui_ImplPlaystation3_Data() { memset(this, 0, sizeof(*this)); }
+   ImGui_ImplPlaystation3_ReadPadFunc ReadPadFunc;
+   void*                       ReadPadUserData;
+   ImGui_ImplPlaystation3_PadState Pads[IMGUI_IMPL_PLAYSTATION3_MAX_PADS];   // Last state read by the default source: cellPadGetData() only reports changes
+   float                       GamepadValues[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS];  // Last value pushed for each ImGuiKey_Gamepad* key
+
+   sys_ppu_thread_t            InputThread;
+   bool                        InputThreadRunning;
+   volatile bool               InputThreadQuit;
+   unsigned int                InputThreadIntervalUs;
+   ImGui_ImplPlaystation3_PadQueue InputQueue;
+
+   ImGui_ImplPlaystation3_Data() { memset((void*)this, 0, sizeof(*this)); }
 };
 
 // Backend data stored in io.BackendPlatformUserData to allow support for multiple Dear ImGui contexts
@@ -43,7 +77,10 @@ bool ImGui_ImplPlaystation3_Init()
    io.BackendFlags |= ImGuiBackendFlags_PlatformHasViewports;    // We can create multi-viewports on the Platform side (optional)
    io.BackendFlags |= ImGuiBackendFlags_HasMouseHoveredViewport; // We can call io.AddMouseViewportEvent() with correct data (optional)
 
+   bd->WantUpdateDisplaySize = true;
    bd->WantUpdateHasGamepad = true;
+   ImGui_ImplPlaystation3_SetClock(NULL, 0, NULL);
+   ImGui_ImplPlaystation3_SetPadSource(NULL, NULL);
 
    return true;
 }
@@ -55,12 +92,46 @@ void ImGui_ImplPlaystation3_Shutdown()
    ImGuiIO& io = ImGui::GetIO();
 
    ImGui_ImplPlaystation3_ShutdownPlatformInterface();
+   ImGui_ImplPlaystation3_StopInputThread();
 
    io.BackendPlatformName = NULL;
    io.BackendPlatformUserData = NULL;
    IM_DELETE(bd);
 }
 
+static ImU64 ImGui_ImplPlaystation3_ReadTimeBase(void*)
+{
+   return __mftb();
+}
+
+void ImGui_ImplPlaystation3_SetClock(ImGui_ImplPlaystation3_ClockFunc clock_func, ImU64 ticks_per_second, void* user_data)
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   IM_ASSERT(bd != NULL && "Did you call ImGui_ImplPlaystation3_Init()?");
+   IM_ASSERT(clock_func == NULL || ticks_per_second > 0);
+   bd->ClockFunc = clock_func ? clock_func : ImGui_ImplPlaystation3_ReadTimeBase;
+   bd->ClockUserData = clock_func ? user_data : NULL;
+   bd->TicksPerSecond = clock_func ? ticks_per_second : sys_time_get_timebase_frequency();
+   bd->Time = bd->ClockFunc(bd->ClockUserData);
+}
+
+static void ImGui_ImplPlaystation3_UpdateDisplaySize()
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   bd->WantUpdateDisplaySize = false;
+
+   // Keep the previous size (1920x1080 at first) if the video output can't be queried
+   if (bd->DisplaySize.x <= 0.0f)
+      bd->DisplaySize = ImVec2(1920, 1080);
+   CellVideoOutState state;
+   CellVideoOutResolution resolution;
+   if (cellVideoOutGetState(CELL_VIDEO_OUT_PRIMARY, 0, &state) != CELL_OK)
+      return;
+   if (cellVideoOutGetResolution(state.displayMode.resolutionId, &resolution) != CELL_OK)
+      return;
+   bd->DisplaySize = ImVec2((float)resolution.width, (float)resolution.height);
+}
+
 // This code supports multi-viewports (multiple OS Windows mapped into different Dear ImGui viewports)
 // Because of that, it is a little more complicated than your typical single-viewport binding code!
 static void ImGui_ImplPlaystation3_UpdateMouseData()
@@ -68,50 +139,147 @@ static void ImGui_ImplPlaystation3_UpdateMouseData()
 
 }
 
+// user_data is our backend data: with the input thread this runs outside of the Dear ImGui context.
+static bool ImGui_ImplPlaystation3_ReadCellPad(unsigned int port, ImGui_ImplPlaystation3_PadState* out_state, void* user_data)
+{
+   ImGui_ImplPlaystation3_Data* bd = (ImGui_ImplPlaystation3_Data*)user_data;
+   ImGui_ImplPlaystation3_PadState& pad = bd->Pads[port];
+   CellPadData data;
+   if (cellPadGetData(port, &data) != CELL_PAD_OK)
+   {
+      memset(&pad, 0, sizeof(pad));
+      return false;
+   }
+
+   // len == 0: nothing changed since the last read
+   if (data.len > CELL_PAD_BTN_OFFSET_ANALOG_LEFT_Y)
+   {
+      pad.Digital1 = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_DIGITAL1];
+      pad.Digital2 = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_DIGITAL2];
+      pad.RightX = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_ANALOG_RIGHT_X];
+      pad.RightY = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_ANALOG_RIGHT_Y];
+      pad.LeftX = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_ANALOG_LEFT_X];
+      pad.LeftY = (unsigned char)data.button[CELL_PAD_BTN_OFFSET_ANALOG_LEFT_Y];
+   }
+   *out_state = pad;
+   return true;
+}
+
+void ImGui_ImplPlaystation3_SetPadSource(ImGui_ImplPlaystation3_ReadPadFunc read_pad_func, void* user_data)
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   IM_ASSERT(bd != NULL && "Did you call ImGui_ImplPlaystation3_Init()?");
+   IM_ASSERT(!bd->InputThreadRunning && "Stop the input thread before changing the pad source");
+   bd->ReadPadFunc = read_pad_func ? read_pad_func : ImGui_ImplPlaystation3_ReadCellPad;
+   bd->ReadPadUserData = read_pad_func ? user_data : bd;
+   bd->WantUpdateHasGamepad = true;
+}
+
+// Only queue an event when the value differs from what we pushed last, to keep io's input queue short.
+static void ImGui_ImplPlaystation3_UpdateGamepadKey(ImGuiKey key, float value)
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   float& last_value = bd->GamepadValues[key - ImGuiKey_GamepadStart];
+   if (last_value == value)
+      return;
+   last_value = value;
+   ImGui::GetIO().AddKeyAnalogEvent(key, value > 0.0f, value);
+}
+
+static void ImGui_ImplPlaystation3_PollPads(ImGui_ImplPlaystation3_Data* bd, ImGui_ImplPlaystation3_PadSample* out_sample)
+{
+   memset(out_sample, 0, sizeof(*out_sample));
+   for (unsigned int port = 0; port < IMGUI_IMPL_PLAYSTATION3_MAX_PADS; port++)
+      if (bd->ReadPadFunc(port, &out_sample->Pads[port], bd->ReadPadUserData))
+         out_sample->ConnectedMask |= (unsigned char)(1 << port);
+}
+
+static void ImGui_ImplPlaystation3_InputThreadMain(uint64_t arg)
+{
+   ImGui_ImplPlaystation3_Data* bd = (ImGui_ImplPlaystation3_Data*)(uintptr_t)arg;
+   ImGui_ImplPlaystation3_PadSample last_sample;
+   memset(&last_sample, 0, sizeof(last_sample));
+   while (!bd->InputThreadQuit)
+   {
+      // Only queue samples that differ from the last one queued. When the queue is full the sample is dropped,
+      // the next poll will still differ from last_sample and catch up.
+      ImGui_ImplPlaystation3_PadSample sample;
+      ImGui_ImplPlaystation3_PollPads(bd, &sample);
+      if (memcmp(&sample, &last_sample, sizeof(sample)) != 0 && ImGui_ImplPlaystation3_PadQueuePush(&bd->InputQueue, sample))
+         last_sample = sample;
+      sys_timer_usleep(bd->InputThreadIntervalUs);
+   }
+   sys_ppu_thread_exit(0);
+}
+
+bool ImGui_ImplPlaystation3_StartInputThread(int priority, unsigned int frequency)
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   IM_ASSERT(bd != NULL && "Did you call ImGui_ImplPlaystation3_Init()?");
+   IM_ASSERT(frequency > 0);
+   if (bd->InputThreadRunning)
+      return true;
+
+   bd->InputQueue.Head = bd->InputQueue.Tail = 0;
+   bd->InputThreadQuit = false;
+   bd->InputThreadIntervalUs = 1000000 / frequency;
+   if (sys_ppu_thread_create(&bd->InputThread, ImGui_ImplPlaystation3_InputThreadMain, (uint64_t)(uintptr_t)bd, priority, 0x4000, SYS_PPU_THREAD_CREATE_JOINABLE, "imgui_input") != CELL_OK)
+      return false;
+   bd->InputThreadRunning = true;
+   return true;
+}
+
+void ImGui_ImplPlaystation3_StopInputThread()
+{
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   if (bd == NULL || !bd->InputThreadRunning)
+      return;
+   bd->InputThreadQuit = true;
+   uint64_t exit_code;
+   sys_ppu_thread_join(bd->InputThread, &exit_code);
+   bd->InputThreadRunning = false;
+}
+
 // Gamepad navigation mapping
+static void ImGui_ImplPlaystation3_ApplyPadSample(const ImGui_ImplPlaystation3_PadSample& sample)
+{
+   ImGuiIO& io = ImGui::GetIO();
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+
+   float values[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS];
+   const bool has_gamepad = ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+   bd->HasGamepad = has_gamepad;
+   bd->WantUpdateHasGamepad = false;
+   io.BackendFlags &= ~ImGuiBackendFlags_HasGamepad;
+   if (bd->HasGamepad)
+      io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
+
+   for (int n = 0; n < IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS; n++)
+      ImGui_ImplPlaystation3_UpdateGamepadKey((ImGuiKey)(ImGuiKey_GamepadStart + n), values[n]);
+}
+
 static void ImGui_ImplPlaystation3_UpdateGamepads()
 {
    ImGuiIO& io = ImGui::GetIO();
    ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
-   if ((io.ConfigFlags & ImGuiConfigFlags_NavEnableGamepad) == 0)
-      return;
+   const bool nav_enabled = (io.ConfigFlags & ImGuiConfigFlags_NavEnableGamepad) != 0;
 
-   // Calling XInputGetState() every frame on disconnected gamepads is unfortunately too slow.
-   // Instead we refresh gamepad availability by calling XInputGetCapabilities() _only_ after receiving WM_DEVICECHANGE.
-   if (bd->WantUpdateHasGamepad)
+   // With the input thread, replay every sample it queued since last frame, in order: short presses aren't lost to a long frame.
+   if (bd->InputThreadRunning)
    {
-      bd->HasGamepad = true;
-      bd->WantUpdateHasGamepad = false;
+      // At most a queue's worth, the thread may keep pushing while we drain.
+      ImGui_ImplPlaystation3_PadSample sample;
+      for (int n = 0; n < IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE && ImGui_ImplPlaystation3_PadQueuePop(&bd->InputQueue, &sample); n++)
+         if (nav_enabled)
+            ImGui_ImplPlaystation3_ApplyPadSample(sample);
+      return;
    }
 
-   io.BackendFlags &= ~ImGuiBackendFlags_HasGamepad;
-   io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
-
-   /*io.AddKeyEvent(ImGuiKey_GamepadStart, XINPUT_GAMEPAD_START);
-   io.AddKeyEvent(ImGuiKey_GamepadBack, XINPUT_GAMEPAD_BACK);
-   io.AddKeyEvent(ImGuiKey_GamepadFaceDown, XINPUT_GAMEPAD_A);
-   io.AddKeyEvent(ImGuiKey_GamepadFaceRight, XINPUT_GAMEPAD_B);
-   io.AddKeyEvent(ImGuiKey_GamepadFaceLeft, XINPUT_GAMEPAD_X);
-   io.AddKeyEvent(ImGuiKey_GamepadFaceUp, XINPUT_GAMEPAD_Y);
-   io.AddKeyEvent(ImGuiKey_GamepadDpadLeft, XINPUT_GAMEPAD_DPAD_LEFT);
-   io.AddKeyEvent(ImGuiKey_GamepadDpadRight, XINPUT_GAMEPAD_DPAD_RIGHT);
-   io.AddKeyEvent(ImGuiKey_GamepadDpadUp, XINPUT_GAMEPAD_DPAD_UP);
-   io.AddKeyEvent(ImGuiKey_GamepadDpadDown, XINPUT_GAMEPAD_DPAD_DOWN);
-   io.AddKeyEvent(ImGuiKey_GamepadL1, XINPUT_GAMEPAD_LEFT_SHOULDER);
-   io.AddKeyEvent(ImGuiKey_GamepadR1, XINPUT_GAMEPAD_RIGHT_SHOULDER);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadL2, gamepad.bLeftTrigger, XINPUT_GAMEPAD_TRIGGER_THRESHOLD, 255);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadR2, gamepad.bRightTrigger, XINPUT_GAMEPAD_TRIGGER_THRESHOLD, 255);
-   io.AddKeyEvent(ImGuiKey_GamepadL3, XINPUT_GAMEPAD_LEFT_THUMB);
-   io.AddKeyEvent(ImGuiKey_GamepadR3, XINPUT_GAMEPAD_RIGHT_THUMB);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadLStickLeft, gamepad.sThumbLX, -XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, -32768);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadLStickRight, gamepad.sThumbLX, +XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, +32767);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadLStickUp, gamepad.sThumbLY, +XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, +32767);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadLStickDown, gamepad.sThumbLY, -XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, -32768);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadRStickLeft, gamepad.sThumbRX, -XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, -32768);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadRStickRight, gamepad.sThumbRX, +XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, +32767);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadRStickUp, gamepad.sThumbRY, +XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, +32767);
-   io.AddKeyAnalogEvent(ImGuiKey_GamepadRStickDown, gamepad.sThumbRY, -XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE, -32768);
-   */
+   if (!nav_enabled)
+      return;
+   ImGui_ImplPlaystation3_PadSample sample;
+   ImGui_ImplPlaystation3_PollPads(bd, &sample);
+   ImGui_ImplPlaystation3_ApplyPadSample(sample);
 }
 
 void ImGui_ImplPlaystation3_NewFrame()
@@ -120,10 +288,15 @@ void ImGui_ImplPlaystation3_NewFrame()
    ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
    IM_ASSERT(bd != NULL && "Did you call ImGui_ImplPlaystation3_Init()?");
 
-   // Setup display size (every frame to accommodate for window resizing)
-   io.DisplaySize = ImVec2(1920, 1080);
+   // Setup display size. The video mode is only queried again after a sysutil event (see ImGui_ImplPlaystation3_HandleEvent)
+   if (bd->WantUpdateDisplaySize)
+      ImGui_ImplPlaystation3_UpdateDisplaySize();
+   io.DisplaySize = bd->DisplaySize;
 
    // Setup time step
+   const ImU64 current_time = bd->ClockFunc(bd->ClockUserData);
+   io.DeltaTime = ImGui_ImplPlaystation3_TicksToSeconds(bd->Time, current_time, bd->TicksPerSecond);
+   bd->Time = current_time;
 
    // Update OS mouse position
    ImGui_ImplPlaystation3_UpdateMouseData();
@@ -132,10 +305,20 @@ void ImGui_ImplPlaystation3_NewFrame()
    ImGui_ImplPlaystation3_UpdateGamepads();
 }
 
-bool ImGui_ImplPlaystation3_HandleEvent()
+bool ImGui_ImplPlaystation3_HandleEvent(ImU64 status, ImU64 param)
 {
+   IM_UNUSED(param);
+   ImGui_ImplPlaystation3_Data* bd = ImGui_ImplPlaystation3_GetBackendData();
+   if (bd == NULL)
+      return false;
 
-   return true;
+   // Display settings can only be changed from the system menu
+   if (status == CELL_SYSUTIL_SYSTEM_MENU_CLOSE)
+   {
+      bd->WantUpdateDisplaySize = true;
+      return true;
+   }
+   return false;
 }
 
 static void ImGui_ImplPlaystation3_InitPlatformInterface()
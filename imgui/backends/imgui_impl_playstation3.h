@@ -4,4 +4,29 @@
 IMGUI_IMPL_API bool     ImGui_ImplPlaystation3_Init();
 IMGUI_IMPL_API void     ImGui_ImplPlaystation3_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplPlaystation3_NewFrame();
-IMGUI_IMPL_API bool     ImGui_ImplPlaystation3_HandleEvent();
\ No newline at end of file
+IMGUI_IMPL_API bool     ImGui_ImplPlaystation3_HandleEvent(ImU64 status, ImU64 param);   // Forward your cellSysutilRegisterCallback() callback here. Returns true if the backend used the event.
+
+// Clock used for io.DeltaTime. Defaults to the PPU time base register, replace it e.g. to run the game's own time scale.
+typedef ImU64 (*ImGui_ImplPlaystation3_ClockFunc)(void* user_data);
+IMGUI_IMPL_API void     ImGui_ImplPlaystation3_SetClock(ImGui_ImplPlaystation3_ClockFunc clock_func, ImU64 ticks_per_second, void* user_data);  // NULL: restore the default clock
+
+// State of one controller, in cellPad terms.
+struct ImGui_ImplPlaystation3_PadState
+{
+   unsigned char           Digital1;           // CELL_PAD_CTRL_LEFT/DOWN/RIGHT/UP/START/R3/L3/SELECT bits (button[CELL_PAD_BTN_OFFSET_DIGITAL1])
+   unsigned char           Digital2;           // CELL_PAD_CTRL_SQUARE/CROSS/CIRCLE/TRIANGLE/R1/L1/R2/L2 bits (button[CELL_PAD_BTN_OFFSET_DIGITAL2])
+   unsigned char           LeftX, LeftY;       // 0..255, 0x80 is centered
+   unsigned char           RightX, RightY;
+};
+
+// Source of pad states, polled for every port by ImGui_ImplPlaystation3_NewFrame() when gamepad navigation is enabled.
+// Return false when nothing is connected on 'port'. The default one reads cellPadGetData() (the application calls cellPadInit()), a port counts as connected while it returns CELL_PAD_OK.
+// Replace it when something else owns the pads, e.g. a PRX forwarding what the game read from a cellPadGetData() hook: a second reader would miss changes.
+typedef bool (*ImGui_ImplPlaystation3_ReadPadFunc)(unsigned int port, ImGui_ImplPlaystation3_PadState* out_state, void* user_data);
+IMGUI_IMPL_API void     ImGui_ImplPlaystation3_SetPadSource(ImGui_ImplPlaystation3_ReadPadFunc read_pad_func, void* user_data);   // NULL: restore the default source
+
+// Optional: poll pads from a dedicated PPU thread at 'frequency' Hz instead of once per ImGui_ImplPlaystation3_NewFrame().
+// Samples are queued and replayed in order by the next NewFrame(), so presses shorter than a frame still register.
+// The pad source is then called from that thread.
+IMGUI_IMPL_API bool     ImGui_ImplPlaystation3_StartInputThread(int priority = 1000, unsigned int frequency = 120);
+IMGUI_IMPL_API void     ImGui_ImplPlaystation3_StopInputThread();
\ No newline at end of file
@@ -0,0 +1,154 @@
+// dear imgui: Platform Backend for PlayStation 3, internals that don't depend on the PS3 SDK
+// Clock conversion, pad state translation and the input thread's sample queue, shared by imgui_impl_playstation3.cpp and the host-side tests in tests/.
+// Not part of the backend API: only include it from those.
+
+#pragma once
+#include "../imgui.h"
+#include "../imgui_internal.h"     // ImMin, ImMax
+#include "imgui_impl_playstation3.h"
+#include <stdint.h>
+
+// Orders the queue's sample data against its index updates. The host-side tests run the queue on std::thread.
+#if defined(__PPU__)
+#include <ppu_intrinsics.h>        // __lwsync
+#define IMGUI_IMPL_PLAYSTATION3_LWSYNC()        __lwsync()
+#else
+#include <atomic>
+#define IMGUI_IMPL_PLAYSTATION3_LWSYNC()        std::atomic_thread_fence(std::memory_order_seq_cst)
+#endif
+
+#define IMGUI_IMPL_PLAYSTATION3_MAX_PADS        7     // CELL_PAD_MAX_PORT_NUM
+#define IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE  40    // Out of 128, sticks rarely rest exactly on 0x80
+#define IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS    (ImGuiKey_GamepadRStickDown - ImGuiKey_GamepadStart + 1)
+#define IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE     64    // Pad samples the input thread may queue between two NewFrame(), power of two
+
+// Seconds between two readings of a clock running at 'ticks_per_second', for io.DeltaTime.
+// The difference is taken in ticks first: the time base is far past what a float, or a double divided early, resolves to a tick.
+// A clock that didn't move forward (replaced clock starting over, same reading twice) counts as a 60 Hz frame, io.DeltaTime must be positive.
+static inline float ImGui_ImplPlaystation3_TicksToSeconds(ImU64 previous, ImU64 current, ImU64 ticks_per_second)
+{
+   return (current > previous) ? (float)((double)(current - previous) / (double)ticks_per_second) : (1.0f / 60.0f);
+}
+
+// cellPad button bits, as <cell/pad.h> defines CELL_PAD_CTRL_*. imgui_impl_playstation3.cpp checks them against it.
+#define IMGUI_IMPL_PLAYSTATION3_PAD_SELECT      (1 << 0)    // Digital1
+#define IMGUI_IMPL_PLAYSTATION3_PAD_L3          (1 << 1)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_R3          (1 << 2)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_START       (1 << 3)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_UP          (1 << 4)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_RIGHT       (1 << 5)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_DOWN        (1 << 6)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_LEFT        (1 << 7)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_L2          (1 << 0)    // Digital2
+#define IMGUI_IMPL_PLAYSTATION3_PAD_R2          (1 << 1)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_L1          (1 << 2)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_R1          (1 << 3)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_TRIANGLE    (1 << 4)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_CIRCLE      (1 << 5)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_CROSS       (1 << 6)
+#define IMGUI_IMPL_PLAYSTATION3_PAD_SQUARE      (1 << 7)
+
+// State of every port at one point in time.
+struct ImGui_ImplPlaystation3_PadSample
+{
+   unsigned char                   ConnectedMask;      // Bit n: port n has a pad
+   ImGui_ImplPlaystation3_PadState Pads[IMGUI_IMPL_PLAYSTATION3_MAX_PADS];
+};
+
+// Single producer (input thread) / single consumer (NewFrame) ring of pad samples.
+// Each side only writes its own index, IMGUI_IMPL_PLAYSTATION3_LWSYNC() orders the sample data against the index update.
+struct ImGui_ImplPlaystation3_PadQueue
+{
+   ImGui_ImplPlaystation3_PadSample Samples[IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE];
+   volatile uint32_t               Head;               // Written by the producer
+   volatile uint32_t               Tail;               // Written by the consumer
+};
+
+// Producer side. Returns false when the queue is full: the sample is dropped.
+static inline bool ImGui_ImplPlaystation3_PadQueuePush(ImGui_ImplPlaystation3_PadQueue* queue, const ImGui_ImplPlaystation3_PadSample& sample)
+{
+   const uint32_t head = queue->Head;
+   if (head - queue->Tail >= IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE)
+      return false;
+   queue->Samples[head & (IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE - 1)] = sample;
+   IMGUI_IMPL_PLAYSTATION3_LWSYNC();
+   queue->Head = head + 1;
+   return true;
+}
+
+// Consumer side. Returns false when the queue is empty.
+static inline bool ImGui_ImplPlaystation3_PadQueuePop(ImGui_ImplPlaystation3_PadQueue* queue, ImGui_ImplPlaystation3_PadSample* out_sample)
+{
+   const uint32_t tail = queue->Tail;
+   if (tail == queue->Head)
+      return false;
+   IMGUI_IMPL_PLAYSTATION3_LWSYNC();
+   *out_sample = queue->Samples[tail & (IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE - 1)];
+   IMGUI_IMPL_PLAYSTATION3_LWSYNC();
+   queue->Tail = tail + 1;
+   return true;
+}
+
+// Map a stick axis (0..255) to 0.0f..1.0f along one direction, past the dead-zone.
+static inline float ImGui_ImplPlaystation3_StickValue(int axis, int direction)
+{
+   const int v = (axis - 0x80) * direction;
+   if (v <= IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE)
+      return 0.0f;
+   return ImMin((float)(v - IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE) / (float)(127 - IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE), 1.0f);
+}
+
+// Value of every ImGuiKey_Gamepad* key for a sample, indexed from ImGuiKey_GamepadStart. Returns false when no pad is connected.
+// All connected pads drive navigation: buttons are merged, each stick direction takes the largest deflection.
+static inline bool ImGui_ImplPlaystation3_TranslatePadSample(const ImGui_ImplPlaystation3_PadSample& sample, float out_values[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS])
+{
+   ImGui_ImplPlaystation3_PadState merged = {};
+   float left_stick[4] = {}, right_stick[4] = {};    // Left, Right, Up, Down
+   for (unsigned int port = 0; port < IMGUI_IMPL_PLAYSTATION3_MAX_PADS; port++)
+   {
+      if ((sample.ConnectedMask & (1 << port)) == 0)
+         continue;
+      const ImGui_ImplPlaystation3_PadState& pad = sample.Pads[port];
+      merged.Digital1 |= pad.Digital1;
+      merged.Digital2 |= pad.Digital2;
+      left_stick[0] = ImMax(left_stick[0], ImGui_ImplPlaystation3_StickValue(pad.LeftX, -1));
+      left_stick[1] = ImMax(left_stick[1], ImGui_ImplPlaystation3_StickValue(pad.LeftX, +1));
+      left_stick[2] = ImMax(left_stick[2], ImGui_ImplPlaystation3_StickValue(pad.LeftY, -1));
+      left_stick[3] = ImMax(left_stick[3], ImGui_ImplPlaystation3_StickValue(pad.LeftY, +1));
+      right_stick[0] = ImMax(right_stick[0], ImGui_ImplPlaystation3_StickValue(pad.RightX, -1));
+      right_stick[1] = ImMax(right_stick[1], ImGui_ImplPlaystation3_StickValue(pad.RightX, +1));
+      right_stick[2] = ImMax(right_stick[2], ImGui_ImplPlaystation3_StickValue(pad.RightY, -1));
+      right_stick[3] = ImMax(right_stick[3], ImGui_ImplPlaystation3_StickValue(pad.RightY, +1));
+   }
+
+   #define MAP_BUTTON(KEY_NO, DIGITAL, BUTTON)  { out_values[KEY_NO - ImGuiKey_GamepadStart] = (merged.DIGITAL & (BUTTON)) ? 1.0f : 0.0f; }
+   #define MAP_ANALOG(KEY_NO, VALUE)            { out_values[KEY_NO - ImGuiKey_GamepadStart] = VALUE; }
+   MAP_BUTTON(ImGuiKey_GamepadStart,           Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_START);
+   MAP_BUTTON(ImGuiKey_GamepadBack,            Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_SELECT);
+   MAP_BUTTON(ImGuiKey_GamepadFaceDown,        Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_CROSS);
+   MAP_BUTTON(ImGuiKey_GamepadFaceRight,       Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_CIRCLE);
+   MAP_BUTTON(ImGuiKey_GamepadFaceLeft,        Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_SQUARE);
+   MAP_BUTTON(ImGuiKey_GamepadFaceUp,          Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_TRIANGLE);
+   MAP_BUTTON(ImGuiKey_GamepadDpadLeft,        Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_LEFT);
+   MAP_BUTTON(ImGuiKey_GamepadDpadRight,       Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_RIGHT);
+   MAP_BUTTON(ImGuiKey_GamepadDpadUp,          Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_UP);
+   MAP_BUTTON(ImGuiKey_GamepadDpadDown,        Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_DOWN);
+   MAP_BUTTON(ImGuiKey_GamepadL1,              Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_L1);
+   MAP_BUTTON(ImGuiKey_GamepadR1,              Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_R1);
+   MAP_BUTTON(ImGuiKey_GamepadL2,              Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_L2);
+   MAP_BUTTON(ImGuiKey_GamepadR2,              Digital2, IMGUI_IMPL_PLAYSTATION3_PAD_R2);
+   MAP_BUTTON(ImGuiKey_GamepadL3,              Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_L3);
+   MAP_BUTTON(ImGuiKey_GamepadR3,              Digital1, IMGUI_IMPL_PLAYSTATION3_PAD_R3);
+   MAP_ANALOG(ImGuiKey_GamepadLStickLeft,      left_stick[0]);
+   MAP_ANALOG(ImGuiKey_GamepadLStickRight,     left_stick[1]);
+   MAP_ANALOG(ImGuiKey_GamepadLStickUp,        left_stick[2]);
+   MAP_ANALOG(ImGuiKey_GamepadLStickDown,      left_stick[3]);
+   MAP_ANALOG(ImGuiKey_GamepadRStickLeft,      right_stick[0]);
+   MAP_ANALOG(ImGuiKey_GamepadRStickRight,     right_stick[1]);
+   MAP_ANALOG(ImGuiKey_GamepadRStickUp,        right_stick[2]);
+   MAP_ANALOG(ImGuiKey_GamepadRStickDown,      right_stick[3]);
+   #undef MAP_BUTTON
+   #undef MAP_ANALOG
+
+   return sample.ConnectedMask != 0;
+}
@@ -1,11 +1,29 @@
 
 #include "../imgui.h"
 #include "imgui_impl_psgl.h"
+#include "imgui_impl_psgl_internal.h"  // State filter
 #include <PSGL/psgl.h>
 
+// Capabilities and client states toggled by the backend, tracked by the state filter (one bit each)
+static const GLenum g_CachedCapabilities[] = { GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST, GL_LIGHTING, GL_COLOR_MATERIAL, GL_SCISSOR_TEST, GL_TEXTURE_2D };
+static const GLenum g_CachedClientStates[] = { GL_VERTEX_ARRAY, GL_TEXTURE_COORD_ARRAY, GL_COLOR_ARRAY, GL_NORMAL_ARRAY };
+
+// GL calls behind the state filter
+static void ImGui_ImplPSGL_GLSetCapability(GLenum cap, bool enable)         { if (enable) glEnable(cap); else glDisable(cap); }
+static void ImGui_ImplPSGL_GLSetClientState(GLenum array, bool enable)      { if (enable) glEnableClientState(array); else glDisableClientState(array); }
+static void ImGui_ImplPSGL_GLBindTexture(GLuint texture)                    { glBindTexture(GL_TEXTURE_2D, texture); }
+static void ImGui_ImplPSGL_GLScissor(GLint x, GLint y, GLint w, GLint h)    { glScissor(x, y, (GLsizei)w, (GLsizei)h); }
+static const ImGui_ImplPSGL_StateFuncs g_StateFuncs = { ImGui_ImplPSGL_GLSetCapability, ImGui_ImplPSGL_GLSetClientState, ImGui_ImplPSGL_GLBindTexture, ImGui_ImplPSGL_GLScissor };
+
 struct ImGui_ImplPSGL_Data
 {
 	GLuint       FontTexture;
+	GLuint       VboHandle;
+	GLuint       ElementsHandle;
+	GLsizeiptr   VertexBufferSize;
+	GLsizeiptr   IndexBufferSize;
+	ImGui_ImplPSGL_StateFilter StateFilter;     // Skips redundant state changes
+	ImGui_ImplPSGL_FrameStats FrameStats;
 
 	ImGui_ImplPSGL_Data() { memset(this, 0, sizeof(*this)); }
 };
@@ -31,6 +49,7 @@ bool ImGui_ImplPSGL_Init()
 	io.BackendRendererUserData = (void*)bd;
 	io.BackendRendererName = "imgui_impl_psgl";
 	io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;    // We can create multi-viewports on the Renderer side (optional)
+	ImGui_ImplPSGL_StateFilterInit(&bd->StateFilter, &g_StateFuncs, g_CachedCapabilities, IM_ARRAYSIZE(g_CachedCapabilities), g_CachedClientStates, IM_ARRAYSIZE(g_CachedClientStates));
 
 	if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		ImGui_ImplPSGL_InitPlatformInterface();
@@ -60,23 +79,61 @@ void ImGui_ImplPSGL_NewFrame()
 		ImGui_ImplPSGL_CreateDeviceObjects();
 }
 
+void ImGui_ImplPSGL_GetFrameStats(ImGui_ImplPSGL_FrameStats* out_stats)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	IM_ASSERT(bd != NULL && "Did you call ImGui_ImplPSGL_Init()?");
+	*out_stats = bd->FrameStats;
+}
+
+static void ImGui_ImplPSGL_InvalidateStateCache()
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	ImGui_ImplPSGL_StateFilterInvalidate(&bd->StateFilter);
+}
+
+static void ImGui_ImplPSGL_SetCapability(GLenum cap, bool enable)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	ImGui_ImplPSGL_StateFilterSetCapability(&bd->StateFilter, cap, enable, &bd->FrameStats);
+}
+
+static void ImGui_ImplPSGL_SetClientState(GLenum array, bool enable)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	ImGui_ImplPSGL_StateFilterSetClientState(&bd->StateFilter, array, enable, &bd->FrameStats);
+}
+
+static void ImGui_ImplPSGL_BindTexture(GLuint texture)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	ImGui_ImplPSGL_StateFilterBindTexture(&bd->StateFilter, texture, &bd->FrameStats);
+}
+
+static void ImGui_ImplPSGL_SetScissor(GLint x, GLint y, GLint w, GLint h)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	ImGui_ImplPSGL_StateFilterSetScissor(&bd->StateFilter, x, y, w, h, &bd->FrameStats);
+}
+
 static void ImGui_ImplPSGL_SetupRenderState(ImDrawData* draw_data, int fb_width, int fb_height)
 {
 	// Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor enabled, vertex/texcoord/color pointers, polygon fill.
-	glEnable(GL_BLEND);
+	// Toggles go through the state cache: when nothing touched GL since the last setup (e.g. ImDrawCallback_ResetRenderState) they are skipped.
+	ImGui_ImplPSGL_SetCapability(GL_BLEND, true);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	//glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA); // In order to composite our output buffer we need to preserve alpha
-	glDisable(GL_CULL_FACE);
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_STENCIL_TEST);
-	glDisable(GL_LIGHTING);
-	glDisable(GL_COLOR_MATERIAL);
-	glEnable(GL_SCISSOR_TEST);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glEnableClientState(GL_COLOR_ARRAY);
-	glDisableClientState(GL_NORMAL_ARRAY);
-	glEnable(GL_TEXTURE_2D);
+	ImGui_ImplPSGL_SetCapability(GL_CULL_FACE, false);
+	ImGui_ImplPSGL_SetCapability(GL_DEPTH_TEST, false);
+	ImGui_ImplPSGL_SetCapability(GL_STENCIL_TEST, false);
+	ImGui_ImplPSGL_SetCapability(GL_LIGHTING, false);
+	ImGui_ImplPSGL_SetCapability(GL_COLOR_MATERIAL, false);
+	ImGui_ImplPSGL_SetCapability(GL_SCISSOR_TEST, true);
+	ImGui_ImplPSGL_SetClientState(GL_VERTEX_ARRAY, true);
+	ImGui_ImplPSGL_SetClientState(GL_TEXTURE_COORD_ARRAY, true);
+	ImGui_ImplPSGL_SetClientState(GL_COLOR_ARRAY, true);
+	ImGui_ImplPSGL_SetClientState(GL_NORMAL_ARRAY, false);
+	ImGui_ImplPSGL_SetCapability(GL_TEXTURE_2D, true);
 	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 	glShadeModel(GL_SMOOTH);
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
@@ -104,6 +161,55 @@ static void ImGui_ImplPSGL_SetupRenderState(ImDrawData* draw_data, int fb_width,
 	glLoadIdentity();
 }
 
+// Source vertices and indices from our streaming buffers, pointers starting at the current list (vtx_buffer_offset bytes into the vertex buffer).
+// Called for each list and again after each callback, which may have bound its own buffers or pointers.
+static void ImGui_ImplPSGL_SetupVertexPointers(intptr_t vtx_buffer_offset)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle);
+	glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)(vtx_buffer_offset + IM_OFFSETOF(ImDrawVert, pos)));
+	glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)(vtx_buffer_offset + IM_OFFSETOF(ImDrawVert, uv)));
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), (const GLvoid*)(vtx_buffer_offset + IM_OFFSETOF(ImDrawVert, col)));
+}
+
+// Orphan the streaming buffers (growing them if needed) and upload every draw list into them, one copy per list.
+// Returns false if the buffers could not be allocated.
+static bool ImGui_ImplPSGL_UploadDrawData(ImDrawData* draw_data)
+{
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	const GLsizeiptr vtx_size = (GLsizeiptr)draw_data->TotalVtxCount * (GLsizeiptr)sizeof(ImDrawVert);
+	const GLsizeiptr idx_size = (GLsizeiptr)draw_data->TotalIdxCount * (GLsizeiptr)sizeof(ImDrawIdx);
+	if (bd->VboHandle == 0 || bd->ElementsHandle == 0)
+		return false;
+
+	// Re-specifying the whole store lets the driver hand us fresh memory instead of waiting for the RSX to be done with last frame's data
+	glBindBuffer(GL_ARRAY_BUFFER, bd->VboHandle);
+	if (vtx_size > bd->VertexBufferSize)
+		bd->VertexBufferSize = vtx_size + 5000 * (GLsizeiptr)sizeof(ImDrawVert);
+	glBufferData(GL_ARRAY_BUFFER, bd->VertexBufferSize, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, bd->ElementsHandle);
+	if (idx_size > bd->IndexBufferSize)
+		bd->IndexBufferSize = idx_size + 10000 * (GLsizeiptr)sizeof(ImDrawIdx);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, bd->IndexBufferSize, NULL, GL_STREAM_DRAW);
+
+	GLintptr vtx_offset = 0;
+	GLintptr idx_offset = 0;
+	for (int n = 0; n < draw_data->CmdListsCount; n++)
+	{
+		const ImDrawList* cmd_list = draw_data->CmdLists[n];
+		const GLsizeiptr list_vtx_size = (GLsizeiptr)cmd_list->VtxBuffer.Size * (GLsizeiptr)sizeof(ImDrawVert);
+		const GLsizeiptr list_idx_size = (GLsizeiptr)cmd_list->IdxBuffer.Size * (GLsizeiptr)sizeof(ImDrawIdx);
+		glBufferSubData(GL_ARRAY_BUFFER, vtx_offset, list_vtx_size, cmd_list->VtxBuffer.Data);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, idx_offset, list_idx_size, cmd_list->IdxBuffer.Data);
+		vtx_offset += list_vtx_size;
+		idx_offset += list_idx_size;
+		bd->FrameStats.Uploads += 2;
+	}
+	bd->FrameStats.UploadBytes += (unsigned int)(vtx_offset + idx_offset);
+	return true;
+}
+
 void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 {
 	// Avoid rendering when minimized, scale coordinates for retina displays (screen coordinates != framebuffer coordinates)
@@ -112,6 +218,11 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 	if (fb_width == 0 || fb_height == 0)
 		return;
 
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	memset(&bd->FrameStats, 0, sizeof(bd->FrameStats));
+	if (draw_data->TotalVtxCount == 0 || !ImGui_ImplPSGL_UploadDrawData(draw_data))
+		return;
+
 	// Backup GL state
 	GLuint last_texture;
 	glGenTextures(GL_TEXTURE5, &last_texture);
@@ -122,7 +233,8 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
-	// Setup desired GL state
+	// Setup desired GL state. We don't know what the application left bound since last frame.
+	ImGui_ImplPSGL_InvalidateStateCache();
 	ImGui_ImplPSGL_SetupRenderState(draw_data, fb_width, fb_height);
 
 	// Will project scissor/clipping rectangles into framebuffer space
@@ -130,14 +242,13 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 	ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are often (2,2)
 
 	// Render command lists
+	// Pointers are offsets into the streaming buffers, where each list was uploaded back to back.
+	intptr_t vtx_buffer_offset = 0;
+	intptr_t idx_buffer_offset = 0;
 	for (int n = 0; n < draw_data->CmdListsCount; n++)
 	{
 		const ImDrawList* cmd_list = draw_data->CmdLists[n];
-		const ImDrawVert* vtx_buffer = cmd_list->VtxBuffer.Data;
-		const ImDrawIdx* idx_buffer = cmd_list->IdxBuffer.Data;
-		glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, pos)));
-		glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, uv)));
-		glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert), (const GLvoid*)((const char*)vtx_buffer + IM_OFFSETOF(ImDrawVert, col)));
+		ImGui_ImplPSGL_SetupVertexPointers(vtx_buffer_offset);
 
 		for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++)
 		{
@@ -149,7 +260,11 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 				if (pcmd->UserCallback == ImDrawCallback_ResetRenderState)
 					ImGui_ImplPSGL_SetupRenderState(draw_data, fb_width, fb_height);
 				else
+				{
 					pcmd->UserCallback(cmd_list, pcmd);
+					ImGui_ImplPSGL_InvalidateStateCache();
+				}
+				ImGui_ImplPSGL_SetupVertexPointers(vtx_buffer_offset);
 			}
 			else
 			{
@@ -160,16 +275,21 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 					continue;
 
 				// Apply scissor/clipping rectangle (Y is inverted in OpenGL)
-				glScissor((int)clip_min.x, (int)(fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y));
+				ImGui_ImplPSGL_SetScissor((int)clip_min.x, (int)(fb_height - clip_max.y), (int)(clip_max.x - clip_min.x), (int)(clip_max.y - clip_min.y));
 
 				// Bind texture, Draw
-				glBindTexture(GL_TEXTURE_2D, (GLuint)(intptr_t)pcmd->GetTexID());
-				glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer + pcmd->IdxOffset);
+				ImGui_ImplPSGL_BindTexture((GLuint)(intptr_t)pcmd->GetTexID());
+				glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount, sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, (const GLvoid*)(idx_buffer_offset + pcmd->IdxOffset * sizeof(ImDrawIdx)));
+				bd->FrameStats.DrawCalls++;
 			}
 		}
+		vtx_buffer_offset += cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+		idx_buffer_offset += cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
 	}
 
 	// Restore modified GL state
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	glDisableClientState(GL_COLOR_ARRAY);
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 	glDisableClientState(GL_VERTEX_ARRAY);
@@ -186,6 +306,15 @@ void ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data)
 	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
 }
 
+// Custom rects besides Dear ImGui's own (mouse cursors, baked lines), added with AddCustomRectRegular()/AddCustomRectFontGlyph()
+static bool ImGui_ImplPSGL_AtlasHasUserCustomRects(const ImFontAtlas* atlas)
+{
+	for (int n = 0; n < atlas->CustomRects.Size; n++)
+		if (n != atlas->PackIdMouseCursors && n != atlas->PackIdLines)
+			return true;
+	return false;
+}
+
 bool ImGui_ImplOpenPSGL_CreateFontsTexture()
 {
 	// Build texture atlas
@@ -193,16 +322,29 @@ bool ImGui_ImplOpenPSGL_CreateFontsTexture()
 	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
 	unsigned char* pixels;
 	int width, height;
-	io.Fonts->AddFontDefault();
-	io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);   // Load as RGBA 32-bit (75% of the memory is wasted, but default font is so small) because it is more likely to be compatible with user's existing shaders. If your ImTextureId represent a higher-level concept than just a GL texture id, consider calling GetTexDataAsAlpha8() instead to save on GPU memory.
+
+	// Glyphs only need coverage: load as Alpha8, GL_MODULATE then yields (vertex.rgb, vertex.a * texel.a). 1/4 of the RGBA32 footprint.
+	// Atlases with colored content keep using RGBA32: io.Fonts->TexPixelsUseColors, or custom rects, which the application
+	// fills after the build with no way for us to tell whether it used colors.
+	// Building resets TexPixelsUseColors, so the atlas is built (with the default font if none was added) before reading it.
+	if (!io.Fonts->IsBuilt())
+		io.Fonts->Build();
+	const bool use_colors = io.Fonts->TexPixelsUseColors || ImGui_ImplPSGL_AtlasHasUserCustomRects(io.Fonts);
+	if (use_colors)
+		io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+	else
+		io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
 
 	// Upload texture to graphics system
 	glGenTextures(1, &bd->FontTexture);
 	glBindTexture(GL_TEXTURE_2D, bd->FontTexture);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 0);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	if (use_colors)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, pixels);
 
 	// Store our identifier
 	io.Fonts->SetTexID((ImTextureID)(intptr_t)bd->FontTexture);
@@ -227,11 +369,23 @@ void ImGui_ImplOpenPSGL_DestroyFontsTexture()
 
 bool ImGui_ImplPSGL_CreateDeviceObjects()
 {
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+
+	// Streaming vertex/index buffers, sized on first use
+	glGenBuffers(1, &bd->VboHandle);
+	glGenBuffers(1, &bd->ElementsHandle);
+	bd->VertexBufferSize = bd->IndexBufferSize = 0;
+
 	return ImGui_ImplOpenPSGL_CreateFontsTexture();
 }
 
 void    ImGui_ImplPSGL_DestroyDeviceObjects()
 {
+	ImGui_ImplPSGL_Data* bd = ImGui_ImplPSGL_GetBackendData();
+	if (bd->VboHandle)      { glDeleteBuffers(1, &bd->VboHandle); bd->VboHandle = 0; }
+	if (bd->ElementsHandle) { glDeleteBuffers(1, &bd->ElementsHandle); bd->ElementsHandle = 0; }
+	bd->VertexBufferSize = bd->IndexBufferSize = 0;
+
 	ImGui_ImplOpenPSGL_DestroyFontsTexture();
 }
 
@@ -1,10 +1,25 @@
 
 #include "../imgui.h"      // IMGUI_IMPL_API
 
+// The font atlas is uploaded as a GL_ALPHA texture, or as GL_RGBA when io.Fonts->TexPixelsUseColors is set
+// or the atlas has custom rects (AddCustomRectRegular(), AddCustomRectFontGlyph()): fill those through GetTexDataAsRGBA32().
+
+// Counters gathered by the last call to ImGui_ImplPSGL_RenderDrawData().
+struct ImGui_ImplPSGL_FrameStats
+{
+    unsigned int    DrawCalls;          // glDrawElements() calls issued
+    unsigned int    Uploads;            // glBufferSubData() calls issued (one vertex + one index upload per draw list)
+    unsigned int    UploadBytes;        // Vertex + index bytes handed to the driver
+    unsigned int    ElidedTextureBinds; // glBindTexture() calls skipped because the texture was already bound
+    unsigned int    ElidedScissors;     // glScissor() calls skipped because the rectangle didn't change
+    unsigned int    ElidedStateToggles; // glEnable()/glDisable()/gl{Enable,Disable}ClientState() calls skipped because the state was already set
+};
+
 IMGUI_API bool        ImGui_ImplPSGL_Init();
 IMGUI_API void        ImGui_ImplPSGL_Shutdown();
 IMGUI_API void        ImGui_ImplPSGL_NewFrame();
 IMGUI_API void        ImGui_ImplPSGL_RenderDrawData(ImDrawData* draw_data);
+IMGUI_API void        ImGui_ImplPSGL_GetFrameStats(ImGui_ImplPSGL_FrameStats* out_stats);
 //IMGUI_API bool        ImGui_ImplPSGL_ProcessEvent(SceCtrlData* pad);
 
 // Use if you want to reset your rendering device without losing ImGui state.
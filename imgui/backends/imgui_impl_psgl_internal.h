@@ -0,0 +1,114 @@
+// dear imgui: Renderer Backend for PlayStation 3 PSGL, internals that don't depend on the PS3 SDK
+// Redundant GL state filter, shared by imgui_impl_psgl.cpp and the host-side tests in tests/.
+// Not part of the backend API: only include it from those.
+
+#pragma once
+#include "imgui_impl_psgl.h"    // ImGui_ImplPSGL_FrameStats
+#include <string.h>
+
+// GL calls the state filter forwards to: PSGL in the backend, a recorder in the tests.
+// Types are spelled out as PSGL defines them (GLenum and GLuint are unsigned int, GLint is int).
+struct ImGui_ImplPSGL_StateFuncs
+{
+	void                (*SetCapability)(unsigned int cap, bool enable);        // glEnable() / glDisable()
+	void                (*SetClientState)(unsigned int array, bool enable);     // glEnableClientState() / glDisableClientState()
+	void                (*BindTexture)(unsigned int texture);                   // glBindTexture(GL_TEXTURE_2D, texture)
+	void                (*Scissor)(int x, int y, int w, int h);                 // glScissor()
+};
+
+// Shadow of the GL state last issued through Funcs, used to skip redundant calls.
+// Anything not flagged as known is unknown (start of frame, or after a user callback) and always gets issued.
+struct ImGui_ImplPSGL_StateFilter
+{
+	const ImGui_ImplPSGL_StateFuncs* Funcs;
+	const unsigned int* CapabilityList;         // Capabilities tracked, bit n of Capabilities is CapabilityList[n]
+	int                 CapabilityCount;
+	const unsigned int* ClientStateList;        // Client states tracked, bit n of ClientStates is ClientStateList[n]
+	int                 ClientStateCount;
+
+	unsigned int        Capabilities;
+	unsigned int        CapabilitiesKnown;
+	unsigned int        ClientStates;
+	unsigned int        ClientStatesKnown;
+	unsigned int        Texture;
+	int                 Scissor[4];
+	bool                TextureKnown;
+	bool                ScissorKnown;
+};
+
+static inline void ImGui_ImplPSGL_StateFilterInit(ImGui_ImplPSGL_StateFilter* filter, const ImGui_ImplPSGL_StateFuncs* funcs, const unsigned int* capabilities, int capability_count, const unsigned int* client_states, int client_state_count)
+{
+	IM_ASSERT(capability_count <= 32 && client_state_count <= 32);
+	memset(filter, 0, sizeof(*filter));
+	filter->Funcs = funcs;
+	filter->CapabilityList = capabilities;
+	filter->CapabilityCount = capability_count;
+	filter->ClientStateList = client_states;
+	filter->ClientStateCount = client_state_count;
+}
+
+// Forget everything: the next call of each kind gets issued.
+static inline void ImGui_ImplPSGL_StateFilterInvalidate(ImGui_ImplPSGL_StateFilter* filter)
+{
+	filter->CapabilitiesKnown = filter->ClientStatesKnown = 0;
+	filter->TextureKnown = filter->ScissorKnown = false;
+}
+
+static inline unsigned int ImGui_ImplPSGL_StateFilterBit(const unsigned int* list, int count, unsigned int value)
+{
+	int n = 0;
+	while (n < count && list[n] != value)
+		n++;
+	IM_ASSERT(n < count && "State not tracked by the filter");
+	return 1u << n;
+}
+
+static inline void ImGui_ImplPSGL_StateFilterSetCapability(ImGui_ImplPSGL_StateFilter* filter, unsigned int cap, bool enable, ImGui_ImplPSGL_FrameStats* stats)
+{
+	const unsigned int bit = ImGui_ImplPSGL_StateFilterBit(filter->CapabilityList, filter->CapabilityCount, cap);
+	if ((filter->CapabilitiesKnown & bit) && ((filter->Capabilities & bit) != 0) == enable)
+	{
+		stats->ElidedStateToggles++;
+		return;
+	}
+	filter->Funcs->SetCapability(cap, enable);
+	filter->Capabilities = enable ? (filter->Capabilities | bit) : (filter->Capabilities & ~bit);
+	filter->CapabilitiesKnown |= bit;
+}
+
+static inline void ImGui_ImplPSGL_StateFilterSetClientState(ImGui_ImplPSGL_StateFilter* filter, unsigned int array, bool enable, ImGui_ImplPSGL_FrameStats* stats)
+{
+	const unsigned int bit = ImGui_ImplPSGL_StateFilterBit(filter->ClientStateList, filter->ClientStateCount, array);
+	if ((filter->ClientStatesKnown & bit) && ((filter->ClientStates & bit) != 0) == enable)
+	{
+		stats->ElidedStateToggles++;
+		return;
+	}
+	filter->Funcs->SetClientState(array, enable);
+	filter->ClientStates = enable ? (filter->ClientStates | bit) : (filter->ClientStates & ~bit);
+	filter->ClientStatesKnown |= bit;
+}
+
+static inline void ImGui_ImplPSGL_StateFilterBindTexture(ImGui_ImplPSGL_StateFilter* filter, unsigned int texture, ImGui_ImplPSGL_FrameStats* stats)
+{
+	if (filter->TextureKnown && filter->Texture == texture)
+	{
+		stats->ElidedTextureBinds++;
+		return;
+	}
+	filter->Funcs->BindTexture(texture);
+	filter->Texture = texture;
+	filter->TextureKnown = true;
+}
+
+static inline void ImGui_ImplPSGL_StateFilterSetScissor(ImGui_ImplPSGL_StateFilter* filter, int x, int y, int w, int h, ImGui_ImplPSGL_FrameStats* stats)
+{
+	if (filter->ScissorKnown && filter->Scissor[0] == x && filter->Scissor[1] == y && filter->Scissor[2] == w && filter->Scissor[3] == h)
+	{
+		stats->ElidedScissors++;
+		return;
+	}
+	filter->Funcs->Scissor(x, y, w, h);
+	filter->Scissor[0] = x; filter->Scissor[1] = y; filter->Scissor[2] = w; filter->Scissor[3] = h;
+	filter->ScissorKnown = true;
+}
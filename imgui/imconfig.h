@@ -48,6 +48,8 @@
 //#define IMGUI_DISABLE_DEFAULT_FILE_FUNCTIONS              // Don't implement ImFileOpen/ImFileClose/ImFileRead/ImFileWrite and ImFileHandle so you can implement them yourself if you don't want to link with fopen/fclose/fread/fwrite. This will also disable the LogToTTY() function.
 //#define IMGUI_DISABLE_DEFAULT_ALLOCATORS                  // Don't implement default allocators calling malloc()/free() to avoid linking with them. You will need to call ImGui::SetAllocatorFunctions().
 //#define IMGUI_DISABLE_SSE                                 // Disable use of SSE intrinsics even if available
+//#define IMGUI_ENABLE_SIMD_TESSELLATION                    // Use SSE2/NEON kernels for the normals of AddPolyline()/AddConvexPolyFilled(). Output is identical to the scalar path.
+//#define IMGUI_TEXT_SIZE_CACHE_SETS 64                     // Number of sets of 4 entries in the CalcTextSize() cache (io.ConfigTextSizeCache), a power of two. Default 256.
 
 //---- Include imgui_user.h at the end of imgui.h as a convenience
 //#define IMGUI_INCLUDE_IMGUI_USER_H
@@ -1184,6 +1184,7 @@ ImGuiIO::ImGuiIO()
    ConfigWindowsResizeFromEdges = true;
    ConfigWindowsMoveFromTitleBarOnly = false;
    ConfigMemoryCompactTimer = 60.0f;
+   ConfigTextSizeCache = false;
 
    // Platform Functions
    BackendPlatformName = BackendRendererName = NULL;
@@ -3433,7 +3434,7 @@ void ImGui::GcAwakeTransientWindowBuffers(ImGuiWindow* window)
    // The other buffers tends to amortize much faster.
    window->MemoryCompacted = false;
    window->DrawList->IdxBuffer.reserve(window->MemoryDrawListIdxCapacity);
-   window->DrawList->VtxBuffer.reserve(window->MemoryDrawListVtxCapacity);
+   window->DrawList->_ReserveVtxBuffer(window->MemoryDrawListVtxCapacity);
    window->MemoryDrawListIdxCapacity = window->MemoryDrawListVtxCapacity = 0;
 }
 
@@ -4455,6 +4456,21 @@ void ImGui::NewFrame()
    g.DrawListSharedData.ClipRectFullscreen = virtual_space.ToVec4();
    g.DrawListSharedData.CurveTessellationTol = g.Style.CurveTessellationTol;
    g.DrawListSharedData.SetCircleTessellationMaxError(g.Style.CircleTessellationMaxError);
+   g.DrawListSharedData.ShapeCache.HitsLastFrame = g.DrawListSharedData.ShapeCache.Hits;
+   g.DrawListSharedData.ShapeCache.MissesLastFrame = g.DrawListSharedData.ShapeCache.Misses;
+   g.DrawListSharedData.ShapeCache.Hits = g.DrawListSharedData.ShapeCache.Misses = 0;
+   g.TextSizeCache.HitsLastFrame = g.TextSizeCache.Hits;
+   g.TextSizeCache.MissesLastFrame = g.TextSizeCache.Misses;
+   g.TextSizeCache.Hits = g.TextSizeCache.Misses = 0;
+   if (!g.IO.ConfigTextSizeCache && g.TextSizeCache.Entries.Size > 0)
+      g.TextSizeCache.Clear();
+   if (g.TextSizeCache.FontAtlas != g.IO.Fonts || g.TextSizeCache.FontAtlasBuildCount != g.IO.Fonts->BuildCount)
+   {
+      // Fonts were rebuilt since the sizes were measured
+      g.TextSizeCache.Clear();
+      g.TextSizeCache.FontAtlas = g.IO.Fonts;
+      g.TextSizeCache.FontAtlasBuildCount = g.IO.Fonts->BuildCount;
+   }
    g.DrawListSharedData.InitialFlags = ImDrawListFlags_None;
    if (g.Style.AntiAliasedLines)
       g.DrawListSharedData.InitialFlags |= ImDrawListFlags_AntiAliasedLines;
@@ -4736,6 +4752,7 @@ void ImGui::Shutdown(ImGuiContext* context)
    g.ClipboardHandlerData.clear();
    g.MenusIdSubmittedThisFrame.clear();
    g.InputTextState.ClearFreeMemory();
+   g.TextSizeCache.Clear();
 
    g.SettingsWindows.clear();
    g.SettingsHandlers.clear();
@@ -5189,6 +5206,57 @@ void ImGui::Render()
    CallContextHooks(&g, ImGuiContextHookType_RenderPost);
 }
 
+ImGuiTextSizeCacheEntry* ImGuiTextSizeCache::GetEntry(ImGuiID key, ImU32 check, int text_len, bool* out_hit)
+{
+   if (Entries.Size == 0)
+   {
+      Entries.resize(IMGUI_TEXT_SIZE_CACHE_SETS * IMGUI_TEXT_SIZE_CACHE_WAYS);
+      memset(Entries.Data, 0, (size_t)Entries.size_in_bytes());
+   }
+   Tick++;
+
+   ImGuiTextSizeCacheEntry* set = &Entries.Data[(key & (IMGUI_TEXT_SIZE_CACHE_SETS - 1)) * IMGUI_TEXT_SIZE_CACHE_WAYS];
+   ImGuiTextSizeCacheEntry* lru_entry = set;
+   for (int n = 0; n < IMGUI_TEXT_SIZE_CACHE_WAYS; n++)
+   {
+      ImGuiTextSizeCacheEntry* entry = &set[n];
+      if (entry->Key == key && entry->Check == check && entry->TextLen == text_len)
+      {
+         entry->LastUse = Tick;
+         Hits++;
+         *out_hit = true;
+         return entry;
+      }
+      if (entry->LastUse < lru_entry->LastUse)
+         lru_entry = entry;
+   }
+   lru_entry->Key = key;
+   lru_entry->Check = check;
+   lru_entry->TextLen = text_len;
+   lru_entry->LastUse = Tick;
+   Misses++;
+   *out_hit = false;
+   return lru_entry;
+}
+
+// Multiplicative hash for ImGuiTextSizeCacheEntry::Check, 4 bytes at a time. ImHashData() is a CRC32: reseeding it doesn't
+// make a second independent hash, two texts of the same length that collide keep colliding whatever the seed.
+static ImU32 TextSizeCacheCheckHash(const void* data, size_t data_size, ImU32 seed)
+{
+   const unsigned char* bytes = (const unsigned char*)data;
+   ImU32 hash = seed ^ (ImU32)data_size;
+   for (; data_size >= 4; data_size -= 4, bytes += 4)
+   {
+      ImU32 word;
+      memcpy(&word, bytes, 4);
+      hash = (hash ^ word) * 0x9E3779B1u;
+      hash ^= hash >> 15;
+   }
+   for (; data_size > 0; data_size--)
+      hash = (hash ^ *bytes++) * 0x9E3779B1u;
+   return hash ^ (hash >> 16);
+}
+
 // Calculate text size. Text can be multi-line. Optionally ignore text after a ## marker.
 // CalcTextSize("") should return ImVec2(0.0f, g.FontSize)
 ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_text_after_double_hash, float wrap_width)
@@ -5205,6 +5273,25 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
    const float font_size = g.FontSize;
    if (text == text_display_end)
       return ImVec2(0.0f, font_size);
+
+   // Look up the cache, keyed by a hash of the text seeded with everything else the size depends on
+   ImGuiTextSizeCacheEntry* cache_entry = NULL;
+   if (g.IO.ConfigTextSizeCache)
+   {
+      if (text_display_end == NULL)
+         text_display_end = text + strlen(text);
+      const int text_len = (int)(text_display_end - text);
+      const float key_sizes[3] = { font_size, wrap_width, font->FontSize };
+      ImGuiID key = ImHashData(text, (size_t)text_len, ImHashData(key_sizes, sizeof(key_sizes), ImHashData(&font, sizeof(font))));
+      if (key == 0)
+         key = 1;
+      const ImU32 check = TextSizeCacheCheckHash(text, (size_t)text_len, TextSizeCacheCheckHash(key_sizes, sizeof(key_sizes), TextSizeCacheCheckHash(&font, sizeof(font), 0)));
+      bool hit;
+      cache_entry = g.TextSizeCache.GetEntry(key, check, text_len, &hit);
+      if (hit)
+         return cache_entry->Size;
+   }
+
    ImVec2 text_size = font->CalcTextSizeA(font_size, FLT_MAX, wrap_width, text, text_display_end, NULL);
 
    // Round
@@ -5214,6 +5301,8 @@ ImVec2 ImGui::CalcTextSize(const char* text, const char* text_end, bool hide_tex
    // - https://embarkstudios.github.io/rust-gpu/api/src/libm/math/ceilf.rs.html
    text_size.x = IM_FLOOR(text_size.x + 0.99999f);
 
+   if (cache_entry)
+      cache_entry->Size = text_size;
    return text_size;
 }
 
@@ -18009,6 +18098,29 @@ void ImGui::ShowMetricsWindow(bool* p_open)
       Text("NavWindowingTarget: '%s'", g.NavWindowingTarget ? g.NavWindowingTarget->Name : "NULL");
       Unindent();
 
+      Text("DRAWING");
+      Indent();
+      const ImDrawShapeCache& shape_cache = g.DrawListSharedData.ShapeCache;
+      int shape_cache_used = 0;
+      for (int n = 0; n < IM_ARRAYSIZE(shape_cache.Shapes); n++)
+         shape_cache_used += (shape_cache.Shapes[n].Kind != ImDrawShapeKind_None) ? 1 : 0;
+      const unsigned int shape_cache_lookups = shape_cache.HitsLastFrame + shape_cache.MissesLastFrame;
+      Text("ShapeCache: %d/%d shapes, %u hits, %u misses (%.1f%% hit rate)", shape_cache_used, IM_ARRAYSIZE(shape_cache.Shapes), shape_cache.HitsLastFrame, shape_cache.MissesLastFrame, shape_cache_lookups ? shape_cache.HitsLastFrame * 100.0f / shape_cache_lookups : 0.0f);
+      const ImGuiTextSizeCache& text_size_cache = g.TextSizeCache;
+      if (g.IO.ConfigTextSizeCache)
+      {
+         int text_size_cache_used = 0;
+         for (int n = 0; n < text_size_cache.Entries.Size; n++)
+            text_size_cache_used += (text_size_cache.Entries[n].Key != 0) ? 1 : 0;
+         const ImU32 text_size_cache_lookups = text_size_cache.HitsLastFrame + text_size_cache.MissesLastFrame;
+         Text("TextSizeCache: %d/%d entries, %u hits, %u misses (%.1f%% hit rate)", text_size_cache_used, IMGUI_TEXT_SIZE_CACHE_SETS * IMGUI_TEXT_SIZE_CACHE_WAYS, text_size_cache.HitsLastFrame, text_size_cache.MissesLastFrame, text_size_cache_lookups ? text_size_cache.HitsLastFrame * 100.0f / text_size_cache_lookups : 0.0f);
+      }
+      else
+      {
+         Text("TextSizeCache: disabled (io.ConfigTextSizeCache)");
+      }
+      Unindent();
+
       TreePop();
    }
 
@@ -138,6 +138,7 @@ struct ImDrawCmd;                   // A single draw command within a parent ImD
 struct ImDrawData;                  // All draw command lists required to render the frame + pos/size coordinates to use for the projection matrix.
 struct ImDrawList;                  // A single draw command list (generally one per window, conceptually you may see this as a dynamic "mesh" builder)
 struct ImDrawListSharedData;        // Data shared among multiple draw lists (typically owned by parent ImGui context, but you may create one yourself)
+struct ImDrawVtxArena;              // Optional storage for ImDrawList vertex buffers (e.g. memory the GPU can read directly)
 struct ImDrawListSplitter;          // Helper to split a draw list into different layers which can be drawn into out of order, then flattened back.
 struct ImDrawVert;                  // A single vertex (pos + uv + col = 20 bytes by default. Override layout with IMGUI_OVERRIDE_DRAWVERT_STRUCT_LAYOUT)
 struct ImFont;                      // Runtime data for a single font within a parent ImFontAtlas
@@ -2024,6 +2025,7 @@ struct ImGuiIO
    bool        ConfigWindowsResizeFromEdges;   // = true           // Enable resizing of windows from their edges and from the lower-left corner. This requires (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors) because it needs mouse cursor feedback. (This used to be a per-window ImGuiWindowFlags_ResizeFromAnySide flag)
    bool        ConfigWindowsMoveFromTitleBarOnly; // = false       // Enable allowing to move windows only when clicking on their title bar. Does not apply to windows without a title bar.
    float       ConfigMemoryCompactTimer;       // = 60.0f          // Timer (in seconds) to free transient windows/tables memory buffers when unused. Set to -1.0f to disable.
+   bool        ConfigTextSizeCache;            // = false          // [BETA] Cache the results of CalcTextSize() (labels, wrapped text...) by font, size, wrap width and text hash, in a bounded LRU cache. Cleared when the font atlas is rebuilt, and when disabled: toggle it after modifying glyphs in place.
 
    //------------------------------------------------------------------
    // Platform Functions
@@ -2599,6 +2601,18 @@ enum ImDrawListFlags_
    ImDrawListFlags_AllowVtxOffset = 1 << 3   // Can emit 'VtxOffset > 0' to allow large meshes. Set when 'ImGuiBackendFlags_RendererHasVtxOffset' is enabled.
 };
 
+// [Opt-in] Storage for the vertex buffers of all ImDrawList sharing an ImDrawListSharedData (see ImDrawListSharedData::VtxArena).
+// Lets a renderer have draw lists write their vertices straight into memory the GPU can fetch from, instead of copying VtxBuffer every frame.
+// Every frame a list moves to a fresh block of the same capacity (FreeFunc on the previous one, then AllocFunc), so it never overwrites vertices
+// the GPU may still be reading: FreeFunc must not hand a block out again before the GPU is done with the frames that used it.
+// AllocFunc may return NULL when full, the list then falls back to the regular heap. The arena must outlive every draw list using it.
+struct ImDrawVtxArena
+{
+   void*       (*AllocFunc)(size_t sz, void* user_data);
+   void        (*FreeFunc)(void* ptr, void* user_data);
+   void*       UserData;
+};
+
 // Draw command list
 // This is the low-level list of polygons that ImGui:: functions are filling. At the end of the frame,
 // all command lists are passed to your ImGuiIO::RenderDrawListFn function for rendering.
@@ -2628,6 +2642,7 @@ struct ImDrawList
    ImDrawCmdHeader         _CmdHeader;         // [Internal] template of active commands. Fields should match those of CmdBuffer.back().
    ImDrawListSplitter      _Splitter;          // [Internal] for channels api (note: prefer using your own persistent instance of ImDrawListSplitter!)
    float                   _FringeScale;       // [Internal] anti-alias fringe is scaled by this value, this helps to keep things sharp while zooming at vertex buffer content
+   ImDrawVtxArena*         _VtxArena;          // [Internal] arena VtxBuffer.Data was allocated from, NULL when it comes from the heap
 
    // If you want to create ImDrawList instances, pass them ImGui::GetDrawListSharedData() or create and use your own ImDrawListSharedData (so you can use ImDrawList without ImGui)
    ImDrawList(const ImDrawListSharedData* shared_data) { memset(this, 0, sizeof(*this)); _Data = shared_data; }
@@ -2666,6 +2681,14 @@ struct ImDrawList
    IMGUI_API void  AddBezierCubic(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, ImU32 col, float thickness, int num_segments = 0); // Cubic Bezier (4 control points)
    IMGUI_API void  AddBezierQuadratic(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, ImU32 col, float thickness, int num_segments = 0);               // Quadratic Bezier (3 control points)
 
+   // Batched primitives
+   // - Draw 'count' primitives with one reservation, e.g. for scatter plots or per-cell backgrounds. Same output as calling AddRectFilled() (no rounding)/AddLine()/AddCircleFilled() for each.
+   // - Inputs are separate arrays indexed by primitive. 'cols' is optional: when NULL every primitive uses 'col'. Primitives with a transparent color are skipped.
+   // - AddCircleFilledBatch() draws circles of the same radius, tessellated once.
+   IMGUI_API void  AddRectFilledBatch(const ImVec2* p_min, const ImVec2* p_max, int count, ImU32 col, const ImU32* cols = NULL);
+   IMGUI_API void  AddLineBatch(const ImVec2* p1, const ImVec2* p2, int count, ImU32 col, float thickness = 1.0f, const ImU32* cols = NULL);
+   IMGUI_API void  AddCircleFilledBatch(const ImVec2* centers, int count, float radius, ImU32 col, const ImU32* cols = NULL, int num_segments = 0);
+
    // Image primitives
    // - Read FAQ to understand what ImTextureID is.
    // - "p_min" and "p_max" represent the upper-left and lower-right corners of the rectangle.
@@ -2721,6 +2744,8 @@ struct ImDrawList
     // [Internal helpers]
    IMGUI_API void  _ResetForNewFrame();
    IMGUI_API void  _ClearFreeMemory();
+   IMGUI_API void  _ReserveVtxBuffer(int new_capacity);
+   IMGUI_API void  _ClearFreeVtxBuffer();
    IMGUI_API void  _PopUnusedDrawCmd();
    IMGUI_API void  _TryMergeDrawCmds();
    IMGUI_API void  _OnChangedClipRect();
@@ -2796,6 +2821,13 @@ struct ImFontGlyph
    float           U0, V0, U1, V1;     // Texture coordinates
 };
 
+// Dense copy of the glyphs of code points 0..127 used by the ASCII fast path of ImFont::RenderText(). 32 bytes, two glyphs per cache line.
+struct ImFontGlyphAscii
+{
+   float           X0, Y0, X1, Y1;     // Glyph corners, all 0.0f for glyphs which aren't visible
+   float           U0, V0, U1, V1;     // Texture coordinates
+};
+
 // Helper to build glyph ranges from text/string data. Feed your application strings/characters to it then call BuildRanges().
 // This is essentially a tightly packed of vector of 64k booleans = 8KB storage.
 struct ImFontGlyphRangesBuilder
@@ -2936,6 +2968,7 @@ struct ImFontAtlas
    ImVector<ImFontAtlasCustomRect> CustomRects;    // Rectangles for packing custom texture data into the atlas.
    ImVector<ImFontConfig>      ConfigData;         // Configuration data
    ImVec4                      TexUvLines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];  // UVs for baked anti-aliased lines
+   int                         BuildCount;         // Incremented each time glyph metrics change (Build(), ImFont::AddRemapChar()), so caches of text sizes can tell fonts were rebuilt, possibly at the same addresses
 
    // [Internal] Font builder
    const ImFontBuilderIO* FontBuilderIO;      // Opaque interface to a font builder (default to stb_truetype, can be changed to use FreeType by defining IMGUI_ENABLE_FREETYPE).
@@ -2963,6 +2996,7 @@ struct ImFont
    ImVector<ImWchar>           IndexLookup;        // 12-16 // out //            // Sparse. Index glyphs by Unicode code-point.
    ImVector<ImFontGlyph>       Glyphs;             // 12-16 // out //            // All glyphs.
    const ImFontGlyph* FallbackGlyph;      // 4-8   // out // = FindGlyph(FontFallbackChar)
+   ImVector<ImFontGlyphAscii>  AsciiGlyphs;        // 12-16 // out //            // Dense. FindGlyph() for code points 0..127, advances are in IndexAdvanceX. Empty (no fast path) when one of them is colored.
 
    // Members: Cold ~32/40 bytes
    ImFontAtlas* ContainerAtlas;     // 4-8   // out //            // What we has been loaded into
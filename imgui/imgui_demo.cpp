@@ -522,6 +522,8 @@ void ImGui::ShowDemoWindow(bool* p_open)
          ImGui::Checkbox("io.ConfigWindowsResizeFromEdges", &io.ConfigWindowsResizeFromEdges);
          ImGui::SameLine(); HelpMarker("Enable resizing of windows from their edges and from the lower-left corner.\nThis requires (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors) because it needs mouse cursor feedback.");
          ImGui::Checkbox("io.ConfigWindowsMoveFromTitleBarOnly", &io.ConfigWindowsMoveFromTitleBarOnly);
+         ImGui::Checkbox("io.ConfigTextSizeCache", &io.ConfigTextSizeCache);
+         ImGui::SameLine(); HelpMarker("Cache the results of CalcTextSize() (labels, wrapped text...), see Metrics->Internal state for hit rates.");
          ImGui::Checkbox("io.MouseDrawCursor", &io.MouseDrawCursor);
          ImGui::SameLine(); HelpMarker("Instruct Dear ImGui to render a mouse cursor itself. Note that a mouse cursor rendered via your application GPU rendering path will feel more laggy than hardware cursor, but will be more in sync with your other visuals.\n\nSome desktop applications may use both kinds of cursors (e.g. enable software cursor only when resizing/dragging something).");
          ImGui::Text("Also see Style->Rendering for rendering options.");
@@ -6100,6 +6102,7 @@ void ImGui::ShowAboutWindow(bool* p_open)
       if (io.ConfigWindowsResizeFromEdges)                            ImGui::Text("io.ConfigWindowsResizeFromEdges");
       if (io.ConfigWindowsMoveFromTitleBarOnly)                       ImGui::Text("io.ConfigWindowsMoveFromTitleBarOnly");
       if (io.ConfigMemoryCompactTimer >= 0.0f)                        ImGui::Text("io.ConfigMemoryCompactTimer = %.1f", io.ConfigMemoryCompactTimer);
+      if (io.ConfigTextSizeCache)                                     ImGui::Text("io.ConfigTextSizeCache");
       ImGui::Text("io.BackendFlags: 0x%08X", io.BackendFlags);
       if (io.BackendFlags & ImGuiBackendFlags_HasGamepad)             ImGui::Text(" HasGamepad");
       if (io.BackendFlags & ImGuiBackendFlags_HasMouseCursors)        ImGui::Text(" HasMouseCursors");
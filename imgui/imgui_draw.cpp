@@ -402,6 +402,20 @@ void ImDrawListSharedData::SetCircleTessellationMaxError(float max_error)
       CircleSegmentCounts[i] = (ImU8)((i > 0) ? IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC(radius, CircleSegmentMaxError) : 0);
    }
    ArcFastRadiusCutoff = IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC_R(IM_DRAWLIST_ARCFAST_SAMPLE_MAX, CircleSegmentMaxError);
+   ShapeCache.Clear();
+}
+
+void ImDrawShapeCache::Clear()
+{
+   for (int n = 0; n < IM_ARRAYSIZE(Shapes); n++)
+   {
+      ImDrawShapeTemplate& shape = Shapes[n];
+      shape.Kind = ImDrawShapeKind_None;
+      shape.LastUse = 0;
+      shape.VtxOffsets.clear();
+      shape.IdxOffsets.clear();
+   }
+   Tick = 0;
 }
 
 // Initialize before use in a new frame. We always have a command ready in the buffer.
@@ -417,6 +431,13 @@ void ImDrawList::_ResetForNewFrame()
    CmdBuffer.resize(0);
    IdxBuffer.resize(0);
    VtxBuffer.resize(0);
+   if (_VtxArena != NULL)
+   {
+      // The GPU may still be reading last frame's vertices: write this frame's into a fresh block of the same capacity
+      const int vtx_capacity = VtxBuffer.Capacity;
+      _ClearFreeVtxBuffer();
+      _ReserveVtxBuffer(vtx_capacity);
+   }
    Flags = _Data->InitialFlags;
    memset(&_CmdHeader, 0, sizeof(_CmdHeader));
    _VtxCurrentIdx = 0;
@@ -434,7 +455,7 @@ void ImDrawList::_ClearFreeMemory()
 {
    CmdBuffer.clear();
    IdxBuffer.clear();
-   VtxBuffer.clear();
+   _ClearFreeVtxBuffer();
    Flags = ImDrawListFlags_None;
    _VtxCurrentIdx = 0;
    _VtxWritePtr = NULL;
@@ -445,6 +466,44 @@ void ImDrawList::_ClearFreeMemory()
    _Splitter.ClearFreeMemory();
 }
 
+// Grow VtxBuffer, allocating from _Data->VtxArena when there is one. Same as VtxBuffer.reserve() otherwise.
+void ImDrawList::_ReserveVtxBuffer(int new_capacity)
+{
+   if (new_capacity <= VtxBuffer.Capacity)
+      return;
+   ImDrawVtxArena* arena = _Data->VtxArena;
+   ImDrawVert* new_data = arena ? (ImDrawVert*)arena->AllocFunc((size_t)new_capacity * sizeof(ImDrawVert), arena->UserData) : NULL;
+   if (new_data == NULL)
+   {
+      arena = NULL;
+      new_data = (ImDrawVert*)IM_ALLOC((size_t)new_capacity * sizeof(ImDrawVert));
+   }
+   const int size = VtxBuffer.Size;
+   if (VtxBuffer.Data)
+   {
+      memcpy(new_data, VtxBuffer.Data, (size_t)size * sizeof(ImDrawVert));
+      _ClearFreeVtxBuffer();
+   }
+   VtxBuffer.Data = new_data;
+   VtxBuffer.Size = size;
+   VtxBuffer.Capacity = new_capacity;
+   _VtxArena = arena;
+}
+
+// Release VtxBuffer storage back to wherever it was allocated from.
+void ImDrawList::_ClearFreeVtxBuffer()
+{
+   if (_VtxArena == NULL)
+   {
+      VtxBuffer.clear();
+      return;
+   }
+   _VtxArena->FreeFunc(VtxBuffer.Data, _VtxArena->UserData);
+   VtxBuffer.Data = NULL;
+   VtxBuffer.Size = VtxBuffer.Capacity = 0;
+   _VtxArena = NULL;
+}
+
 ImDrawList* ImDrawList::CloneOutput() const
 {
    ImDrawList* dst = IM_NEW(ImDrawList(_Data));
@@ -653,7 +712,10 @@ void ImDrawList::PrimReserve(int idx_count, int vtx_count)
    draw_cmd->ElemCount += idx_count;
 
    int vtx_buffer_old_size = VtxBuffer.Size;
-   VtxBuffer.resize(vtx_buffer_old_size + vtx_count);
+   int vtx_buffer_new_size = vtx_buffer_old_size + vtx_count;
+   if (vtx_buffer_new_size > VtxBuffer.Capacity)
+      _ReserveVtxBuffer(VtxBuffer._grow_capacity(vtx_buffer_new_size));
+   VtxBuffer.Size = vtx_buffer_new_size;
    _VtxWritePtr = VtxBuffer.Data + vtx_buffer_old_size;
 
    int idx_buffer_old_size = IdxBuffer.Size;
@@ -724,6 +786,131 @@ void ImDrawList::PrimQuadUV(const ImVec2& a, const ImVec2& b, const ImVec2& c, c
 #define IM_FIXNORMAL2F_MAX_INVLEN2          100.0f // 500.0f (see #4053, #3366)
 #define IM_FIXNORMAL2F(VX,VY)               { float d2 = VX*VX + VY*VY; if (d2 > 0.000001f) { float inv_len2 = 1.0f / d2; if (inv_len2 > IM_FIXNORMAL2F_MAX_INVLEN2) inv_len2 = IM_FIXNORMAL2F_MAX_INVLEN2; VX *= inv_len2; VY *= inv_len2; } } (void)0
 
+// SIMD kernels for the normals of AddPolyline() and AddConvexPolyFilled() (see IMGUI_ENABLE_SIMD_TESSELLATION in imconfig.h).
+// They do the exact same operations as the macros above, 4 points at a time, so their output is identical to the scalar path.
+// No VMX version: it has neither an exact divide nor an exact square root, which the scalar ImRsqrt() and IM_FIXNORMAL2F() rely on.
+#if defined(IMGUI_ENABLE_SIMD_TESSELLATION)
+#if defined(IMGUI_ENABLE_SSE) && (defined(__SSE2__) || defined(__x86_64__) || defined(_M_X64))
+#define IMGUI_SIMD_TESSELLATION_SSE2    // Same _mm_rsqrt approximation as ImRsqrt()
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define IMGUI_SIMD_TESSELLATION_NEON    // Exact divide and square root, as ImRsqrt(). Scalar code must not be built with fused multiply-add contraction.
+#include <arm_neon.h>
+#endif
+#endif
+
+// Normal of the segment starting at each point, the segment of the last point ending on the first one.
+// Writes normals[0] to normals[count - 1].
+static void ImDrawList_ComputeSegmentNormals(const ImVec2* points, const int points_count, const int count, ImVec2* normals)
+{
+   int i1 = 0;
+#if defined(IMGUI_SIMD_TESSELLATION_SSE2)
+   const __m128 sign_mask = _mm_set1_ps(-0.0f);
+   for (; i1 + 4 <= count && i1 + 4 < points_count; i1 += 4)
+   {
+      const __m128 p1_01 = _mm_loadu_ps(&points[i1].x);        // x0 y0 x1 y1
+      const __m128 p1_23 = _mm_loadu_ps(&points[i1 + 2].x);    // x2 y2 x3 y3
+      const __m128 p2_01 = _mm_loadu_ps(&points[i1 + 1].x);
+      const __m128 p2_23 = _mm_loadu_ps(&points[i1 + 3].x);
+      __m128 dx = _mm_sub_ps(_mm_shuffle_ps(p2_01, p2_23, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(p1_01, p1_23, _MM_SHUFFLE(2, 0, 2, 0)));
+      __m128 dy = _mm_sub_ps(_mm_shuffle_ps(p2_01, p2_23, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(p1_01, p1_23, _MM_SHUFFLE(3, 1, 3, 1)));
+      const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+      const __m128 normalize = _mm_cmpgt_ps(d2, _mm_setzero_ps());
+      const __m128 inv_len = _mm_rsqrt_ps(d2);
+      dx = _mm_or_ps(_mm_and_ps(normalize, _mm_mul_ps(dx, inv_len)), _mm_andnot_ps(normalize, dx));
+      dy = _mm_or_ps(_mm_and_ps(normalize, _mm_mul_ps(dy, inv_len)), _mm_andnot_ps(normalize, dy));
+      const __m128 nx = dy;
+      const __m128 ny = _mm_xor_ps(dx, sign_mask);
+      _mm_storeu_ps(&normals[i1].x, _mm_unpacklo_ps(nx, ny));
+      _mm_storeu_ps(&normals[i1 + 2].x, _mm_unpackhi_ps(nx, ny));
+   }
+#elif defined(IMGUI_SIMD_TESSELLATION_NEON)
+   const float32x4_t one = vdupq_n_f32(1.0f);
+   for (; i1 + 4 <= count && i1 + 4 < points_count; i1 += 4)
+   {
+      const float32x4x2_t p1 = vld2q_f32(&points[i1].x);
+      const float32x4x2_t p2 = vld2q_f32(&points[i1 + 1].x);
+      float32x4_t dx = vsubq_f32(p2.val[0], p1.val[0]);
+      float32x4_t dy = vsubq_f32(p2.val[1], p1.val[1]);
+      const float32x4_t d2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+      const uint32x4_t normalize = vcgtq_f32(d2, vdupq_n_f32(0.0f));
+      const float32x4_t inv_len = vdivq_f32(one, vsqrtq_f32(d2));
+      dx = vbslq_f32(normalize, vmulq_f32(dx, inv_len), dx);
+      dy = vbslq_f32(normalize, vmulq_f32(dy, inv_len), dy);
+      float32x4x2_t n;
+      n.val[0] = dy;
+      n.val[1] = vnegq_f32(dx);
+      vst2q_f32(&normals[i1].x, n);
+   }
+#endif
+   for (; i1 < count; i1++)
+   {
+      const int i2 = (i1 + 1) == points_count ? 0 : i1 + 1;
+      float dx = points[i2].x - points[i1].x;
+      float dy = points[i2].y - points[i1].y;
+      IM_NORMALIZE2F_OVER_ZERO(dx, dy);
+      normals[i1].x = dy;
+      normals[i1].y = -dx;
+   }
+}
+
+// Average of the normals of the two segments meeting at each point, scaled to reach the edges of a unit width line (see IM_FIXNORMAL2F()).
+// The first point gets the average of normals[points_count - 1] and normals[0].
+static void ImDrawList_ComputeMiterNormals(const ImVec2* normals, const int points_count, ImVec2* miters)
+{
+   int i1 = 1;
+#if defined(IMGUI_SIMD_TESSELLATION_SSE2)
+   const __m128 half = _mm_set1_ps(0.5f);
+   const __m128 one = _mm_set1_ps(1.0f);
+   const __m128 min_d2 = _mm_set1_ps(0.000001f);
+   const __m128 max_inv_len2 = _mm_set1_ps(IM_FIXNORMAL2F_MAX_INVLEN2);
+   for (; i1 + 4 <= points_count; i1 += 4)
+   {
+      const __m128 n0_01 = _mm_loadu_ps(&normals[i1 - 1].x);
+      const __m128 n0_23 = _mm_loadu_ps(&normals[i1 + 1].x);
+      const __m128 n1_01 = _mm_loadu_ps(&normals[i1].x);
+      const __m128 n1_23 = _mm_loadu_ps(&normals[i1 + 2].x);
+      __m128 dm_x = _mm_mul_ps(_mm_add_ps(_mm_shuffle_ps(n0_01, n0_23, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(n1_01, n1_23, _MM_SHUFFLE(2, 0, 2, 0))), half);
+      __m128 dm_y = _mm_mul_ps(_mm_add_ps(_mm_shuffle_ps(n0_01, n0_23, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(n1_01, n1_23, _MM_SHUFFLE(3, 1, 3, 1))), half);
+      const __m128 d2 = _mm_add_ps(_mm_mul_ps(dm_x, dm_x), _mm_mul_ps(dm_y, dm_y));
+      const __m128 fix = _mm_cmpgt_ps(d2, min_d2);
+      const __m128 inv_len2 = _mm_min_ps(_mm_div_ps(one, d2), max_inv_len2);
+      dm_x = _mm_or_ps(_mm_and_ps(fix, _mm_mul_ps(dm_x, inv_len2)), _mm_andnot_ps(fix, dm_x));
+      dm_y = _mm_or_ps(_mm_and_ps(fix, _mm_mul_ps(dm_y, inv_len2)), _mm_andnot_ps(fix, dm_y));
+      _mm_storeu_ps(&miters[i1].x, _mm_unpacklo_ps(dm_x, dm_y));
+      _mm_storeu_ps(&miters[i1 + 2].x, _mm_unpackhi_ps(dm_x, dm_y));
+   }
+#elif defined(IMGUI_SIMD_TESSELLATION_NEON)
+   const float32x4_t half = vdupq_n_f32(0.5f);
+   const float32x4_t one = vdupq_n_f32(1.0f);
+   const float32x4_t min_d2 = vdupq_n_f32(0.000001f);
+   const float32x4_t max_inv_len2 = vdupq_n_f32(IM_FIXNORMAL2F_MAX_INVLEN2);
+   for (; i1 + 4 <= points_count; i1 += 4)
+   {
+      const float32x4x2_t n0 = vld2q_f32(&normals[i1 - 1].x);
+      const float32x4x2_t n1 = vld2q_f32(&normals[i1].x);
+      const float32x4_t dm_x = vmulq_f32(vaddq_f32(n0.val[0], n1.val[0]), half);
+      const float32x4_t dm_y = vmulq_f32(vaddq_f32(n0.val[1], n1.val[1]), half);
+      const float32x4_t d2 = vaddq_f32(vmulq_f32(dm_x, dm_x), vmulq_f32(dm_y, dm_y));
+      const uint32x4_t fix = vcgtq_f32(d2, min_d2);
+      const float32x4_t inv_len2 = vminq_f32(vdivq_f32(one, d2), max_inv_len2);
+      float32x4x2_t dm;
+      dm.val[0] = vbslq_f32(fix, vmulq_f32(dm_x, inv_len2), dm_x);
+      dm.val[1] = vbslq_f32(fix, vmulq_f32(dm_y, inv_len2), dm_y);
+      vst2q_f32(&miters[i1].x, dm);
+   }
+#endif
+   // Remaining points, then the first one which wraps around
+   for (; i1 <= points_count; i1++)
+   {
+      const int i2 = (i1 == points_count) ? 0 : i1;
+      float dm_x = (normals[i1 - 1].x + normals[i2].x) * 0.5f;
+      float dm_y = (normals[i1 - 1].y + normals[i2].y) * 0.5f;
+      IM_FIXNORMAL2F(dm_x, dm_y);
+      miters[i2].x = dm_x;
+      miters[i2].y = dm_y;
+   }
+}
+
 // TODO: Thickness anti-aliased lines cap are missing their AA fringe.
 // We avoid using the ImVec2 math operators here to reduce cost to a minimum for debug/non-inlined builds.
 void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32 col, ImDrawFlags flags, float thickness)
@@ -760,23 +947,19 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
       PrimReserve(idx_count, vtx_count);
 
       // Temporary buffer
-      // The first <points_count> items are normals at each line point, then after that there are either 2 or 4 temp points for each line point
-      ImVec2* temp_normals = (ImVec2*)alloca(points_count * ((use_texture || !thick_line) ? 3 : 5) * sizeof(ImVec2)); //-V630
-      ImVec2* temp_points = temp_normals + points_count;
+      // The first <points_count> items are normals at each line point, then the averaged normals at each line point, then after that there are either 2 or 4 temp points for each line point
+      ImVec2* temp_normals = (ImVec2*)alloca(points_count * ((use_texture || !thick_line) ? 4 : 6) * sizeof(ImVec2)); //-V630
+      ImVec2* temp_miters = temp_normals + points_count;
+      ImVec2* temp_points = temp_miters + points_count;
 
       // Calculate normals (tangents) for each line segment
-      for (int i1 = 0; i1 < count; i1++)
-      {
-         const int i2 = (i1 + 1) == points_count ? 0 : i1 + 1;
-         float dx = points[i2].x - points[i1].x;
-         float dy = points[i2].y - points[i1].y;
-         IM_NORMALIZE2F_OVER_ZERO(dx, dy);
-         temp_normals[i1].x = dy;
-         temp_normals[i1].y = -dx;
-      }
+      ImDrawList_ComputeSegmentNormals(points, points_count, count, temp_normals);
       if (!closed)
          temp_normals[points_count - 1] = temp_normals[points_count - 2];
 
+      // Average normals at each point, the first point of an open line doesn't use it
+      ImDrawList_ComputeMiterNormals(temp_normals, points_count, temp_miters);
+
       // If we are drawing a one-pixel-wide line without a texture, or a textured line of any width, we only need 2 or 3 vertices per point
       if (use_texture || !thick_line)
       {
@@ -809,11 +992,8 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
             const unsigned int idx2 = ((i1 + 1) == points_count) ? _VtxCurrentIdx : (idx1 + (use_texture ? 2 : 3)); // Vertex index for end of segment
 
             // Average normals
-            float dm_x = (temp_normals[i1].x + temp_normals[i2].x) * 0.5f;
-            float dm_y = (temp_normals[i1].y + temp_normals[i2].y) * 0.5f;
-            IM_FIXNORMAL2F(dm_x, dm_y);
-            dm_x *= half_draw_size; // dm_x, dm_y are offset to the outer edge of the AA area
-            dm_y *= half_draw_size;
+            float dm_x = temp_miters[i2].x * half_draw_size; // dm_x, dm_y are offset to the outer edge of the AA area
+            float dm_y = temp_miters[i2].y * half_draw_size;
 
             // Add temporary vertexes for the outer edges
             ImVec2* out_vtx = &temp_points[i2 * 2];
@@ -905,9 +1085,8 @@ void ImDrawList::AddPolyline(const ImVec2* points, const int points_count, ImU32
             const unsigned int idx2 = (i1 + 1) == points_count ? _VtxCurrentIdx : (idx1 + 4); // Vertex index for end of segment
 
             // Average normals
-            float dm_x = (temp_normals[i1].x + temp_normals[i2].x) * 0.5f;
-            float dm_y = (temp_normals[i1].y + temp_normals[i2].y) * 0.5f;
-            IM_FIXNORMAL2F(dm_x, dm_y);
+            const float dm_x = temp_miters[i2].x;
+            const float dm_y = temp_miters[i2].y;
             float dm_out_x = dm_x * (half_inner_thickness + AA_SIZE);
             float dm_out_y = dm_y * (half_inner_thickness + AA_SIZE);
             float dm_in_x = dm_x * half_inner_thickness;
@@ -1007,27 +1186,17 @@ void ImDrawList::AddConvexPolyFilled(const ImVec2* points, const int points_coun
          _IdxWritePtr += 3;
       }
 
-      // Compute normals
-      ImVec2* temp_normals = (ImVec2*)alloca(points_count * sizeof(ImVec2)); //-V630
-      for (int i0 = points_count - 1, i1 = 0; i1 < points_count; i0 = i1++)
-      {
-         const ImVec2& p0 = points[i0];
-         const ImVec2& p1 = points[i1];
-         float dx = p1.x - p0.x;
-         float dy = p1.y - p0.y;
-         IM_NORMALIZE2F_OVER_ZERO(dx, dy);
-         temp_normals[i0].x = dy;
-         temp_normals[i0].y = -dx;
-      }
+      // Compute normals, then average them at each point
+      ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2)); //-V630
+      ImVec2* temp_miters = temp_normals + points_count;
+      ImDrawList_ComputeSegmentNormals(points, points_count, points_count, temp_normals);
+      ImDrawList_ComputeMiterNormals(temp_normals, points_count, temp_miters);
 
       for (int i0 = points_count - 1, i1 = 0; i1 < points_count; i0 = i1++)
       {
          // Average normals
-         const ImVec2& n0 = temp_normals[i0];
-         const ImVec2& n1 = temp_normals[i1];
-         float dm_x = (n0.x + n1.x) * 0.5f;
-         float dm_y = (n0.y + n1.y) * 0.5f;
-         IM_FIXNORMAL2F(dm_x, dm_y);
+         float dm_x = temp_miters[i1].x;
+         float dm_y = temp_miters[i1].y;
          dm_x *= AA_SIZE * 0.5f;
          dm_y *= AA_SIZE * 0.5f;
 
@@ -1361,11 +1530,18 @@ static inline ImDrawFlags FixRectCornerFlags(ImDrawFlags flags)
    return flags;
 }
 
-void ImDrawList::PathRect(const ImVec2& a, const ImVec2& b, float rounding, ImDrawFlags flags)
+// Rounding reduced for the corners to fit in the rectangle, 'flags' must have gone through FixRectCornerFlags().
+static inline float FixRectRounding(const ImVec2& a, const ImVec2& b, float rounding, ImDrawFlags flags)
 {
-   flags = FixRectCornerFlags(flags);
    rounding = ImMin(rounding, ImFabs(b.x - a.x) * (((flags & ImDrawFlags_RoundCornersTop) == ImDrawFlags_RoundCornersTop) || ((flags & ImDrawFlags_RoundCornersBottom) == ImDrawFlags_RoundCornersBottom) ? 0.5f : 1.0f) - 1.0f);
    rounding = ImMin(rounding, ImFabs(b.y - a.y) * (((flags & ImDrawFlags_RoundCornersLeft) == ImDrawFlags_RoundCornersLeft) || ((flags & ImDrawFlags_RoundCornersRight) == ImDrawFlags_RoundCornersRight) ? 0.5f : 1.0f) - 1.0f);
+   return rounding;
+}
+
+void ImDrawList::PathRect(const ImVec2& a, const ImVec2& b, float rounding, ImDrawFlags flags)
+{
+   flags = FixRectCornerFlags(flags);
+   rounding = FixRectRounding(a, b, rounding, flags);
 
    if (rounding <= 0.0f || (flags & ImDrawFlags_RoundCornersMask_) == ImDrawFlags_RoundCornersNone)
    {
@@ -1387,6 +1563,185 @@ void ImDrawList::PathRect(const ImVec2& a, const ImVec2& b, float rounding, ImDr
    }
 }
 
+//-----------------------------------------------------------------------------
+// Shape cache
+//-----------------------------------------------------------------------------
+// Filled circles and rounded rectangles are tessellated once around the origin (with their anti-aliased fringe), then copied with
+// their vertices translated. The edges between the corners of a rounded rectangle are straight, so its vertices only depend on
+// the corner they belong to, not on the rectangle size. Radiuses are matched exactly: rounding them would change the segment count of some shapes.
+//-----------------------------------------------------------------------------
+
+// Tessellate 'shape' from its key fields, the same way AddCircleFilled() and PathRect() + AddConvexPolyFilled() do.
+static void ImDrawList_BuildShapeTemplate(ImDrawList* draw_list, ImDrawShapeTemplate* shape)
+{
+   ImVector<ImVec2>& path = draw_list->_Path;
+   const int path_begin = path.Size;
+   const float radius = shape->Radius;
+   ImVec2 corners[4];
+   int corner_end[4];
+   if (shape->Kind == ImDrawShapeKind_Circle)
+   {
+      if (shape->Param <= 0)
+      {
+         draw_list->_PathArcToFastEx(ImVec2(0.0f, 0.0f), radius, 0, IM_DRAWLIST_ARCFAST_SAMPLE_MAX, 0);
+         path.Size--;
+      }
+      else
+      {
+         const float a_max = (IM_PI * 2.0f) * ((float)shape->Param - 1.0f) / (float)shape->Param;
+         draw_list->PathArcTo(ImVec2(0.0f, 0.0f), radius, 0.0f, a_max, shape->Param - 1);
+      }
+      for (int n = 0; n < 4; n++)
+      {
+         corners[n] = ImVec2(0.0f, 0.0f);
+         corner_end[n] = path.Size - path_begin;
+      }
+   }
+   else
+   {
+      // Any rectangle large enough to keep straight edges between the corners
+      const float size = radius * 2.0f + 8.0f;
+      const float rounding_tl = (shape->Param & ImDrawFlags_RoundCornersTopLeft) ? radius : 0.0f;
+      const float rounding_tr = (shape->Param & ImDrawFlags_RoundCornersTopRight) ? radius : 0.0f;
+      const float rounding_br = (shape->Param & ImDrawFlags_RoundCornersBottomRight) ? radius : 0.0f;
+      const float rounding_bl = (shape->Param & ImDrawFlags_RoundCornersBottomLeft) ? radius : 0.0f;
+      corners[0] = ImVec2(0.0f, 0.0f);
+      corners[1] = ImVec2(size, 0.0f);
+      corners[2] = ImVec2(size, size);
+      corners[3] = ImVec2(0.0f, size);
+      draw_list->PathArcToFast(ImVec2(rounding_tl, rounding_tl), rounding_tl, 6, 9);
+      corner_end[0] = path.Size - path_begin;
+      draw_list->PathArcToFast(ImVec2(size - rounding_tr, rounding_tr), rounding_tr, 9, 12);
+      corner_end[1] = path.Size - path_begin;
+      draw_list->PathArcToFast(ImVec2(size - rounding_br, size - rounding_br), rounding_br, 0, 3);
+      corner_end[2] = path.Size - path_begin;
+      draw_list->PathArcToFast(ImVec2(rounding_bl, size - rounding_bl), rounding_bl, 3, 6);
+      corner_end[3] = path.Size - path_begin;
+   }
+
+   const ImVec2* points = path.Data + path_begin;
+   const int points_count = path.Size - path_begin;
+   const bool anti_aliased = (shape->FringeScale > 0.0f);
+   const int vtx_per_point = anti_aliased ? 2 : 1;
+   shape->VtxOffsets.resize(points_count < 3 ? 0 : points_count * vtx_per_point);
+   shape->IdxOffsets.resize(points_count < 3 ? 0 : anti_aliased ? (points_count - 2) * 3 + points_count * 6 : (points_count - 2) * 3);
+   for (int n = 0; n < 4; n++)
+      shape->CornerVtxEnd[n] = (points_count < 3) ? 0 : corner_end[n] * vtx_per_point;
+   if (points_count < 3)
+   {
+      path.Size = path_begin;
+      return;
+   }
+
+   ImVec2* vtx_out = shape->VtxOffsets.Data;
+   ImDrawIdx* idx_out = shape->IdxOffsets.Data;
+   for (int i = 2; i < points_count; i++, idx_out += 3)
+   {
+      idx_out[0] = 0; idx_out[1] = (ImDrawIdx)((i - 1) * vtx_per_point); idx_out[2] = (ImDrawIdx)(i * vtx_per_point);
+   }
+   if (anti_aliased)
+   {
+      // Same as AddConvexPolyFilled()
+      ImVec2* temp_normals = (ImVec2*)alloca(points_count * 2 * sizeof(ImVec2)); //-V630
+      ImVec2* temp_miters = temp_normals + points_count;
+      ImDrawList_ComputeSegmentNormals(points, points_count, points_count, temp_normals);
+      ImDrawList_ComputeMiterNormals(temp_normals, points_count, temp_miters);
+      for (int i = 0, corner = 0; i < points_count; i++)
+      {
+         while (i >= corner_end[corner])
+            corner++;
+         const float dm_x = temp_miters[i].x * (shape->FringeScale * 0.5f);
+         const float dm_y = temp_miters[i].y * (shape->FringeScale * 0.5f);
+         vtx_out[i * 2 + 0] = ImVec2(points[i].x - dm_x - corners[corner].x, points[i].y - dm_y - corners[corner].y); // Inner
+         vtx_out[i * 2 + 1] = ImVec2(points[i].x + dm_x - corners[corner].x, points[i].y + dm_y - corners[corner].y); // Outer
+      }
+      for (int i0 = points_count - 1, i1 = 0; i1 < points_count; i0 = i1++, idx_out += 6)
+      {
+         idx_out[0] = (ImDrawIdx)(i1 << 1); idx_out[1] = (ImDrawIdx)(i0 << 1); idx_out[2] = (ImDrawIdx)((i0 << 1) + 1);
+         idx_out[3] = (ImDrawIdx)((i0 << 1) + 1); idx_out[4] = (ImDrawIdx)((i1 << 1) + 1); idx_out[5] = (ImDrawIdx)(i1 << 1);
+      }
+   }
+   else
+   {
+      for (int i = 0, corner = 0; i < points_count; i++)
+      {
+         while (i >= corner_end[corner])
+            corner++;
+         vtx_out[i] = ImVec2(points[i].x - corners[corner].x, points[i].y - corners[corner].y);
+      }
+   }
+   path.Size = path_begin;
+}
+
+// Find a shape in the cache or tessellate it in place of the least recently used one. NULL if it has too many points to be cached.
+static const ImDrawShapeTemplate* ImDrawList_GetShapeTemplate(ImDrawList* draw_list, int kind, float radius, int param, bool anti_aliased)
+{
+   ImDrawShapeCache* cache = &draw_list->_Data->ShapeCache;
+   const float fringe_scale = anti_aliased ? draw_list->_FringeScale : 0.0f;
+   const unsigned int tick = ++cache->Tick;
+   ImDrawShapeTemplate* oldest = &cache->Shapes[0];
+   for (int n = 0; n < IM_ARRAYSIZE(cache->Shapes); n++)
+   {
+      ImDrawShapeTemplate* shape = &cache->Shapes[n];
+      if (shape->Kind == kind && shape->Radius == radius && shape->Param == param && shape->FringeScale == fringe_scale)
+      {
+         shape->LastUse = tick;
+         cache->Hits++;
+         return shape;
+      }
+      if (shape->LastUse < oldest->LastUse)
+         oldest = shape;
+   }
+   cache->Misses++;
+
+   const int num_segments = (kind == ImDrawShapeKind_Circle && param > 0) ? param : draw_list->_CalcCircleAutoSegmentCount(radius);
+   if (num_segments > IM_DRAWLIST_SHAPE_CACHE_MAX_POINTS)
+      return NULL;
+   oldest->Kind = kind;
+   oldest->Radius = radius;
+   oldest->Param = param;
+   oldest->FringeScale = fringe_scale;
+   oldest->LastUse = tick;
+   ImDrawList_BuildShapeTemplate(draw_list, oldest);
+   return oldest;
+}
+
+// Write a shape into reserved vertices/indices. 'corners' are the positions its vertices are relative to, the center for circles.
+static inline void ImDrawList_WriteShape(const ImDrawShapeTemplate* shape, const ImVec2* corners, ImU32 col, const ImVec2& uv, ImDrawVert* vtx_write, ImDrawIdx* idx_write, unsigned int vtx_current_idx)
+{
+   const int vtx_count = shape->VtxOffsets.Size;
+   const ImVec2* vtx_offsets = shape->VtxOffsets.Data;
+   const ImU32 col_trans = (shape->FringeScale > 0.0f) ? (col & ~IM_COL32_A_MASK) : col; // Anti-aliased shapes have their outer vertices at odd indices
+   for (int corner = 0, n = 0; n < vtx_count; corner++)
+   {
+      const ImVec2 corner_pos = corners[corner];
+      for (; n < shape->CornerVtxEnd[corner]; n++)
+      {
+         vtx_write[n].pos.x = corner_pos.x + vtx_offsets[n].x;
+         vtx_write[n].pos.y = corner_pos.y + vtx_offsets[n].y;
+         vtx_write[n].uv = uv;
+         vtx_write[n].col = (n & 1) ? col_trans : col;
+      }
+   }
+   const int idx_count = shape->IdxOffsets.Size;
+   const ImDrawIdx* idx_offsets = shape->IdxOffsets.Data;
+   for (int n = 0; n < idx_count; n++)
+      idx_write[n] = (ImDrawIdx)(vtx_current_idx + idx_offsets[n]);
+}
+
+static void ImDrawList_AddShape(ImDrawList* draw_list, const ImDrawShapeTemplate* shape, const ImVec2* corners, ImU32 col)
+{
+   const int vtx_count = shape->VtxOffsets.Size;
+   const int idx_count = shape->IdxOffsets.Size;
+   if (idx_count == 0)
+      return;
+   draw_list->PrimReserve(idx_count, vtx_count);
+   ImDrawList_WriteShape(shape, corners, col, draw_list->_Data->TexUvWhitePixel, draw_list->_VtxWritePtr, draw_list->_IdxWritePtr, draw_list->_VtxCurrentIdx);
+   draw_list->_VtxWritePtr += vtx_count;
+   draw_list->_IdxWritePtr += idx_count;
+   draw_list->_VtxCurrentIdx += vtx_count;
+}
+
 void ImDrawList::AddLine(const ImVec2& p1, const ImVec2& p2, ImU32 col, float thickness)
 {
    if ((col & IM_COL32_A_MASK) == 0)
@@ -1417,12 +1772,23 @@ void ImDrawList::AddRectFilled(const ImVec2& p_min, const ImVec2& p_max, ImU32 c
    {
       PrimReserve(6, 4);
       PrimRect(p_min, p_max, col);
+      return;
    }
-   else
+
+   // Copy a cached shape when the corners fit, see PathRect()
+   const ImDrawFlags fixed_flags = FixRectCornerFlags(flags);
+   const float fixed_rounding = FixRectRounding(p_min, p_max, rounding, fixed_flags);
+   if (fixed_rounding > 0.0f && p_max.x > p_min.x && p_max.y > p_min.y)
    {
-      PathRect(p_min, p_max, rounding, flags);
-      PathFillConvex(col);
+      if (const ImDrawShapeTemplate* shape = ImDrawList_GetShapeTemplate(this, ImDrawShapeKind_RoundedRect, fixed_rounding, fixed_flags & ImDrawFlags_RoundCornersMask_, (Flags & ImDrawListFlags_AntiAliasedFill) != 0))
+      {
+         const ImVec2 corners[4] = { p_min, ImVec2(p_max.x, p_min.y), p_max, ImVec2(p_min.x, p_max.y) };
+         ImDrawList_AddShape(this, shape, corners, col);
+         return;
+      }
    }
+   PathRect(p_min, p_max, rounding, flags);
+   PathFillConvex(col);
 }
 
 // p_min = upper-left, p_max = lower-right
@@ -1516,6 +1882,17 @@ void ImDrawList::AddCircleFilled(const ImVec2& center, float radius, ImU32 col,
    if ((col & IM_COL32_A_MASK) == 0 || radius <= 0.0f)
       return;
 
+   // Explicit segment count (still clamp to avoid drawing insanely tessellated shapes)
+   if (num_segments > 0)
+      num_segments = ImClamp(num_segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+
+   // Copy a cached shape, unless it has too many points
+   if (const ImDrawShapeTemplate* shape = ImDrawList_GetShapeTemplate(this, ImDrawShapeKind_Circle, radius, ImMax(num_segments, 0), (Flags & ImDrawListFlags_AntiAliasedFill) != 0))
+   {
+      ImDrawList_AddShape(this, shape, &center, col);
+      return;
+   }
+
    if (num_segments <= 0)
    {
       // Use arc with automatic segment count
@@ -1524,9 +1901,6 @@ void ImDrawList::AddCircleFilled(const ImVec2& center, float radius, ImU32 col,
    }
    else
    {
-      // Explicit segment count (still clamp to avoid drawing insanely tessellated shapes)
-      num_segments = ImClamp(num_segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
-
       // Because we are filling a closed shape we remove 1 from the count of segments/points
       const float a_max = (IM_PI * 2.0f) * ((float)num_segments - 1.0f) / (float)num_segments;
       PathArcTo(center, radius, 0.0f, a_max, num_segments - 1);
@@ -1581,6 +1955,236 @@ void ImDrawList::AddBezierQuadratic(const ImVec2& p1, const ImVec2& p2, const Im
    PathStroke(col, 0, thickness);
 }
 
+// Batched primitives are reserved by chunks small enough for their indices to fit in 16-bit ImDrawIdx (see ImDrawListFlags_AllowVtxOffset).
+static inline int ImDrawList_GetBatchChunkSize(int vtx_per_primitive)
+{
+   return (sizeof(ImDrawIdx) == 2) ? ((1 << 16) - 1) / vtx_per_primitive : INT_MAX;
+}
+
+// Same output as calling AddRectFilled() without rounding for each rectangle, with one reservation per chunk.
+void ImDrawList::AddRectFilledBatch(const ImVec2* p_min, const ImVec2* p_max, int count, ImU32 col, const ImU32* cols)
+{
+   if (count <= 0 || (cols == NULL && (col & IM_COL32_A_MASK) == 0))
+      return;
+
+   const ImVec2 uv = _Data->TexUvWhitePixel;
+   const int chunk_size = ImDrawList_GetBatchChunkSize(4);
+   for (int chunk_begin = 0; chunk_begin < count; chunk_begin += chunk_size)
+   {
+      const int chunk_end = ImMin(count, chunk_begin + chunk_size);
+      PrimReserve((chunk_end - chunk_begin) * 6, (chunk_end - chunk_begin) * 4);
+
+      ImDrawVert* vtx_write = _VtxWritePtr;
+      ImDrawIdx* idx_write = _IdxWritePtr;
+      unsigned int idx = _VtxCurrentIdx;
+      for (int i = chunk_begin; i < chunk_end; i++)
+      {
+         const ImU32 rect_col = cols ? cols[i] : col;
+         if ((rect_col & IM_COL32_A_MASK) == 0)
+            continue;
+         const ImVec2 a = p_min[i];
+         const ImVec2 c = p_max[i];
+         idx_write[0] = (ImDrawIdx)idx; idx_write[1] = (ImDrawIdx)(idx + 1); idx_write[2] = (ImDrawIdx)(idx + 2);
+         idx_write[3] = (ImDrawIdx)idx; idx_write[4] = (ImDrawIdx)(idx + 2); idx_write[5] = (ImDrawIdx)(idx + 3);
+         vtx_write[0].pos = a;                 vtx_write[0].uv = uv; vtx_write[0].col = rect_col;
+         vtx_write[1].pos = ImVec2(c.x, a.y);  vtx_write[1].uv = uv; vtx_write[1].col = rect_col;
+         vtx_write[2].pos = c;                 vtx_write[2].uv = uv; vtx_write[2].col = rect_col;
+         vtx_write[3].pos = ImVec2(a.x, c.y);  vtx_write[3].uv = uv; vtx_write[3].col = rect_col;
+         vtx_write += 4;
+         idx_write += 6;
+         idx += 4;
+      }
+
+      // Give back what transparent rectangles didn't use
+      const int skipped = (chunk_end - chunk_begin) - (int)(idx - _VtxCurrentIdx) / 4;
+      _VtxWritePtr = vtx_write;
+      _IdxWritePtr = idx_write;
+      _VtxCurrentIdx = idx;
+      PrimUnreserve(skipped * 6, skipped * 4);
+   }
+}
+
+// Same output as calling AddLine() for each line, which goes through AddPolyline() with 2 points: see the paths there.
+void ImDrawList::AddLineBatch(const ImVec2* p1, const ImVec2* p2, int count, ImU32 col, float thickness, const ImU32* cols)
+{
+   if (count <= 0 || (cols == NULL && (col & IM_COL32_A_MASK) == 0))
+      return;
+
+   const ImVec2 opaque_uv = _Data->TexUvWhitePixel;
+   const bool anti_aliased = (Flags & ImDrawListFlags_AntiAliasedLines) != 0;
+   const bool thick_line = (thickness > _FringeScale);
+   const float AA_SIZE = _FringeScale;
+   if (anti_aliased)
+      thickness = ImMax(thickness, 1.0f);
+   const int integer_thickness = (int)thickness;
+   const float fractional_thickness = thickness - integer_thickness;
+   const bool use_texture = anti_aliased && (Flags & ImDrawListFlags_AntiAliasedLinesUseTex) && (integer_thickness < IM_DRAWLIST_TEX_LINES_WIDTH_MAX) && (fractional_thickness <= 0.00001f) && (AA_SIZE == 1.0f);
+   const float half_draw_size = use_texture ? ((thickness * 0.5f) + 1) : AA_SIZE;
+   const float half_inner_thickness = (thickness - AA_SIZE) * 0.5f;
+   ImVec2 tex_uv0 = opaque_uv, tex_uv1 = opaque_uv;
+   if (use_texture)
+   {
+      const ImVec4 tex_uvs = _Data->TexUvLines[integer_thickness];
+      tex_uv0 = ImVec2(tex_uvs.x, tex_uvs.y);
+      tex_uv1 = ImVec2(tex_uvs.z, tex_uvs.w);
+   }
+
+   const int vtx_per_line = (!anti_aliased || use_texture) ? 4 : (thick_line ? 8 : 6);
+   const int idx_per_line = (!anti_aliased || use_texture) ? 6 : (thick_line ? 18 : 12);
+   const int chunk_size = ImDrawList_GetBatchChunkSize(vtx_per_line);
+   for (int chunk_begin = 0; chunk_begin < count; chunk_begin += chunk_size)
+   {
+      const int chunk_end = ImMin(count, chunk_begin + chunk_size);
+      PrimReserve((chunk_end - chunk_begin) * idx_per_line, (chunk_end - chunk_begin) * vtx_per_line);
+
+      ImDrawVert* vtx_write = _VtxWritePtr;
+      ImDrawIdx* idx_write = _IdxWritePtr;
+      unsigned int idx = _VtxCurrentIdx;
+      for (int i = chunk_begin; i < chunk_end; i++)
+      {
+         const ImU32 line_col = cols ? cols[i] : col;
+         if ((line_col & IM_COL32_A_MASK) == 0)
+            continue;
+         const float ax = p1[i].x + 0.5f, ay = p1[i].y + 0.5f;
+         const float bx = p2[i].x + 0.5f, by = p2[i].y + 0.5f;
+         float dx = bx - ax;
+         float dy = by - ay;
+         IM_NORMALIZE2F_OVER_ZERO(dx, dy);
+
+         if (!anti_aliased)
+         {
+            // [PATH 4] Non texture-based, Non anti-aliased lines
+            dx *= (thickness * 0.5f);
+            dy *= (thickness * 0.5f);
+            vtx_write[0].pos.x = ax + dy; vtx_write[0].pos.y = ay - dx; vtx_write[0].uv = opaque_uv; vtx_write[0].col = line_col;
+            vtx_write[1].pos.x = bx + dy; vtx_write[1].pos.y = by - dx; vtx_write[1].uv = opaque_uv; vtx_write[1].col = line_col;
+            vtx_write[2].pos.x = bx - dy; vtx_write[2].pos.y = by + dx; vtx_write[2].uv = opaque_uv; vtx_write[2].col = line_col;
+            vtx_write[3].pos.x = ax - dy; vtx_write[3].pos.y = ay + dx; vtx_write[3].uv = opaque_uv; vtx_write[3].col = line_col;
+            idx_write[0] = (ImDrawIdx)(idx); idx_write[1] = (ImDrawIdx)(idx + 1); idx_write[2] = (ImDrawIdx)(idx + 2);
+            idx_write[3] = (ImDrawIdx)(idx); idx_write[4] = (ImDrawIdx)(idx + 2); idx_write[5] = (ImDrawIdx)(idx + 3);
+         }
+         else
+         {
+            // Normal at the first point, averaged normal at the second one
+            const float n_x = dy, n_y = -dx;
+            float m_x = n_x, m_y = n_y;
+            IM_FIXNORMAL2F(m_x, m_y);
+            const ImU32 col_trans = line_col & ~IM_COL32_A_MASK;
+
+            if (use_texture)
+            {
+               // [PATH 1] Texture-based lines
+               vtx_write[0].pos.x = ax + n_x * half_draw_size; vtx_write[0].pos.y = ay + n_y * half_draw_size; vtx_write[0].uv = tex_uv0; vtx_write[0].col = line_col;
+               vtx_write[1].pos.x = ax - n_x * half_draw_size; vtx_write[1].pos.y = ay - n_y * half_draw_size; vtx_write[1].uv = tex_uv1; vtx_write[1].col = line_col;
+               vtx_write[2].pos.x = bx + m_x * half_draw_size; vtx_write[2].pos.y = by + m_y * half_draw_size; vtx_write[2].uv = tex_uv0; vtx_write[2].col = line_col;
+               vtx_write[3].pos.x = bx - m_x * half_draw_size; vtx_write[3].pos.y = by - m_y * half_draw_size; vtx_write[3].uv = tex_uv1; vtx_write[3].col = line_col;
+               idx_write[0] = (ImDrawIdx)(idx + 2); idx_write[1] = (ImDrawIdx)(idx + 0); idx_write[2] = (ImDrawIdx)(idx + 1);
+               idx_write[3] = (ImDrawIdx)(idx + 3); idx_write[4] = (ImDrawIdx)(idx + 1); idx_write[5] = (ImDrawIdx)(idx + 2);
+            }
+            else if (!thick_line)
+            {
+               // [PATH 2] Non texture-based lines (non-thick)
+               vtx_write[0].pos.x = ax;                        vtx_write[0].pos.y = ay;                        vtx_write[0].uv = opaque_uv; vtx_write[0].col = line_col;
+               vtx_write[1].pos.x = ax + n_x * half_draw_size; vtx_write[1].pos.y = ay + n_y * half_draw_size; vtx_write[1].uv = opaque_uv; vtx_write[1].col = col_trans;
+               vtx_write[2].pos.x = ax - n_x * half_draw_size; vtx_write[2].pos.y = ay - n_y * half_draw_size; vtx_write[2].uv = opaque_uv; vtx_write[2].col = col_trans;
+               vtx_write[3].pos.x = bx;                        vtx_write[3].pos.y = by;                        vtx_write[3].uv = opaque_uv; vtx_write[3].col = line_col;
+               vtx_write[4].pos.x = bx + m_x * half_draw_size; vtx_write[4].pos.y = by + m_y * half_draw_size; vtx_write[4].uv = opaque_uv; vtx_write[4].col = col_trans;
+               vtx_write[5].pos.x = bx - m_x * half_draw_size; vtx_write[5].pos.y = by - m_y * half_draw_size; vtx_write[5].uv = opaque_uv; vtx_write[5].col = col_trans;
+               idx_write[0] = (ImDrawIdx)(idx + 3); idx_write[1] = (ImDrawIdx)(idx + 0); idx_write[2] = (ImDrawIdx)(idx + 2);
+               idx_write[3] = (ImDrawIdx)(idx + 2); idx_write[4] = (ImDrawIdx)(idx + 5); idx_write[5] = (ImDrawIdx)(idx + 3);
+               idx_write[6] = (ImDrawIdx)(idx + 4); idx_write[7] = (ImDrawIdx)(idx + 1); idx_write[8] = (ImDrawIdx)(idx + 0);
+               idx_write[9] = (ImDrawIdx)(idx + 0); idx_write[10] = (ImDrawIdx)(idx + 3); idx_write[11] = (ImDrawIdx)(idx + 4);
+            }
+            else
+            {
+               // [PATH 2] Non texture-based lines (thick)
+               const float half_outer_thickness = half_inner_thickness + AA_SIZE;
+               vtx_write[0].pos.x = ax + n_x * half_outer_thickness; vtx_write[0].pos.y = ay + n_y * half_outer_thickness; vtx_write[0].uv = opaque_uv; vtx_write[0].col = col_trans;
+               vtx_write[1].pos.x = ax + n_x * half_inner_thickness; vtx_write[1].pos.y = ay + n_y * half_inner_thickness; vtx_write[1].uv = opaque_uv; vtx_write[1].col = line_col;
+               vtx_write[2].pos.x = ax - n_x * half_inner_thickness; vtx_write[2].pos.y = ay - n_y * half_inner_thickness; vtx_write[2].uv = opaque_uv; vtx_write[2].col = line_col;
+               vtx_write[3].pos.x = ax - n_x * half_outer_thickness; vtx_write[3].pos.y = ay - n_y * half_outer_thickness; vtx_write[3].uv = opaque_uv; vtx_write[3].col = col_trans;
+               vtx_write[4].pos.x = bx + m_x * half_outer_thickness; vtx_write[4].pos.y = by + m_y * half_outer_thickness; vtx_write[4].uv = opaque_uv; vtx_write[4].col = col_trans;
+               vtx_write[5].pos.x = bx + m_x * half_inner_thickness; vtx_write[5].pos.y = by + m_y * half_inner_thickness; vtx_write[5].uv = opaque_uv; vtx_write[5].col = line_col;
+               vtx_write[6].pos.x = bx - m_x * half_inner_thickness; vtx_write[6].pos.y = by - m_y * half_inner_thickness; vtx_write[6].uv = opaque_uv; vtx_write[6].col = line_col;
+               vtx_write[7].pos.x = bx - m_x * half_outer_thickness; vtx_write[7].pos.y = by - m_y * half_outer_thickness; vtx_write[7].uv = opaque_uv; vtx_write[7].col = col_trans;
+               idx_write[0] = (ImDrawIdx)(idx + 5); idx_write[1] = (ImDrawIdx)(idx + 1); idx_write[2] = (ImDrawIdx)(idx + 2);
+               idx_write[3] = (ImDrawIdx)(idx + 2); idx_write[4] = (ImDrawIdx)(idx + 6); idx_write[5] = (ImDrawIdx)(idx + 5);
+               idx_write[6] = (ImDrawIdx)(idx + 5); idx_write[7] = (ImDrawIdx)(idx + 1); idx_write[8] = (ImDrawIdx)(idx + 0);
+               idx_write[9] = (ImDrawIdx)(idx + 0); idx_write[10] = (ImDrawIdx)(idx + 4); idx_write[11] = (ImDrawIdx)(idx + 5);
+               idx_write[12] = (ImDrawIdx)(idx + 6); idx_write[13] = (ImDrawIdx)(idx + 2); idx_write[14] = (ImDrawIdx)(idx + 3);
+               idx_write[15] = (ImDrawIdx)(idx + 3); idx_write[16] = (ImDrawIdx)(idx + 7); idx_write[17] = (ImDrawIdx)(idx + 6);
+            }
+         }
+         vtx_write += vtx_per_line;
+         idx_write += idx_per_line;
+         idx += vtx_per_line;
+      }
+
+      // Give back what transparent lines didn't use
+      const int skipped = (chunk_end - chunk_begin) - (int)(idx - _VtxCurrentIdx) / vtx_per_line;
+      _VtxWritePtr = vtx_write;
+      _IdxWritePtr = idx_write;
+      _VtxCurrentIdx = idx;
+      PrimUnreserve(skipped * idx_per_line, skipped * vtx_per_line);
+   }
+}
+
+// Same output as calling AddCircleFilled() for each center, the circle is looked up once.
+void ImDrawList::AddCircleFilledBatch(const ImVec2* centers, int count, float radius, ImU32 col, const ImU32* cols, int num_segments)
+{
+   if (count <= 0 || radius <= 0.0f || (cols == NULL && (col & IM_COL32_A_MASK) == 0))
+      return;
+
+   // Circles with too many points to be cached get tessellated once for this call
+   if (num_segments > 0)
+      num_segments = ImClamp(num_segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+   const bool anti_aliased = (Flags & ImDrawListFlags_AntiAliasedFill) != 0;
+   const ImDrawShapeTemplate* shape = ImDrawList_GetShapeTemplate(this, ImDrawShapeKind_Circle, radius, ImMax(num_segments, 0), anti_aliased);
+   ImDrawShapeTemplate temp_shape;
+   if (shape == NULL)
+   {
+      temp_shape.Kind = ImDrawShapeKind_Circle;
+      temp_shape.Radius = radius;
+      temp_shape.Param = ImMax(num_segments, 0);
+      temp_shape.FringeScale = anti_aliased ? _FringeScale : 0.0f;
+      ImDrawList_BuildShapeTemplate(this, &temp_shape);
+      shape = &temp_shape;
+   }
+   const int vtx_per_circle = shape->VtxOffsets.Size;
+   const int idx_per_circle = shape->IdxOffsets.Size;
+   if (idx_per_circle == 0)
+      return;
+
+   const ImVec2 uv = _Data->TexUvWhitePixel;
+   const int chunk_size = ImDrawList_GetBatchChunkSize(vtx_per_circle);
+   for (int chunk_begin = 0; chunk_begin < count; chunk_begin += chunk_size)
+   {
+      const int chunk_end = ImMin(count, chunk_begin + chunk_size);
+      PrimReserve((chunk_end - chunk_begin) * idx_per_circle, (chunk_end - chunk_begin) * vtx_per_circle);
+
+      ImDrawVert* vtx_write = _VtxWritePtr;
+      ImDrawIdx* idx_write = _IdxWritePtr;
+      unsigned int idx = _VtxCurrentIdx;
+      for (int i = chunk_begin; i < chunk_end; i++)
+      {
+         const ImU32 circle_col = cols ? cols[i] : col;
+         if ((circle_col & IM_COL32_A_MASK) == 0)
+            continue;
+         ImDrawList_WriteShape(shape, &centers[i], circle_col, uv, vtx_write, idx_write, idx);
+         vtx_write += vtx_per_circle;
+         idx_write += idx_per_circle;
+         idx += vtx_per_circle;
+      }
+
+      // Give back what transparent circles didn't use
+      const int skipped = (chunk_end - chunk_begin) - (int)(idx - _VtxCurrentIdx) / vtx_per_circle;
+      _VtxWritePtr = vtx_write;
+      _IdxWritePtr = idx_write;
+      _VtxCurrentIdx = idx;
+      PrimUnreserve(skipped * idx_per_circle, skipped * vtx_per_circle);
+   }
+}
+
 void ImDrawList::AddText(const ImFont* font, float font_size, const ImVec2& pos, ImU32 col, const char* text_begin, const char* text_end, float wrap_width, const ImVec4* cpu_fine_clip_rect)
 {
    if ((col & IM_COL32_A_MASK) == 0)
@@ -1836,6 +2440,8 @@ void ImDrawData::DeIndexAllBuffers()
       new_vtx_buffer.resize(cmd_list->IdxBuffer.Size);
       for (int j = 0; j < cmd_list->IdxBuffer.Size; j++)
          new_vtx_buffer[j] = cmd_list->VtxBuffer[cmd_list->IdxBuffer[j]];
+      if (cmd_list->_VtxArena != NULL)
+         cmd_list->_ClearFreeVtxBuffer(); // Arena storage can't be handed over to new_vtx_buffer
       cmd_list->VtxBuffer.swap(new_vtx_buffer);
       cmd_list->IdxBuffer.resize(0);
       TotalVtxCount += cmd_list->VtxBuffer.Size;
@@ -2787,6 +3393,8 @@ void ImFontAtlasBuildInit(ImFontAtlas* atlas)
 // This is called/shared by both the stb_truetype and the FreeType builder.
 void ImFontAtlasBuildFinish(ImFontAtlas* atlas)
 {
+   atlas->BuildCount++;
+
    // Render into our custom data blocks
    IM_ASSERT(atlas->TexPixelsAlpha8 != NULL || atlas->TexPixelsRGBA32 != NULL);
    ImFontAtlasBuildRenderDefaultTexData(atlas);
@@ -3141,6 +3749,7 @@ void    ImFont::ClearOutputData()
    IndexAdvanceX.clear();
    IndexLookup.clear();
    FallbackGlyph = NULL;
+   AsciiGlyphs.clear();
    ContainerAtlas = NULL;
    DirtyLookupTables = true;
    Ascent = Descent = 0.0f;
@@ -3155,6 +3764,36 @@ static ImWchar FindFirstExistingGlyph(ImFont* font, const ImWchar* candidate_cha
    return (ImWchar)-1;
 }
 
+// Copy what RenderText() needs from the glyphs of code points 0..127 into the dense AsciiGlyphs[] table.
+// The table is left empty (disabling the fast path) for the rare fonts where reading it wouldn't give the same output as FindGlyph().
+static void ImFontBuildAsciiGlyphs(ImFont* font)
+{
+   font->AsciiGlyphs.clear();
+   if (font->FallbackGlyph == NULL || font->IndexAdvanceX.Size < 128)
+      return;
+   for (int c = 0; c < 128; c++)
+   {
+      const ImFontGlyph* glyph = font->FindGlyph((ImWchar)c);
+      if (glyph->Colored || font->IndexAdvanceX[c] != glyph->AdvanceX || (glyph->Visible && glyph->X0 == glyph->X1))
+         return;
+   }
+   font->AsciiGlyphs.resize(128);
+   for (int c = 0; c < 128; c++)
+   {
+      const ImFontGlyph* glyph = font->FindGlyph((ImWchar)c);
+      ImFontGlyphAscii& dst = font->AsciiGlyphs[c];
+      if (glyph->Visible)
+      {
+         dst.X0 = glyph->X0; dst.Y0 = glyph->Y0; dst.X1 = glyph->X1; dst.Y1 = glyph->Y1;
+         dst.U0 = glyph->U0; dst.V0 = glyph->V0; dst.U1 = glyph->U1; dst.V1 = glyph->V1;
+      }
+      else
+      {
+         memset(&dst, 0, sizeof(dst));
+      }
+   }
+}
+
 void ImFont::BuildLookupTable()
 {
    int max_codepoint = 0;
@@ -3165,6 +3804,7 @@ void ImFont::BuildLookupTable()
    IM_ASSERT(Glyphs.Size < 0xFFFF); // -1 is reserved
    IndexAdvanceX.clear();
    IndexLookup.clear();
+   AsciiGlyphs.clear();
    DirtyLookupTables = false;
    memset(Used4kPagesMap, 0, sizeof(Used4kPagesMap));
    GrowIndex(max_codepoint + 1);
@@ -3225,6 +3865,8 @@ void ImFont::BuildLookupTable()
    for (int i = 0; i < max_codepoint + 1; i++)
       if (IndexAdvanceX[i] < 0.0f)
          IndexAdvanceX[i] = FallbackAdvanceX;
+
+   ImFontBuildAsciiGlyphs(this);
 }
 
 // API is designed this way to avoid exposing the 4K page size
@@ -3244,6 +3886,8 @@ void ImFont::SetGlyphVisible(ImWchar c, bool visible)
 {
    if (ImFontGlyph* glyph = (ImFontGlyph*)(void*)FindGlyph((ImWchar)c))
       glyph->Visible = visible ? 1 : 0;
+   if (c < 128 && AsciiGlyphs.Size > 0)
+      ImFontBuildAsciiGlyphs(this);
 }
 
 void ImFont::GrowIndex(int new_size)
@@ -3315,6 +3959,10 @@ void ImFont::AddRemapChar(ImWchar dst, ImWchar src, bool overwrite_dst)
    GrowIndex(dst + 1);
    IndexLookup[dst] = (src < index_size) ? IndexLookup.Data[src] : (ImWchar)-1;
    IndexAdvanceX[dst] = (src < index_size) ? IndexAdvanceX.Data[src] : 1.0f;
+   if (dst < 128)
+      ImFontBuildAsciiGlyphs(this);
+   if (ContainerAtlas)
+      ContainerAtlas->BuildCount++;
 }
 
 const ImFontGlyph* ImFont::FindGlyph(ImWchar c) const
@@ -3605,6 +4253,10 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
 
    const ImU32 col_untinted = col | ~IM_COL32_A_MASK;
 
+   // Runs of ASCII characters are read from the dense AsciiGlyphs[] table (see ImFontBuildAsciiGlyphs) instead of going through FindGlyph().
+   const ImFontGlyphAscii* ascii_glyphs = (AsciiGlyphs.Size > 0 && !cpu_fine_clip) ? AsciiGlyphs.Data : NULL;
+   const float* ascii_advance_x = IndexAdvanceX.Data;
+
    while (s < text_end)
    {
       if (word_wrap_enabled)
@@ -3635,6 +4287,48 @@ void ImFont::RenderText(ImDrawList* draw_list, float size, ImVec2 pos, ImU32 col
          }
       }
 
+      // ASCII fast path: render the whole run up to the next line break, wrap point or non-ASCII character.
+      // Output is the same as the generic path below, minus the per-character decoding, glyph lookup and fine clipping.
+      if (ascii_glyphs != NULL && (unsigned char)*s < 0x80 && *s != '\n' && *s != '\r')
+      {
+         // Locals so the compiler doesn't reload them after each vertex store (which may alias any float)
+         const char* run_end = word_wrap_enabled ? word_wrap_eol : text_end;
+         const float clip_x1 = clip_rect.x;
+         const float clip_x2 = clip_rect.z;
+         while (s < run_end)
+         {
+            const unsigned int c = (unsigned char)*s;
+            if (c >= 0x80 || c == '\n' || c == '\r')
+               break;
+            s++;
+
+            const ImFontGlyphAscii& glyph = ascii_glyphs[c];
+            const float char_width = ascii_advance_x[c] * scale;
+            if (glyph.X0 != glyph.X1)
+            {
+               const float x1 = x + glyph.X0 * scale;
+               const float x2 = x + glyph.X1 * scale;
+               if (x1 <= clip_x2 && x2 >= clip_x1)
+               {
+                  const float y1 = y + glyph.Y0 * scale;
+                  const float y2 = y + glyph.Y1 * scale;
+                  const float u1 = glyph.U0, v1 = glyph.V0, u2 = glyph.U1, v2 = glyph.V1;
+                  idx_write[0] = (ImDrawIdx)(vtx_current_idx); idx_write[1] = (ImDrawIdx)(vtx_current_idx + 1); idx_write[2] = (ImDrawIdx)(vtx_current_idx + 2);
+                  idx_write[3] = (ImDrawIdx)(vtx_current_idx); idx_write[4] = (ImDrawIdx)(vtx_current_idx + 2); idx_write[5] = (ImDrawIdx)(vtx_current_idx + 3);
+                  vtx_write[0].pos.x = x1; vtx_write[0].pos.y = y1; vtx_write[0].col = col; vtx_write[0].uv.x = u1; vtx_write[0].uv.y = v1;
+                  vtx_write[1].pos.x = x2; vtx_write[1].pos.y = y1; vtx_write[1].col = col; vtx_write[1].uv.x = u2; vtx_write[1].uv.y = v1;
+                  vtx_write[2].pos.x = x2; vtx_write[2].pos.y = y2; vtx_write[2].col = col; vtx_write[2].uv.x = u2; vtx_write[2].uv.y = v2;
+                  vtx_write[3].pos.x = x1; vtx_write[3].pos.y = y2; vtx_write[3].col = col; vtx_write[3].uv.x = u1; vtx_write[3].uv.y = v2;
+                  vtx_write += 4;
+                  vtx_current_idx += 4;
+                  idx_write += 6;
+               }
+            }
+            x += char_width;
+         }
+         continue;
+      }
+
       // Decode and advance source
       unsigned int c = (unsigned int)*s;
       if (c < 0x80)
@@ -143,6 +143,7 @@ struct ImGuiTableColumn;            // Storage for one column of a table
 struct ImGuiTableTempData;          // Temporary storage for one table (one per table in the stack), shared between tables.
 struct ImGuiTableSettings;          // Storage for a table .ini settings
 struct ImGuiTableColumnsSettings;   // Storage for a column .ini settings
+struct ImGuiTextSizeCache;          // Cached results of CalcTextSize(), see io.ConfigTextSizeCache
 struct ImGuiWindow;                 // Storage for one window
 struct ImGuiWindowTempData;         // Temporary storage for one window (that's the data which in theory we could ditch at the end of the frame, in practice we currently keep it for each window)
 struct ImGuiWindowSettings;         // Storage for a window .ini settings (we keep one of those even if the actual window wasn't instanced during this session)
@@ -719,6 +720,44 @@ struct ImChunkStream
 #endif
 #define IM_DRAWLIST_ARCFAST_SAMPLE_MAX                          IM_DRAWLIST_ARCFAST_TABLE_SIZE // Sample index _PathArcToFastEx() for 360 angle.
 
+// ImDrawList: Cache of filled shapes (circles, rounded rectangles) tessellated once then translated, see ImDrawShapeCache.
+#ifndef IM_DRAWLIST_SHAPE_CACHE_SIZE
+#define IM_DRAWLIST_SHAPE_CACHE_SIZE                            16 // Number of shapes kept, the least recently used one gets replaced.
+#endif
+#define IM_DRAWLIST_SHAPE_CACHE_MAX_POINTS                      128 // Shapes with more points are tessellated every time.
+
+enum ImDrawShapeKind_
+{
+   ImDrawShapeKind_None,
+   ImDrawShapeKind_Circle,         // Param: number of segments, 0 for automatic
+   ImDrawShapeKind_RoundedRect     // Param: ImDrawFlags_RoundCornersXXX flags
+};
+
+// Filled shape with its anti-aliased fringe, vertices relative to the shape corners.
+struct ImDrawShapeTemplate
+{
+   int                 Kind;               // ImDrawShapeKind_
+   float               Radius;             // Exact: the number of segments and the arc step are derived from it
+   int                 Param;
+   float               FringeScale;        // 0.0f when not anti-aliased
+   unsigned int        LastUse;            // ImDrawShapeCache::Tick when last used
+   int                 CornerVtxEnd[4];    // Vertices are relative to the top-left, top-right, bottom-right then bottom-left corner, in that order. Circles are relative to their center (first corner).
+   ImVector<ImVec2>    VtxOffsets;         // Anti-aliased: inner/outer vertex pairs
+   ImVector<ImDrawIdx> IdxOffsets;         // Relative to the first vertex of the shape
+};
+
+struct IMGUI_API ImDrawShapeCache
+{
+   ImDrawShapeTemplate Shapes[IM_DRAWLIST_SHAPE_CACHE_SIZE];
+   unsigned int        Tick;               // Incremented on each lookup, for replacing the least recently used shape
+   unsigned int        Hits;               // Lookups since the start of the frame
+   unsigned int        Misses;
+   unsigned int        HitsLastFrame;      // Lookups of the last frame, for the Metrics window
+   unsigned int        MissesLastFrame;
+
+   void Clear();
+};
+
 // Data shared between all ImDrawList instances
 // You may want to create your own instance of this if you want to use ImDrawList completely without ImGui. In that case, watch out for future changes to this structure.
 struct IMGUI_API ImDrawListSharedData
@@ -730,6 +769,7 @@ struct IMGUI_API ImDrawListSharedData
    float           CircleSegmentMaxError;      // Number of circle segments to use per pixel of radius for AddCircle() etc
    ImVec4          ClipRectFullscreen;         // Value for PushClipRectFullscreen()
    ImDrawListFlags InitialFlags;               // Initial flags at the beginning of the frame (it is possible to alter flags on a per-drawlist basis afterwards)
+   ImDrawVtxArena* VtxArena;                   // Storage for VtxBuffer of new/growing draw lists, NULL to use the heap (set by renderer backends)
 
    // [Internal] Lookup tables
    ImVec2          ArcFastVtx[IM_DRAWLIST_ARCFAST_TABLE_SIZE]; // Sample points on the quarter of the circle.
@@ -737,6 +777,11 @@ struct IMGUI_API ImDrawListSharedData
    ImU8            CircleSegmentCounts[64];    // Precomputed segment count for given radius before we calculate it dynamically (to avoid calculation overhead)
    const ImVec4* TexUvLines;                 // UV of anti-aliased lines in the atlas
 
+   // [Internal] Shapes used by AddRectFilled() (rounded), AddCircleFilled() and AddCircleFilledBatch(), filled by draw lists through their const pointer
+   // Not thread safe: every draw list using this instance writes to it, so they must be built from one thread at a time.
+   // To build draw lists on several threads, give each thread its own ImDrawListSharedData, e.g. a copy of *ImGui::GetDrawListSharedData().
+   mutable ImDrawShapeCache ShapeCache;
+
    ImDrawListSharedData();
    void SetCircleTessellationMaxError(float max_error);
 };
@@ -1170,6 +1215,38 @@ struct ImGuiPtrOrIndex
    ImGuiPtrOrIndex(int index) { Ptr = NULL; Index = index; }
 };
 
+// Cached results of CalcTextSize(), used when io.ConfigTextSizeCache is set.
+// Set associative: the key selects a set of IMGUI_TEXT_SIZE_CACHE_WAYS entries, the least recently used entry of the set gets replaced.
+#ifndef IMGUI_TEXT_SIZE_CACHE_SETS
+#define IMGUI_TEXT_SIZE_CACHE_SETS      256     // Must be a power of two
+#endif
+#define IMGUI_TEXT_SIZE_CACHE_WAYS      4
+
+struct ImGuiTextSizeCacheEntry
+{
+   ImGuiID     Key;                // Hash of the font, font size, wrap width and text. 0 if unused.
+   ImU32       Check;              // Second hash of the same data with an unrelated function, so two texts must collide on both to share an entry
+   int         TextLen;
+   ImU32       LastUse;            // ImGuiTextSizeCache::Tick when last used
+   ImVec2      Size;
+};
+
+struct IMGUI_API ImGuiTextSizeCache
+{
+   ImVector<ImGuiTextSizeCacheEntry> Entries;  // IMGUI_TEXT_SIZE_CACHE_SETS * IMGUI_TEXT_SIZE_CACHE_WAYS, allocated on first use
+   ImU32       Tick;               // Incremented on each lookup
+   ImU32       Hits;               // Lookups since the start of the frame
+   ImU32       Misses;
+   ImU32       HitsLastFrame;      // Lookups of the last frame, for the Metrics window
+   ImU32       MissesLastFrame;
+   const ImFontAtlas* FontAtlas;   // Atlas and ImFontAtlas::BuildCount the entries were measured with. Keys hold font pointers, which a rebuilt atlas may hand out again.
+   int         FontAtlasBuildCount;
+
+   ImGuiTextSizeCache()    { Tick = Hits = Misses = HitsLastFrame = MissesLastFrame = 0; FontAtlas = NULL; FontAtlasBuildCount = 0; }
+   void        Clear()     { Entries.clear(); Tick = 0; }
+   ImGuiTextSizeCacheEntry* GetEntry(ImGuiID key, ImU32 check, int text_len, bool* out_hit); // On a miss, returns the replaced entry with only Size left to fill
+};
+
 //-----------------------------------------------------------------------------
 // [SECTION] Inputs support
 //-----------------------------------------------------------------------------
@@ -1742,6 +1819,7 @@ struct ImGuiContext
    float                   FontSize;                           // (Shortcut) == FontBaseSize * g.CurrentWindow->FontWindowScale == window->FontSize(). Text height for current window.
    float                   FontBaseSize;                       // (Shortcut) == IO.FontGlobalScale * Font->Scale * Font->FontSize. Base text height.
    ImDrawListSharedData    DrawListSharedData;
+   ImGuiTextSizeCache      TextSizeCache;                      // Cached CalcTextSize() results, when io.ConfigTextSizeCache is set
    double                  Time;
    int                     FrameCount;
    int                     FrameCountEnded;
@@ -0,0 +1,39 @@
+#pragma once
+#include "MemoryReader.hpp"
+#include <string.h>
+#include <vector>
+
+// Maps [Base, Base + size) onto a buffer and counts reads. Reads touching [BadBegin, BadEnd) fail, as an unmapped page would,
+// and fill the destination with garbage when ScribbleOnError is set.
+class BufferReader : public MemoryReader
+{
+public:
+    static const int ReadError = (int)0x80010002;
+
+    BufferReader(uint32_t base, size_t size)
+        : Base(base), Data(size), BadBegin(0), BadEnd(0), ScribbleOnError(false), Reads(0)
+    {
+        for (size_t i = 0; i < size; i++)
+            Data[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+
+    virtual int ReadRange(uint32_t address, void* destination, size_t size)
+    {
+        Reads++;
+        if (address < Base || address + size > Base + Data.size() || (address < BadEnd && BadBegin < address + size))
+        {
+            if (ScribbleOnError)
+                memset(destination, 0xEE, size);
+            return ReadError;
+        }
+        memcpy(destination, &Data[address - Base], size);
+        return SUCCEEDED;
+    }
+
+    uint32_t                 Base;
+    std::vector<uint8_t>     Data;
+    uint32_t                 BadBegin;
+    uint32_t                 BadEnd;
+    bool                     ScribbleOnError;
+    int                      Reads;
+};
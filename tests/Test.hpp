@@ -0,0 +1,45 @@
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+// Minimal harness for the host-side tests: a failed check prints where it failed and fails the run, the suite keeps going.
+extern int g_TestFailures;
+
+#define TEST_CHECK(expr) \
+    do { if (!(expr)) { g_TestFailures++; printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); } } while (0)
+
+// Suites, see main.cpp. Benchmarks only run with --bench.
+void RunGcmRenderTests(bool bench);
+void RunGcmStreamTests(bool bench);
+void RunVtxArenaTests(bool bench);
+void RunPsglStateTests(bool bench);
+void RunPadStateTests(bool bench);
+void RunPadQueueTests(bool bench);
+void RunClockTests(bool bench);
+void RunTrampolinePoolTests(bool bench);
+void RunDetourPatchTests(bool bench);
+void RunPowerPCTests(bool bench);
+void RunStubIndexTests(bool bench);
+void RunMemoryReaderTests(bool bench);
+void RunWatchTableTests(bool bench);
+void RunAllocatorTests(bool bench);
+void RunDrawListTests(bool bench);
+void RunDrawListHashes(bool bench);    // Prints hashes of the buffers, compared between builds instead of checked
+void RunTextSizeCacheTests(bool bench);
+
+// Best of 'repeats' runs of 'fn', in microseconds.
+template<typename Fn>
+double BenchmarkBest(int repeats, Fn fn)
+{
+    double best = 1e30;
+    for (int i = 0; i < repeats; i++)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        fn();
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (us < best)
+            best = us;
+    }
+    return best;
+}
@@ -0,0 +1,12 @@
+# Runs two test executables with the same arguments and fails unless they print the same thing.
+#   cmake -DEXPECTED=<exe> -DACTUAL=<exe> -DARGS=<args> -P compare_outputs.cmake
+separate_arguments(ARGS)
+execute_process(COMMAND ${EXPECTED} ${ARGS} OUTPUT_VARIABLE EXPECTED_OUTPUT RESULT_VARIABLE EXPECTED_RESULT)
+execute_process(COMMAND ${ACTUAL} ${ARGS} OUTPUT_VARIABLE ACTUAL_OUTPUT RESULT_VARIABLE ACTUAL_RESULT)
+if(NOT EXPECTED_RESULT EQUAL 0 OR NOT ACTUAL_RESULT EQUAL 0)
+    message(FATAL_ERROR "${EXPECTED} returned ${EXPECTED_RESULT}, ${ACTUAL} returned ${ACTUAL_RESULT}")
+endif()
+if(NOT EXPECTED_OUTPUT STREQUAL ACTUAL_OUTPUT)
+    message(FATAL_ERROR "${ACTUAL} ${ARGS} differs from ${EXPECTED}:\n${ACTUAL_OUTPUT}\nexpected:\n${EXPECTED_OUTPUT}")
+endif()
+message(STATUS "${EXPECTED_OUTPUT}")
@@ -0,0 +1,69 @@
+// Host-side tests and benchmarks, with tests/shim standing in for the parts of the PS3 SDK the code under test needs.
+//   imgui_ps3_tests [suite...] [--bench]
+// Runs every suite when none is named. Returns non-zero if any check failed.
+#include "Test.hpp"
+#include <string.h>
+
+int g_TestFailures = 0;
+
+struct Suite
+{
+    const char*  Name;
+    void         (*Run)(bool bench);
+};
+
+static const Suite s_Suites[] =
+{
+    { "gcm_render",     RunGcmRenderTests },
+    { "gcm_stream",     RunGcmStreamTests },
+    { "vtx_arena",      RunVtxArenaTests },
+    { "psgl_state",     RunPsglStateTests },
+    { "pad_state",      RunPadStateTests },
+    { "pad_queue",      RunPadQueueTests },
+    { "clock",          RunClockTests },
+    { "trampoline_pool", RunTrampolinePoolTests },
+    { "detour_patch",   RunDetourPatchTests },
+    { "powerpc",        RunPowerPCTests },
+    { "stub_index",     RunStubIndexTests },
+    { "memory_reader",  RunMemoryReaderTests },
+    { "watch_table",    RunWatchTableTests },
+    { "allocator",      RunAllocatorTests },
+    { "draw_list",      RunDrawListTests },
+    { "draw_list_hashes", RunDrawListHashes },
+    { "text_size_cache", RunTextSizeCacheTests },
+};
+
+int main(int argc, char** argv)
+{
+    bool bench = false;
+    bool named = false;
+    int ran = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--bench"))
+            bench = true;
+        else
+            named = true;
+    }
+
+    for (size_t n = 0; n < sizeof(s_Suites) / sizeof(s_Suites[0]); n++)
+    {
+        bool selected = !named;
+        for (int i = 1; i < argc && !selected; i++)
+            selected = !strcmp(argv[i], s_Suites[n].Name);
+        if (!selected)
+            continue;
+
+        const int failures = g_TestFailures;
+        s_Suites[n].Run(bench);
+        ran++;
+        printf("[%s] %s\n", s_Suites[n].Name, g_TestFailures == failures ? "ok" : "FAILED");
+    }
+
+    if (ran == 0)
+    {
+        printf("no such suite\n");
+        return 1;
+    }
+    return g_TestFailures != 0 ? 1 : 0;
+}
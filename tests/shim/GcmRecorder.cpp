@@ -0,0 +1,286 @@
+// Host definitions of the <cell/gcm.h> shim functions, writing into and reading back from g_GcmRecorder.
+#include "GcmRecorder.hpp"
+#include <sys/timer.h>
+#include <string.h>
+
+GcmRecorder g_GcmRecorder;
+CellGcmContextData* gCellGcmCurrentContext = NULL;
+
+static int32_t GcmRecorderMakeRoom(CellGcmContextData* context, uint32_t)
+{
+    g_GcmRecorder.Execute();
+    context->current = context->begin;
+    g_GcmRecorder.Executed = context->begin;
+    g_GcmRecorder.Wraps++;
+    return CELL_OK;
+}
+
+void GcmRecorder::Reset(uint32_t command_buffer_words, uint32_t local_memory_size)
+{
+    CommandBuffer.assign(command_buffer_words, 0);
+    Context.begin = Context.current = CommandBuffer.data();
+    Context.end = CommandBuffer.data() + CommandBuffer.size();
+    Context.callback = GcmRecorderMakeRoom;
+    Executed = Context.begin;
+    gCellGcmCurrentContext = &Context;
+
+    LocalMemoryStorage.assign(local_memory_size + 128, 0);
+    LocalMemory = (uint8_t*)(((uintptr_t)LocalMemoryStorage.data() + 127) & ~(uintptr_t)127);
+    LocalMemorySize = local_memory_size;
+    MainMemory = NULL;
+    MainMemorySize = 0;
+
+    memset(Labels, 0, sizeof(Labels));
+    Methods.clear();
+    Stalled = false;
+    Flushes = Sleeps = Wraps = 0;
+}
+
+void GcmRecorder::Execute()
+{
+    while (Executed < Context.current)
+    {
+        GcmMethod method;
+        method.Method = CELL_GCM_METHOD_GET_METHOD(*Executed);
+        const uint32_t count = CELL_GCM_METHOD_GET_COUNT(*Executed);
+        method.Args.assign(Executed + 1, Executed + 1 + count);
+        Executed += 1 + count;
+        if (method.Method == CELL_GCM_NV4097_SET_SEMAPHORE_OFFSET)
+            Labels[method.Args[0] >> 4] = method.Args[1];
+        Methods.push_back(method);
+    }
+}
+
+int GcmRecorder::Count(uint32_t method) const
+{
+    int count = 0;
+    for (size_t i = 0; i < Methods.size(); i++)
+        if (Methods[i].Method == method)
+            count++;
+    return count;
+}
+
+const GcmMethod* GcmRecorder::Find(uint32_t method, int n) const
+{
+    for (size_t i = 0; i < Methods.size(); i++)
+        if (Methods[i].Method == method && n-- == 0)
+            return &Methods[i];
+    return NULL;
+}
+
+int32_t cellGcmAddressToOffset(const void* address, uint32_t* offset)
+{
+    const uint8_t* p = (const uint8_t*)address;
+    if (p >= g_GcmRecorder.LocalMemory && p < g_GcmRecorder.LocalMemory + g_GcmRecorder.LocalMemorySize)
+        *offset = (uint32_t)(p - g_GcmRecorder.LocalMemory);
+    else if (p >= g_GcmRecorder.MainMemory && p < g_GcmRecorder.MainMemory + g_GcmRecorder.MainMemorySize)
+        *offset = (uint32_t)(p - g_GcmRecorder.MainMemory);
+    else
+        return CELL_GCM_ERROR_FAILURE;
+    return CELL_OK;
+}
+
+uint32_t* cellGcmGetLabelAddress(uint8_t index)
+{
+    return &g_GcmRecorder.Labels[index];
+}
+
+void cellGcmFlush(CellGcmContextData*)
+{
+    g_GcmRecorder.Flushes++;
+    if (!g_GcmRecorder.Stalled)
+        g_GcmRecorder.Execute();
+}
+
+int sys_timer_usleep(usecond_t)
+{
+    g_GcmRecorder.Sleeps++;
+    g_GcmRecorder.Stalled = false;
+    g_GcmRecorder.Execute();
+    return CELL_OK;
+}
+
+void cellGcmCgInitProgram(CGprogram program)
+{
+    program->InitCount++;
+}
+
+void cellGcmCgGetUCode(CGprogram program, void** ucode, uint32_t* size)
+{
+    *ucode = (void*)program->UCode;
+    *size = program->UCodeSize;
+}
+
+CGparameter cellGcmCgGetNamedParameter(CGprogram program, const char* name)
+{
+    for (int i = 0; i < program->ParameterCount; i++)
+        if (strcmp(program->Parameters[i].Name, name) == 0)
+            return (CGparameter)&program->Parameters[i];
+    return NULL;
+}
+
+CGresource cellGcmCgGetParameterResource(CGprogram, CGparameter parameter)
+{
+    return parameter->Resource;
+}
+
+static void Emit(CellGcmContextData* context, uint32_t method, const uint32_t* args, uint32_t count)
+{
+    if (context->current + 1 + count > context->end)
+        context->callback(context, 1 + count);
+    *context->current++ = CELL_GCM_METHOD(method, count);
+    for (uint32_t i = 0; i < count; i++)
+        *context->current++ = args[i];
+}
+
+template<size_t N>
+static void Emit(CellGcmContextData* context, uint32_t method, const uint32_t (&args)[N])
+{
+    Emit(context, method, args, N);
+}
+
+static uint32_t FloatBits(float f)
+{
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+void cellGcmSetAlphaTestEnable(CellGcmContextData* context, uint32_t enable)
+{
+    const uint32_t args[] = { enable };
+    Emit(context, CELL_GCM_NV4097_SET_ALPHA_TEST_ENABLE, args);
+}
+
+void cellGcmSetBlendEnable(CellGcmContextData* context, uint32_t enable)
+{
+    const uint32_t args[] = { enable };
+    Emit(context, CELL_GCM_NV4097_SET_BLEND_ENABLE, args);
+}
+
+void cellGcmSetBlendFunc(CellGcmContextData* context, uint16_t sfcolor, uint16_t dfcolor, uint16_t sfalpha, uint16_t dfalpha)
+{
+    const uint32_t args[] = { ((uint32_t)sfalpha << 16) | sfcolor, ((uint32_t)dfalpha << 16) | dfcolor };
+    Emit(context, CELL_GCM_NV4097_SET_BLEND_FUNC_SFACTOR, args);
+}
+
+void cellGcmSetBlendEquation(CellGcmContextData* context, uint16_t color, uint16_t alpha)
+{
+    const uint32_t args[] = { ((uint32_t)alpha << 16) | color };
+    Emit(context, CELL_GCM_NV4097_SET_BLEND_EQUATION, args);
+}
+
+void cellGcmSetColorMask(CellGcmContextData* context, uint32_t attrib)
+{
+    const uint32_t args[] = { attrib };
+    Emit(context, CELL_GCM_NV4097_SET_COLOR_MASK, args);
+}
+
+void cellGcmSetCullFaceEnable(CellGcmContextData* context, uint32_t enable)
+{
+    const uint32_t args[] = { enable };
+    Emit(context, CELL_GCM_NV4097_SET_CULL_FACE_ENABLE, args);
+}
+
+void cellGcmSetDepthTestEnable(CellGcmContextData* context, uint32_t enable)
+{
+    const uint32_t args[] = { enable };
+    Emit(context, CELL_GCM_NV4097_SET_DEPTH_TEST_ENABLE, args);
+}
+
+void cellGcmSetStencilTestEnable(CellGcmContextData* context, uint32_t enable)
+{
+    const uint32_t args[] = { enable };
+    Emit(context, CELL_GCM_NV4097_SET_STENCIL_TEST_ENABLE, args);
+}
+
+void cellGcmSetViewport(CellGcmContextData* context, uint16_t x, uint16_t y, uint16_t w, uint16_t h, float min, float max, const float scale[4], const float offset[4])
+{
+    const uint32_t args[] =
+    {
+        ((uint32_t)w << 16) | x, ((uint32_t)h << 16) | y, FloatBits(min), FloatBits(max),
+        FloatBits(scale[0]), FloatBits(scale[1]), FloatBits(scale[2]), FloatBits(scale[3]),
+        FloatBits(offset[0]), FloatBits(offset[1]), FloatBits(offset[2]), FloatBits(offset[3]),
+    };
+    Emit(context, CELL_GCM_NV4097_SET_VIEWPORT_HORIZONTAL, args);
+}
+
+void cellGcmSetScissor(CellGcmContextData* context, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    const uint32_t args[] = { ((uint32_t)w << 16) | x, ((uint32_t)h << 16) | y };
+    Emit(context, CELL_GCM_NV4097_SET_SCISSOR_HORIZONTAL, args);
+}
+
+// The vertex program ucode goes through the command buffer
+void cellGcmSetVertexProgram(CellGcmContextData* context, CGprogram program, const void* ucode)
+{
+    Emit(context, CELL_GCM_NV4097_SET_TRANSFORM_PROGRAM, (const uint32_t*)ucode, program->UCodeSize / 4);
+}
+
+// A float4x4, the only kind of parameter imgui_impl_gcm.cpp sets
+void cellGcmSetVertexProgramParameter(CellGcmContextData* context, CGparameter parameter, const float* value)
+{
+    uint32_t args[1 + 16];
+    args[0] = (uint32_t)parameter->Resource;
+    for (int i = 0; i < 16; i++)
+        args[1 + i] = FloatBits(value[i]);
+    Emit(context, CELL_GCM_NV4097_SET_TRANSFORM_CONSTANT_LOAD, args);
+}
+
+void cellGcmSetFragmentProgram(CellGcmContextData* context, CGprogram, uint32_t offset)
+{
+    const uint32_t args[] = { offset };
+    Emit(context, CELL_GCM_NV4097_SET_SHADER_PROGRAM, args);
+}
+
+void cellGcmSetTexture(CellGcmContextData* context, uint8_t index, const CellGcmTexture* texture)
+{
+    const uint32_t args[] =
+    {
+        texture->offset, ((uint32_t)texture->format << 8) | ((uint32_t)texture->dimension << 4) | (texture->location + 1u),
+        ((uint32_t)texture->width << 16) | texture->height, texture->pitch, texture->remap,
+    };
+    Emit(context, CELL_GCM_NV4097_SET_TEXTURE_OFFSET + index * 32, args);
+}
+
+void cellGcmSetTextureControl(CellGcmContextData* context, uint8_t index, uint32_t enable, uint16_t minlod, uint16_t maxlod, uint8_t maxaniso)
+{
+    const uint32_t args[] = { (enable << 31) | ((uint32_t)minlod << 19) | ((uint32_t)maxlod << 7) | ((uint32_t)maxaniso << 4) };
+    Emit(context, CELL_GCM_NV4097_SET_TEXTURE_CONTROL0 + index * 32, args);
+}
+
+void cellGcmSetTextureFilter(CellGcmContextData* context, uint8_t index, uint16_t bias, uint8_t min, uint8_t mag, uint8_t conv)
+{
+    const uint32_t args[] = { ((uint32_t)mag << 24) | ((uint32_t)min << 16) | ((uint32_t)conv << 13) | bias };
+    Emit(context, CELL_GCM_NV4097_SET_TEXTURE_FILTER + index * 32, args);
+}
+
+void cellGcmSetTextureAddress(CellGcmContextData* context, uint8_t index, uint8_t wraps, uint8_t wrapt, uint8_t wrapr, uint8_t unsignedRemap, uint8_t zfunc, uint8_t gamma)
+{
+    const uint32_t args[] = { wraps | ((uint32_t)wrapt << 8) | ((uint32_t)unsignedRemap << 12) | ((uint32_t)wrapr << 16) | ((uint32_t)gamma << 20) | ((uint32_t)zfunc << 28) };
+    Emit(context, CELL_GCM_NV4097_SET_TEXTURE_ADDRESS + index * 32, args);
+}
+
+void cellGcmSetVertexDataArray(CellGcmContextData* context, uint8_t index, uint16_t frequency, uint8_t stride, uint8_t size, uint8_t type, uint8_t location, uint32_t offset)
+{
+    const uint32_t args[] = { ((uint32_t)location << 31) | offset, ((uint32_t)frequency << 16) | ((uint32_t)stride << 8) | ((uint32_t)size << 4) | type };
+    Emit(context, CELL_GCM_NV4097_SET_VERTEX_DATA_ARRAY_OFFSET + index * 4, args);
+}
+
+void cellGcmSetInvalidateVertexCache(CellGcmContextData* context)
+{
+    const uint32_t args[] = { 0 };
+    Emit(context, CELL_GCM_NV4097_INVALIDATE_VERTEX_CACHE_FILE, args);
+}
+
+void cellGcmSetDrawIndexArray(CellGcmContextData* context, uint8_t mode, uint32_t count, uint8_t type, uint8_t location, uint32_t indices)
+{
+    const uint32_t args[] = { indices, location | ((uint32_t)type << 4), mode, count };
+    Emit(context, CELL_GCM_NV4097_SET_INDEX_ARRAY_ADDRESS, args);
+}
+
+void cellGcmSetWriteBackEndLabel(CellGcmContextData* context, uint8_t index, uint32_t value)
+{
+    const uint32_t args[] = { (uint32_t)index << 4, value };
+    Emit(context, CELL_GCM_NV4097_SET_SEMAPHORE_OFFSET, args);
+}
@@ -0,0 +1,55 @@
+// Host side of the <cell/gcm.h> shim: the command buffer, RSX local memory and labels imgui_impl_gcm.cpp works with,
+// and an RSX stand-in that reads back what the emitters wrote.
+#pragma once
+#include <cell/gcm.h>
+#include <vector>
+
+// What the tests link in place of the sce-cgc binaries: ucode to upload, and where the named parameters are bound.
+struct _CGparameter
+{
+    const char*             Name;
+    CGresource              Resource;
+};
+
+struct _CGprogram
+{
+    const uint32_t*         UCode;
+    uint32_t                UCodeSize;
+    const _CGparameter*     Parameters;
+    int                     ParameterCount;
+    int                     InitCount;          // cellGcmCgInitProgram() calls
+};
+
+struct GcmMethod
+{
+    uint32_t                Method;
+    std::vector<uint32_t>   Args;
+};
+
+// The RSX only sees commands once Execute() runs: it decodes them into Methods and performs their label writes.
+// cellGcmFlush() executes unless Stalled is set; a stalled RSX catches up the first time the PPU sleeps,
+// and making room in a full command buffer always waits for it.
+struct GcmRecorder
+{
+    CellGcmContextData      Context;
+    std::vector<uint32_t>   CommandBuffer;
+    const uint32_t*         Executed;           // Next command Execute() reads
+    std::vector<uint8_t>    LocalMemoryStorage;
+    uint8_t*                LocalMemory;        // 128 bytes aligned, local offsets are relative to it
+    uint32_t                LocalMemorySize;
+    uint8_t*                MainMemory;         // Main memory mapped for the RSX, NULL = none
+    uint32_t                MainMemorySize;
+    uint32_t                Labels[256];
+    std::vector<GcmMethod>  Methods;            // Executed since the last Reset() or Methods.clear()
+    bool                    Stalled;
+    int                     Flushes;
+    int                     Sleeps;
+    int                     Wraps;              // Times the context callback had to make room
+
+    void                    Reset(uint32_t command_buffer_words, uint32_t local_memory_size);
+    void                    Execute();
+    int                     Count(uint32_t method) const;
+    const GcmMethod*        Find(uint32_t method, int n = 0) const;    // n-th executed 'method', NULL if there are fewer
+};
+
+extern GcmRecorder g_GcmRecorder;
@@ -0,0 +1,13 @@
+// Host definitions of the libc exports that Utils/Exports.hpp redirects to (_sys_malloc...), forwarding to the host's libc.
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+
+extern "C" void* _sys_malloc(size_t size) { return malloc(size); }
+extern "C" void _sys_free(void* ptr) { free(ptr); }
+extern "C" void* _sys_memalign(size_t boundary, size_t size) { return memalign(boundary, size); }
+extern "C" int _sys_memcmp(const void* s1, const void* s2, size_t n) { return memcmp(s1, s2, n); }
+extern "C" void* _sys_memcpy(void* dest, const void* src, size_t n) { return memcpy(dest, src, n); }
+extern "C" void* _sys_memset(void* m, int c, size_t n) { return memset(m, c, n); }
+extern "C" void* _sys_memmove(void* str1, const void* str2, size_t n) { return memmove(str1, str2, n); }
+extern "C" char* _sys_strncpy(char* dest, const char* src, size_t n) { return strncpy(dest, src, n); }
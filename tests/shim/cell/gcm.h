@@ -0,0 +1,150 @@
+// Host stand-in for the PS3 SDK's <cell/gcm.h>: the types, constants and command emitters imgui_impl_gcm.cpp uses.
+// Emitters write one method per call into the context's command buffer: a libgcm style header, (count << 18) | method,
+// followed by their arguments. See GcmRecorder.hpp for the side that reads them back.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#define CELL_OK                                     0
+#define CELL_GCM_ERROR_FAILURE                      0x802100ff
+
+#define CELL_GCM_FALSE                              0
+#define CELL_GCM_TRUE                               1
+
+#define CELL_GCM_LOCATION_LOCAL                     0
+#define CELL_GCM_LOCATION_MAIN                      1
+
+#define CELL_GCM_METHOD(method, count)              (((count) << 18) | (method))
+#define CELL_GCM_METHOD_GET_COUNT(header)           (((header) >> 18) & 0x7ff)
+#define CELL_GCM_METHOD_GET_METHOD(header)          ((header) & 0xfffc)
+
+// Methods, one per emitter (the first register the real emitter writes)
+#define CELL_GCM_NV4097_SET_ALPHA_TEST_ENABLE       0x00000304
+#define CELL_GCM_NV4097_SET_BLEND_ENABLE            0x00000310
+#define CELL_GCM_NV4097_SET_BLEND_FUNC_SFACTOR      0x00000314
+#define CELL_GCM_NV4097_SET_COLOR_MASK              0x00000324
+#define CELL_GCM_NV4097_SET_BLEND_EQUATION          0x00000340
+#define CELL_GCM_NV4097_SET_STENCIL_TEST_ENABLE     0x00000348
+#define CELL_GCM_NV4097_SET_SCISSOR_HORIZONTAL      0x000008c0
+#define CELL_GCM_NV4097_SET_SHADER_PROGRAM          0x000008e4
+#define CELL_GCM_NV4097_SET_VIEWPORT_HORIZONTAL     0x00000a00
+#define CELL_GCM_NV4097_SET_DEPTH_TEST_ENABLE       0x00000a74
+#define CELL_GCM_NV4097_SET_TRANSFORM_PROGRAM       0x00000b80
+#define CELL_GCM_NV4097_SET_VERTEX_DATA_ARRAY_OFFSET 0x00001680
+#define CELL_GCM_NV4097_INVALIDATE_VERTEX_CACHE_FILE 0x00001710
+#define CELL_GCM_NV4097_SET_INDEX_ARRAY_ADDRESS     0x0000181c
+#define CELL_GCM_NV4097_SET_CULL_FACE_ENABLE        0x00001830
+#define CELL_GCM_NV4097_SET_TEXTURE_OFFSET          0x00001a00
+#define CELL_GCM_NV4097_SET_TEXTURE_ADDRESS         0x00001a08
+#define CELL_GCM_NV4097_SET_TEXTURE_CONTROL0        0x00001a0c
+#define CELL_GCM_NV4097_SET_TEXTURE_FILTER          0x00001a14
+#define CELL_GCM_NV4097_SET_SEMAPHORE_OFFSET        0x00001d6c
+#define CELL_GCM_NV4097_SET_TRANSFORM_CONSTANT_LOAD 0x00001efc
+
+#define CELL_GCM_SRC_ALPHA                          0x0302
+#define CELL_GCM_ONE_MINUS_SRC_ALPHA                0x0303
+#define CELL_GCM_ONE                                1
+#define CELL_GCM_FUNC_ADD                           0x8006
+
+#define CELL_GCM_COLOR_MASK_B                       (1 << 0)
+#define CELL_GCM_COLOR_MASK_G                       (1 << 8)
+#define CELL_GCM_COLOR_MASK_R                       (1 << 16)
+#define CELL_GCM_COLOR_MASK_A                       (1 << 24)
+
+#define CELL_GCM_WINDOW_ORIGIN_TOP                  0
+
+#define CELL_GCM_VERTEX_F                           2
+#define CELL_GCM_VERTEX_UB                          4
+
+#define CELL_GCM_PRIMITIVE_TRIANGLES                5
+#define CELL_GCM_DRAW_INDEX_ARRAY_TYPE_32           0
+#define CELL_GCM_DRAW_INDEX_ARRAY_TYPE_16           1
+
+#define CELL_GCM_TEXTURE_B8                         0x81
+#define CELL_GCM_TEXTURE_A8R8G8B8                   0x85
+#define CELL_GCM_TEXTURE_SZ                         0x00
+#define CELL_GCM_TEXTURE_LN                         0x20
+#define CELL_GCM_TEXTURE_NR                         0x00
+#define CELL_GCM_TEXTURE_UN                         0x40
+#define CELL_GCM_TEXTURE_DIMENSION_2                2
+#define CELL_GCM_TEXTURE_REMAP_FROM_A               0
+#define CELL_GCM_TEXTURE_REMAP_FROM_R               1
+#define CELL_GCM_TEXTURE_REMAP_FROM_G               2
+#define CELL_GCM_TEXTURE_REMAP_FROM_B               3
+#define CELL_GCM_TEXTURE_REMAP_REMAP                2
+#define CELL_GCM_TEXTURE_MAX_ANISO_1                0
+#define CELL_GCM_TEXTURE_LINEAR                     2
+#define CELL_GCM_TEXTURE_CONVOLUTION_QUINCUNX       1
+#define CELL_GCM_TEXTURE_CLAMP_TO_EDGE              3
+#define CELL_GCM_TEXTURE_UNSIGNED_REMAP_NORMAL      0
+#define CELL_GCM_TEXTURE_ZFUNC_NEVER                0
+
+struct CellGcmContextData;
+typedef int32_t (*CellGcmContextCallback)(struct CellGcmContextData*, uint32_t);
+
+typedef struct CellGcmContextData
+{
+    uint32_t*                   begin;
+    uint32_t*                   end;
+    uint32_t*                   current;
+    CellGcmContextCallback      callback;       // Called when an emitter doesn't fit before 'end', must make room
+} CellGcmContextData;
+
+extern CellGcmContextData* gCellGcmCurrentContext;
+
+typedef struct CellGcmTexture
+{
+    uint8_t                     format;
+    uint8_t                     mipmap;
+    uint8_t                     dimension;
+    uint8_t                     cubemap;
+    uint32_t                    remap;
+    uint16_t                    width;
+    uint16_t                    height;
+    uint16_t                    depth;
+    uint8_t                     location;
+    uint8_t                     _padding;
+    uint32_t                    pitch;
+    uint32_t                    offset;
+} CellGcmTexture;
+
+// Cg runtime: programs are opaque here, GcmRecorder.hpp defines what the tests link in place of the compiled binaries.
+typedef struct _CGprogram* CGprogram;
+typedef struct _CGparameter* CGparameter;
+typedef enum CGresource
+{
+    CG_TEXUNIT0 = 2048,
+    CG_ATTR0 = 2113,
+    CG_C = 2178,
+} CGresource;
+
+int32_t cellGcmAddressToOffset(const void* address, uint32_t* offset);
+uint32_t* cellGcmGetLabelAddress(uint8_t index);
+void cellGcmFlush(CellGcmContextData* context);
+
+void cellGcmCgInitProgram(CGprogram program);
+void cellGcmCgGetUCode(CGprogram program, void** ucode, uint32_t* size);
+CGparameter cellGcmCgGetNamedParameter(CGprogram program, const char* name);
+CGresource cellGcmCgGetParameterResource(CGprogram program, CGparameter parameter);
+
+void cellGcmSetAlphaTestEnable(CellGcmContextData* context, uint32_t enable);
+void cellGcmSetBlendEnable(CellGcmContextData* context, uint32_t enable);
+void cellGcmSetBlendFunc(CellGcmContextData* context, uint16_t sfcolor, uint16_t dfcolor, uint16_t sfalpha, uint16_t dfalpha);
+void cellGcmSetBlendEquation(CellGcmContextData* context, uint16_t color, uint16_t alpha);
+void cellGcmSetColorMask(CellGcmContextData* context, uint32_t attrib);
+void cellGcmSetCullFaceEnable(CellGcmContextData* context, uint32_t enable);
+void cellGcmSetDepthTestEnable(CellGcmContextData* context, uint32_t enable);
+void cellGcmSetStencilTestEnable(CellGcmContextData* context, uint32_t enable);
+void cellGcmSetViewport(CellGcmContextData* context, uint16_t x, uint16_t y, uint16_t w, uint16_t h, float min, float max, const float scale[4], const float offset[4]);
+void cellGcmSetScissor(CellGcmContextData* context, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+void cellGcmSetVertexProgram(CellGcmContextData* context, CGprogram program, const void* ucode);
+void cellGcmSetVertexProgramParameter(CellGcmContextData* context, CGparameter parameter, const float* value);
+void cellGcmSetFragmentProgram(CellGcmContextData* context, CGprogram program, uint32_t offset);
+void cellGcmSetTexture(CellGcmContextData* context, uint8_t index, const CellGcmTexture* texture);
+void cellGcmSetTextureControl(CellGcmContextData* context, uint8_t index, uint32_t enable, uint16_t minlod, uint16_t maxlod, uint8_t maxaniso);
+void cellGcmSetTextureFilter(CellGcmContextData* context, uint8_t index, uint16_t bias, uint8_t min, uint8_t mag, uint8_t conv);
+void cellGcmSetTextureAddress(CellGcmContextData* context, uint8_t index, uint8_t wraps, uint8_t wrapt, uint8_t wrapr, uint8_t unsignedRemap, uint8_t zfunc, uint8_t gamma);
+void cellGcmSetVertexDataArray(CellGcmContextData* context, uint8_t index, uint16_t frequency, uint8_t stride, uint8_t size, uint8_t type, uint8_t location, uint32_t offset);
+void cellGcmSetInvalidateVertexCache(CellGcmContextData* context);
+void cellGcmSetDrawIndexArray(CellGcmContextData* context, uint8_t mode, uint32_t count, uint8_t type, uint8_t location, uint32_t indices);
+void cellGcmSetWriteBackEndLabel(CellGcmContextData* context, uint8_t index, uint32_t value);
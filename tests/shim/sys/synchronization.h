@@ -0,0 +1,26 @@
+// Host stand-in for the lightweight mutexes of the PS3 SDK's <sys/synchronization.h>, on top of pthreads.
+// Only what the code under test uses.
+#pragma once
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint64_t usecond_t;
+
+typedef struct sys_lwmutex_attribute_t
+{
+    char             name[8];
+} sys_lwmutex_attribute_t;
+
+typedef struct sys_lwmutex_t
+{
+    pthread_mutex_t  mutex;
+} sys_lwmutex_t;
+
+#define sys_lwmutex_attribute_initialize(x) ((x).name[0] = '\0')
+#define sys_lwmutex_attribute_name_set(x, s) (strncpy((x), (s), 7), (x)[7] = '\0')
+
+static inline int sys_lwmutex_create(sys_lwmutex_t* lwmutex, const sys_lwmutex_attribute_t*) { return pthread_mutex_init(&lwmutex->mutex, NULL); }
+static inline int sys_lwmutex_destroy(sys_lwmutex_t* lwmutex) { return pthread_mutex_destroy(&lwmutex->mutex); }
+static inline int sys_lwmutex_lock(sys_lwmutex_t* lwmutex, usecond_t) { return pthread_mutex_lock(&lwmutex->mutex); }
+static inline int sys_lwmutex_unlock(sys_lwmutex_t* lwmutex) { return pthread_mutex_unlock(&lwmutex->mutex); }
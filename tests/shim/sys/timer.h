@@ -0,0 +1,7 @@
+// Host stand-in for the PS3 SDK's <sys/timer.h>. Sleeping gives the recorded RSX time to catch up, see GcmRecorder.hpp.
+#pragma once
+#include <stdint.h>
+
+typedef uint64_t usecond_t;
+
+int sys_timer_usleep(usecond_t sleep_time);
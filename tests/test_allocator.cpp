@@ -0,0 +1,176 @@
+// Size class allocator of the prx: alignment, statistics and reuse, and how it compares with the host's malloc.
+#include "Test.hpp"
+#include "Allocator.hpp"
+#include "imgui.h"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static bool IsAligned(const void* ptr, size_t alignment)
+{
+    return ((uintptr_t)ptr & (alignment - 1)) == 0;
+}
+
+static void TestAlignment()
+{
+    Allocator allocator;
+    std::vector<void*> blocks;
+    for (size_t size = 0; size <= Allocator::MaxSmallSize + 64; size += 7)
+    {
+        void* ptr = allocator.Allocate(size);
+        TEST_CHECK(ptr != nullptr && IsAligned(ptr, Allocator::Alignment));
+        memset(ptr, 0xAB, size);
+        blocks.push_back(ptr);
+    }
+
+    const size_t alignments[] = { 32, 128, 4096, 65536 };
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++)
+        for (size_t size = 1; size < 10000; size = size * 3 + 1)
+        {
+            void* ptr = allocator.AllocateAligned(size, alignments[i]);
+            TEST_CHECK(ptr != nullptr && IsAligned(ptr, alignments[i]));
+            memset(ptr, 0xCD, size);
+            blocks.push_back(ptr);
+        }
+
+    for (size_t i = 0; i < blocks.size(); i++)
+        allocator.Free(blocks[i]);
+    allocator.Free(nullptr);
+
+    const Allocator::Stats stats = allocator.GetStats();
+    TEST_CHECK(stats.LiveBytes == 0 && stats.LiveAllocations == 0 && stats.LargeAllocations == 0);
+    TEST_CHECK(stats.TotalAllocations == blocks.size());
+}
+
+static void TestStats()
+{
+    Allocator allocator;
+    void* a = allocator.Allocate(100);
+    void* b = allocator.Allocate(3000);
+    allocator.NewFrame();
+    void* c = allocator.Allocate(20);
+
+    Allocator::Stats stats = allocator.GetStats();
+    TEST_CHECK(stats.LiveBytes == 3120 && stats.PeakBytes == 3120);
+    TEST_CHECK(stats.LiveAllocations == 3 && stats.LargeAllocations == 1);
+    TEST_CHECK(stats.LastFrameAllocations == 2 && stats.FrameAllocations == 1);
+    TEST_CHECK(stats.ReservedBytes >= Allocator::ChunkSize * 2 + 3000);
+
+    allocator.Free(b);
+    allocator.NewFrame();
+    stats = allocator.GetStats();
+    TEST_CHECK(stats.LiveBytes == 120 && stats.PeakBytes == 3120);
+    TEST_CHECK(stats.LargeAllocations == 0 && stats.ReservedBytes == Allocator::ChunkSize * 2);
+    TEST_CHECK(stats.LastFrameAllocations == 1 && stats.FrameAllocations == 0);
+
+    allocator.Free(a);
+    allocator.Free(c);
+}
+
+static void TestReuse()
+{
+    Allocator allocator;
+
+    // A freed block goes back to its class and is the next one handed out
+    void* a = allocator.Allocate(40);
+    void* b = allocator.Allocate(40);
+    allocator.Free(a);
+    TEST_CHECK(allocator.Allocate(33) == a);
+    TEST_CHECK(allocator.Allocate(48) != b);
+
+    // Churning through one class doesn't take more chunks
+    std::vector<void*> blocks;
+    for (int round = 0; round < 100; round++)
+    {
+        for (int i = 0; i < 200; i++)
+            blocks.push_back(allocator.Allocate(64));
+        for (size_t i = 0; i < blocks.size(); i++)
+            allocator.Free(blocks[i]);
+        blocks.clear();
+    }
+    // 48 byte class: one chunk; 64 byte class: 200 blocks of 80 bytes fit in one chunk
+    TEST_CHECK(allocator.GetStats().ReservedBytes == Allocator::ChunkSize * 2);
+
+    // ImGui's allocator functions go through the same allocator
+    void* p = Allocator::ImGuiAlloc(10, &allocator);
+    TEST_CHECK(p != nullptr && allocator.GetStats().LiveAllocations == 4);
+    Allocator::ImGuiFree(p, &allocator);
+    TEST_CHECK(allocator.GetStats().LiveAllocations == 3);
+}
+
+// Dear ImGui running on the allocator, installed the way a prx linking it would: every allocation of a frame comes back on DestroyContext().
+static void TestImGuiAllocator()
+{
+    Allocator allocator;
+    ImGuiMemAllocFunc previous_alloc;
+    ImGuiMemFreeFunc previous_free;
+    void* previous_user_data;
+    ImGui::GetAllocatorFunctions(&previous_alloc, &previous_free, &previous_user_data);
+    ImGui::SetAllocatorFunctions(Allocator::ImGuiAlloc, Allocator::ImGuiFree, &allocator);
+
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(1280.0f, 720.0f);
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+    for (int frame = 0; frame < 3; frame++)
+    {
+        ImGui::NewFrame();
+        ImGui::Begin("Allocator");
+        ImGui::Text("Frame %d", frame);
+        ImGui::End();
+        ImGui::Render();
+    }
+    const Allocator::Stats running = allocator.GetStats();
+    TEST_CHECK(running.LiveAllocations > 0 && running.TotalAllocations >= running.LiveAllocations);
+    TEST_CHECK(running.LargeAllocations > 0);       // The font atlas
+
+    ImGui::DestroyContext();
+    const Allocator::Stats destroyed = allocator.GetStats();
+    TEST_CHECK(destroyed.LiveAllocations == 0 && destroyed.LiveBytes == 0 && destroyed.LargeAllocations == 0);
+
+    ImGui::SetAllocatorFunctions(previous_alloc, previous_free, previous_user_data);
+}
+
+static void BenchAllocate()
+{
+    // Mix of sizes as the prx allocates them: mostly small, some large
+    std::vector<size_t> sizes(10000);
+    srand(7);
+    for (size_t i = 0; i < sizes.size(); i++)
+        sizes[i] = (rand() % 16 == 0) ? 2048 + rand() % 8192 : 8 + rand() % 256;
+    std::vector<void*> blocks(sizes.size());
+
+    Allocator allocator;
+    const double custom = BenchmarkBest(20, [&]()
+    {
+        for (size_t i = 0; i < sizes.size(); i++)
+            blocks[i] = allocator.Allocate(sizes[i]);
+        for (size_t i = 0; i < sizes.size(); i += 2)
+            allocator.Free(blocks[i]);
+        for (size_t i = 1; i < sizes.size(); i += 2)
+            allocator.Free(blocks[i]);
+    });
+    const double system = BenchmarkBest(20, [&]()
+    {
+        for (size_t i = 0; i < sizes.size(); i++)
+            blocks[i] = malloc(sizes[i]);
+        for (size_t i = 0; i < sizes.size(); i += 2)
+            free(blocks[i]);
+        for (size_t i = 1; i < sizes.size(); i += 2)
+            free(blocks[i]);
+    });
+    printf("  %d allocations and frees: Allocator %.1f us, host malloc %.1f us\n", (int)sizes.size(), custom, system);
+}
+
+void RunAllocatorTests(bool bench)
+{
+    TestAlignment();
+    TestStats();
+    TestReuse();
+    TestImGuiAllocator();
+
+    if (bench)
+        BenchAllocate();
+}
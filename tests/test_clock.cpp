@@ -0,0 +1,75 @@
+// Clock ticks to io.DeltaTime in the PlayStation 3 platform backend (imgui_impl_playstation3_internal.h).
+#include "Test.hpp"
+#include "imgui_impl_playstation3_internal.h"
+#include <math.h>
+#include <random>
+
+static const ImU64 TIMEBASE_FREQUENCY = 79800000;       // sys_time_get_timebase_frequency() on retail consoles
+
+static bool Near(double value, double expected, double relative_error)
+{
+    return fabs(value - expected) <= fabs(expected) * relative_error;
+}
+
+// Any delta, however far the time base has run: as exact as a float gets, and never zero.
+static void TestTimeBase()
+{
+    const ImU64 one_month = TIMEBASE_FREQUENCY * 60 * 60 * 24 * 30;
+    const ImU64 bases[] = { 0, 1ull << 32, one_month, 1ull << 56, (1ull << 63) + 12345 };
+    const ImU64 deltas[] = { 1, 1000, TIMEBASE_FREQUENCY / 60, TIMEBASE_FREQUENCY / 30 + 1, TIMEBASE_FREQUENCY, TIMEBASE_FREQUENCY * 10 };
+    for (int b = 0; b < IM_ARRAYSIZE(bases); b++)
+        for (int d = 0; d < IM_ARRAYSIZE(deltas); d++)
+        {
+            const float seconds = ImGui_ImplPlaystation3_TicksToSeconds(bases[b], bases[b] + deltas[d], TIMEBASE_FREQUENCY);
+            const double expected = (double)deltas[d] / (double)TIMEBASE_FREQUENCY;
+            if (!(seconds > 0.0f && Near(seconds, expected, 1e-7)))
+                printf("time base %llu + %llu ticks: %.9g s, expected %.9g s\n", (unsigned long long)bases[b], (unsigned long long)deltas[d], seconds, expected);
+            TEST_CHECK(seconds > 0.0f && Near(seconds, expected, 1e-7));
+        }
+
+    // A 60 Hz frame is 1330000 ticks
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(one_month, one_month + 1330000, TIMEBASE_FREQUENCY) == (float)(1.0 / 60.0));
+}
+
+// The clock didn't move forward: a 60 Hz frame rather than zero or a huge unsigned difference.
+static void TestNotForward()
+{
+    const ImU64 now = 123456789012ull;
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(now, now, TIMEBASE_FREQUENCY) == 1.0f / 60.0f);
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(now, now - 1, TIMEBASE_FREQUENCY) == 1.0f / 60.0f);
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(now, 0, TIMEBASE_FREQUENCY) == 1.0f / 60.0f);
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(~0ull, 0, 1000) == 1.0f / 60.0f);
+}
+
+// Replacement clocks (ImGui_ImplPlaystation3_SetClock) at other rates.
+static void TestCustomClocks()
+{
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(5000, 5016, 1000) == 0.016f);
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(1, 2, 1) == 1.0f);
+    TEST_CHECK(Near(ImGui_ImplPlaystation3_TicksToSeconds(1000000, 1016667, 1000000), 0.016667, 1e-7));
+    TEST_CHECK(ImGui_ImplPlaystation3_TicksToSeconds(0, 1, ~0ull) > 0.0f);
+}
+
+// A long run of jittery frames adds up to the time that passed: no bias creeps into the conversion.
+static void TestAccumulate()
+{
+    std::mt19937 rng(42);
+    const ImU64 start = TIMEBASE_FREQUENCY * 60 * 60 * 24 * 7;
+    ImU64 now = start;
+    double total = 0.0;
+    for (int frame = 0; frame < 100000; frame++)
+    {
+        const ImU64 next = now + TIMEBASE_FREQUENCY / 60 + rng() % (TIMEBASE_FREQUENCY / 100);
+        total += ImGui_ImplPlaystation3_TicksToSeconds(now, next, TIMEBASE_FREQUENCY);
+        now = next;
+    }
+    TEST_CHECK(Near(total, (double)(now - start) / (double)TIMEBASE_FREQUENCY, 1e-7));
+}
+
+void RunClockTests(bool)
+{
+    TestTimeBase();
+    TestNotForward();
+    TestCustomClocks();
+    TestAccumulate();
+}
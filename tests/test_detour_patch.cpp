@@ -0,0 +1,362 @@
+// Hook and trampoline assembly of the prx hook example's Detour (DetourPatch), committed through a counting memory writer.
+#include "Test.hpp"
+#include "DetourPatch.hpp"
+#include "PowerPC.hpp"
+#include <random>
+#include <string.h>
+#include <vector>
+
+// Stand-in for the process memory: the hooked function and the trampoline slot, at 32 bit addresses like on the console.
+struct FakeRegion
+{
+    uint32_t                Address;
+    std::vector<uint8_t>    Bytes;
+};
+
+static FakeRegion   s_Code;
+static FakeRegion   s_Slot;
+static int          s_Writes;
+static uint32_t     s_LastAddress;
+static size_t       s_LastSize;
+static int          s_FailWrites;           // Writer returns an error while non-zero
+static int          s_FailAtWrite;          // That write (1 based) lands in part then returns an error, 0 for none
+
+// Counts the writes, every one a syscall on the console, and refuses anything straddling or outside the regions.
+static int CountingWriter(uint32_t, void* address, const void* data, size_t size)
+{
+    s_Writes++;
+    s_LastAddress = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(address));
+    s_LastSize = size;
+    if (s_FailWrites > 0)
+    {
+        s_FailWrites--;
+        return -1;
+    }
+    FakeRegion* regions[] = { &s_Code, &s_Slot };
+    for (int n = 0; n < 2; n++)
+    {
+        const uint32_t offset = s_LastAddress - regions[n]->Address;
+        if (offset < regions[n]->Bytes.size() && size <= regions[n]->Bytes.size() - offset)
+        {
+            const bool fail = s_Writes == s_FailAtWrite;
+            memcpy(&regions[n]->Bytes[offset], data, fail ? (size / 2) & ~3u : size);
+            return fail ? -1 : 0;
+        }
+    }
+    return -1;
+}
+
+static void ResetRegions(uint32_t codeAddress, const uint32_t* code, size_t codeWords, uint32_t slotAddress, size_t slotCount = 1)
+{
+    s_Code.Address = codeAddress;
+    s_Code.Bytes.assign(reinterpret_cast<const uint8_t*>(code), reinterpret_cast<const uint8_t*>(code + codeWords));
+    s_Slot.Address = slotAddress;
+    s_Slot.Bytes.assign(TrampolinePool::SlotSize * slotCount, 0xCC);
+    s_Writes = 0;
+    s_FailWrites = 0;
+    s_FailAtWrite = 0;
+}
+
+static uint32_t ReadWord(const uint8_t* bytes, size_t offset)
+{
+    uint32_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    return word;
+}
+
+/***
+* Where an unconditional jump assembled by PowerPC::AssembleBranch() at the end of 'bytes' goes.
+* @returns false if the last instruction isn't a 'b' nor the bctr of a lis/ori/mtctr/bctr sequence
+*/
+static bool JumpTarget(const uint8_t* bytes, size_t size, uint32_t address, uint32_t* target)
+{
+    if (size < 4 || size % 4 != 0)
+        return false;
+    const PowerPC::Instruction Last = PowerPC::Decode(ReadWord(bytes, size - 4));
+    if (Last.Type == PowerPC::InstructionType_Branch)
+    {
+        *target = address + static_cast<uint32_t>(size - 4) + Last.Displacement;
+        return !Last.Absolute && !Last.Linked;
+    }
+    if (Last.Raw != POWERPC_BCCTR(POWERPC_BRANCH_OPTIONS_ALWAYS, 0, 0))
+        return false;
+
+    // Far branch: the target is loaded by the last lis/ori pair, relocated branches before it may have their own
+    for (int offset = (int)size - 8; offset >= 0; offset -= 4)
+    {
+        const uint32_t Lis = ReadWord(bytes, offset), Ori = ReadWord(bytes, offset + 4);
+        if ((Lis & 0xFFFF0000) == POWERPC_LIS(POWERPC_REGISTERINDEX_R0, 0) && (Ori & 0xFFFF0000) == POWERPC_ORI(POWERPC_REGISTERINDEX_R0, POWERPC_REGISTERINDEX_R0, 0))
+        {
+            *target = ((Lis & 0xFFFF) << 16) | (Ori & 0xFFFF);
+            return true;
+        }
+    }
+    return false;
+}
+
+/***
+* Assembles, then commits the trampoline, the hook and the restore through the counting writer, checking each is a single write of
+* its whole region and leaves the rest of the memory alone.
+* @param assembled Set to false when the function was refused, nullptr if it must not be.
+* @returns number of failed checks
+*/
+static int HookCycle(const uint32_t* code, size_t codeWords, uint32_t hookAddress, uint32_t hookTarget, uint32_t trampolineAddress, DetourPatch* patch,
+    bool* assembled = nullptr)
+{
+    int errors = 0;
+    ResetRegions(hookAddress, code, codeWords, trampolineAddress);
+    const std::vector<uint8_t> OriginalCode = s_Code.Bytes;
+    const std::vector<uint8_t> OriginalSlot = s_Slot.Bytes;
+
+    // Nothing is written while assembling, nor at all when the function can't be hooked (bdnz out of the trampoline's reach)
+    const bool Assembled = patch->Assemble(code, hookAddress, hookTarget, trampolineAddress);
+    errors += s_Writes != 0 || s_Code.Bytes != OriginalCode || s_Slot.Bytes != OriginalSlot ? 1 : 0;
+    if (assembled != nullptr)
+        *assembled = Assembled;
+    if (!Assembled)
+        return errors + (assembled == nullptr ? 1 : 0);
+    errors += patch->HookSize == 0 || patch->HookSize > DetourPatch::MaxHookSize || patch->TrampolineSize > TrampolinePool::SlotSize ? 1 : 0;
+    errors += memcmp(patch->Original, code, patch->HookSize) != 0 ? 1 : 0;
+
+    // Trampoline: one write covering exactly the assembled bytes, the function untouched
+    errors += !patch->WriteTrampoline(CountingWriter, 1) ? 1 : 0;
+    errors += s_Writes != 1 || s_LastAddress != trampolineAddress || s_LastSize != patch->TrampolineSize ? 1 : 0;
+    errors += memcmp(&s_Slot.Bytes[0], patch->Trampoline, patch->TrampolineSize) != 0 || s_Code.Bytes != OriginalCode ? 1 : 0;
+    for (size_t n = patch->TrampolineSize; n < s_Slot.Bytes.size(); n++)
+        errors += s_Slot.Bytes[n] != 0xCC ? 1 : 0;
+
+    // Hook: one write of HookSize bytes, what follows in the function is left alone
+    errors += !patch->WriteHook(CountingWriter, 1) ? 1 : 0;
+    errors += s_Writes != 2 || s_LastAddress != hookAddress || s_LastSize != patch->HookSize ? 1 : 0;
+    errors += memcmp(&s_Code.Bytes[0], patch->Hook, patch->HookSize) != 0 ? 1 : 0;
+    errors += memcmp(&s_Code.Bytes[patch->HookSize], &OriginalCode[patch->HookSize], OriginalCode.size() - patch->HookSize) != 0 ? 1 : 0;
+
+    // The hook goes to the callback and the trampoline comes back right after the hook
+    uint32_t Target = 0;
+    errors += !JumpTarget(&s_Code.Bytes[0], patch->HookSize, hookAddress, &Target) || Target != hookTarget ? 1 : 0;
+    errors += !JumpTarget(&s_Slot.Bytes[0], patch->TrampolineSize, trampolineAddress, &Target) || Target != hookAddress + patch->HookSize ? 1 : 0;
+
+    // Restore: one write, the function is byte for byte what it was
+    errors += !patch->Restore(CountingWriter, 1) ? 1 : 0;
+    errors += s_Writes != 3 || s_LastAddress != hookAddress || s_LastSize != patch->HookSize ? 1 : 0;
+    errors += s_Code.Bytes != OriginalCode ? 1 : 0;
+    return errors;
+}
+
+// Plain instructions that don't depend on where they run.
+static const uint32_t s_PlainCode[] =
+{
+    POWERPC_STD(POWERPC_REGISTERINDEX_R31, -0x8, POWERPC_REGISTERINDEX_R1),
+    POWERPC_LI(POWERPC_REGISTERINDEX_R3, 0x10),
+    POWERPC_ORI(POWERPC_REGISTERINDEX_R4, POWERPC_REGISTERINDEX_R3, 0x1234),
+    POWERPC_ADDI(POWERPC_REGISTERINDEX_R5, POWERPC_REGISTERINDEX_R4, 0x20),
+    POWERPC_LD(POWERPC_REGISTERINDEX_R31, -0x8, POWERPC_REGISTERINDEX_R1),
+    POWERPC_BCCTR(POWERPC_BRANCH_OPTIONS_ALWAYS, 0, 0),
+    POWERPC_LI(POWERPC_REGISTERINDEX_R3, 0),
+    POWERPC_LI(POWERPC_REGISTERINDEX_R4, 0),
+};
+
+// A callback within ±32 MB: a single 'b' over the first instruction, and a single 'b' back when the slot is close too.
+static void TestNearHook()
+{
+    DetourPatch patch;
+    TEST_CHECK(HookCycle(s_PlainCode, 8, 0x00010200, 0x00410000, 0x00020000, &patch) == 0);
+    TEST_CHECK(patch.HookSize == 4 && patch.TrampolineSize == 8);
+    TEST_CHECK(memcmp(patch.Trampoline, s_PlainCode, 4) == 0);
+
+    // Slot out of reach of the function: the way back is a far branch, still one write
+    TEST_CHECK(HookCycle(s_PlainCode, 8, 0x00010200, 0x00410000, 0x40000000, &patch) == 0);
+    TEST_CHECK(patch.HookSize == 4 && patch.TrampolineSize == 4 + 24);
+}
+
+// A callback out of range: lis/ori/mtctr/bctr overwrite four instructions, all relocated into the trampoline.
+static void TestFarHook()
+{
+    DetourPatch patch;
+    TEST_CHECK(HookCycle(s_PlainCode, 8, 0x00010200, 0x30000000, 0x00020000, &patch) == 0);
+    TEST_CHECK(patch.HookSize == 16 && patch.TrampolineSize == 16 + 4);
+    TEST_CHECK(memcmp(patch.Trampoline, s_PlainCode, 16) == 0);
+}
+
+// Relative branches among the overwritten instructions are re-targeted, and expand when the slot is out of their reach.
+static void TestRelativeBranches()
+{
+    const uint32_t hookAddress = 0x00010200;
+    const uint32_t code[] =
+    {
+        POWERPC_BC(12, 2, 0x40, false, false),              // beq +0x40
+        POWERPC_B(0x100, false, true),                      // bl +0x100
+        POWERPC_B(4, false, true),                          // bl $+4
+        POWERPC_B(-0x20, false, false),                     // b -0x20
+        POWERPC_LI(POWERPC_REGISTERINDEX_R3, 0),
+        POWERPC_LI(POWERPC_REGISTERINDEX_R4, 0),
+    };
+    DetourPatch patch;
+
+    // Near slot: the jumps stay a single 'b' pointing where they used to, beq hops over one and 'bl $+4' becomes a link register load
+    TEST_CHECK(HookCycle(code, 6, hookAddress, 0x30000000, 0x00012000, &patch) == 0);
+    TEST_CHECK(patch.HookSize == 16);
+    const PowerPC::Instruction Taken = PowerPC::Decode(ReadWord(patch.Trampoline, 8));
+    TEST_CHECK(ReadWord(patch.Trampoline, 0) == POWERPC_BC(12, 2, 8, false, false));
+    TEST_CHECK(Taken.Type == PowerPC::InstructionType_Branch && 0x00012000 + 8 + Taken.Displacement == hookAddress + 0x40);
+    const uint32_t BackOffset = (uint32_t)patch.TrampolineSize - 8;     // Before the 'b' back to the function
+    const PowerPC::Instruction Back = PowerPC::Decode(ReadWord(patch.Trampoline, BackOffset));
+    TEST_CHECK(Back.Type == PowerPC::InstructionType_Branch && 0x00012000 + BackOffset + Back.Displacement == hookAddress + 12 - 0x20);
+
+    // Far slot: expanded, yet the trampoline and the hook are still one write each
+    TEST_CHECK(HookCycle(code, 6, hookAddress, 0x30000000, 0x40000000, &patch) == 0);
+    TEST_CHECK(patch.TrampolineSize > 16 + 24 && patch.TrampolineSize <= TrampolinePool::SlotSize);
+}
+
+// A failing write reports failure, and writes nothing more than the one attempt.
+static void TestWriteFailure()
+{
+    DetourPatch patch;
+    ResetRegions(0x00010200, s_PlainCode, 8, 0x00020000);
+    patch.Assemble(s_PlainCode, 0x00010200, 0x00410000, 0x00020000);
+    const std::vector<uint8_t> OriginalCode = s_Code.Bytes;
+
+    s_FailWrites = 3;
+    TEST_CHECK(!patch.WriteTrampoline(CountingWriter, 1) && s_Writes == 1);
+    TEST_CHECK(!patch.WriteHook(CountingWriter, 1) && s_Writes == 2);
+    TEST_CHECK(!patch.Restore(CountingWriter, 1) && s_Writes == 3);
+    TEST_CHECK(s_Code.Bytes == OriginalCode);
+}
+
+// Random functions, callbacks and slots anywhere in the 32 bit address space: always one write per region.
+static void TestRandomHooks()
+{
+    std::mt19937 rng(13);
+    DetourPatch patch;
+    int errors = 0;
+    size_t far_hooks = 0, expanded = 0, refused = 0;
+    for (int n = 0; n < 2000; n++)
+    {
+        uint32_t code[8];
+        for (int i = 0; i < 8; i++)
+        {
+            switch (rng() % 5)
+            {
+            case 0:  code[i] = POWERPC_B(((int32_t)(rng() % 0x4000000) - 0x2000000), false, rng() % 2); break;
+            case 1:  code[i] = POWERPC_BC(12, rng() % 32, ((int32_t)(rng() % 0x10000) - 0x8000), false, rng() % 2); break;
+            case 2:  code[i] = POWERPC_BC(16, 0, ((int32_t)(rng() % 0x10000) - 0x8000), false, false); break;     // bdnz
+            case 3:  code[i] = POWERPC_B(4, false, true); break;                                                        // bl $+4
+            default: code[i] = s_PlainCode[rng() % 8]; break;
+            }
+        }
+
+        // Addresses near each other half of the time, anywhere otherwise
+        const uint32_t hookAddress = rng() & ~31u;
+        const uint32_t hookTarget = rng() % 2 ? hookAddress + ((rng() % 0x2000000) & ~3u) - 0x1000000 : rng() & ~3u;
+        const uint32_t trampolineAddress = rng() % 2 ? hookAddress + ((rng() % 0x1000000) & ~3u) + 0x100 : rng() & ~3u;
+        if (trampolineAddress - hookAddress < sizeof(code) || hookAddress - trampolineAddress < TrampolinePool::SlotSize)
+            continue;
+
+        bool assembled = true;
+        int failed = HookCycle(code, 8, hookAddress, hookTarget, trampolineAddress, &patch, &assembled);
+        if (!assembled)
+        {
+            // Only a bdnz among the overwritten instructions is a reason to refuse
+            bool bdnz = false;
+            for (size_t i = 0; i < patch.HookSize / 4; i++)
+                bdnz |= (code[i] & 0xFFE00000) == POWERPC_BC(16, 0, 0, false, false);
+            failed += bdnz ? 0 : 1;
+            refused++;
+        }
+        if (failed != 0 && errors < 5)
+            printf("detour patch: hook at 0x%08X to 0x%08X, slot 0x%08X failed %d checks\n", hookAddress, hookTarget, trampolineAddress, failed);
+        errors += failed;
+        far_hooks += assembled && patch.HookSize > 4 ? 1 : 0;
+        expanded += assembled && patch.TrampolineSize > patch.HookSize + 24 ? 1 : 0;
+    }
+    TEST_CHECK(errors == 0);
+    TEST_CHECK(far_hooks > 300 && expanded > 100 && refused > 50);
+}
+
+// A transaction's worth of hooks on neighbouring functions, half of them with far callbacks (see DetourTransaction::Commit).
+static const int        TransactionSize = 6;
+static const uint32_t   TransactionCode = 0x00010000;
+static const uint32_t   TransactionSlots = 0x00020000;
+static const size_t     FunctionWords = 8;
+
+static void AssembleTransaction(DetourPatch* patches, const DetourPatch** pointers)
+{
+    std::vector<uint32_t> code;
+    for (int n = 0; n < TransactionSize; n++)
+    {
+        // Every function starts differently, so a restore swapped with another one would show
+        for (size_t i = 0; i < FunctionWords; i++)
+            code.push_back(s_PlainCode[(i + n) % 8] ^ (uint32_t)(n << 8));
+        code[n * FunctionWords + 1] = POWERPC_BC(12, 2, 0x40, false, false);
+    }
+    ResetRegions(TransactionCode, code.data(), code.size(), TransactionSlots, TransactionSize);
+    for (int n = 0; n < TransactionSize; n++)
+    {
+        const uint32_t hookAddress = TransactionCode + n * FunctionWords * 4;
+        const uint32_t hookTarget = n % 2 ? 0x30000000 + n * 0x100 : 0x00400000 + n * 0x100;
+        TEST_CHECK(patches[n].Assemble(&code[n * FunctionWords], hookAddress, hookTarget, TransactionSlots + n * TrampolinePool::SlotSize));
+        pointers[n] = &patches[n];
+    }
+}
+
+// Every trampoline, then every hook: one write each, and the functions all end up hooked.
+static void TestCommitAll()
+{
+    DetourPatch patches[TransactionSize];
+    const DetourPatch* pointers[TransactionSize];
+    AssembleTransaction(patches, pointers);
+    const std::vector<uint8_t> OriginalCode = s_Code.Bytes;
+
+    // Aborting drops the assembled patches: nothing was written
+    TEST_CHECK(s_Writes == 0 && s_Code.Bytes == OriginalCode);
+
+    TEST_CHECK(DetourPatch::CommitAll(pointers, TransactionSize, CountingWriter, 1));
+    TEST_CHECK(s_Writes == 2 * TransactionSize);
+    for (int n = 0; n < TransactionSize; n++)
+    {
+        const size_t offset = n * FunctionWords * 4;
+        TEST_CHECK(memcmp(&s_Code.Bytes[offset], patches[n].Hook, patches[n].HookSize) == 0);
+        TEST_CHECK(memcmp(&s_Code.Bytes[offset + patches[n].HookSize], &OriginalCode[offset + patches[n].HookSize], FunctionWords * 4 - patches[n].HookSize) == 0);
+        TEST_CHECK(memcmp(&s_Slot.Bytes[n * TrampolinePool::SlotSize], patches[n].Trampoline, patches[n].TrampolineSize) == 0);
+    }
+
+    TEST_CHECK(DetourPatch::CommitAll(nullptr, 0, CountingWriter, 1) && s_Writes == 2 * TransactionSize);
+}
+
+// The Nth write fails after landing in part: whatever was hooked is restored byte for byte, the failed hook included.
+static void TestCommitRollback()
+{
+    for (int failing = 1; failing <= 2 * TransactionSize; failing++)
+    {
+        DetourPatch patches[TransactionSize];
+        const DetourPatch* pointers[TransactionSize];
+        AssembleTransaction(patches, pointers);
+        const std::vector<uint8_t> OriginalCode = s_Code.Bytes;
+        s_FailAtWrite = failing;
+
+        TEST_CHECK(!DetourPatch::CommitAll(pointers, TransactionSize, CountingWriter, 1));
+        TEST_CHECK(s_Code.Bytes == OriginalCode);
+
+        // A trampoline failing stops before any function is touched: that's the abort path, nothing more gets written
+        if (failing <= TransactionSize)
+            TEST_CHECK(s_Writes == failing);
+        else
+        {
+            // Hooks 0..k written or attempted, then one restore for each
+            const int hooks = failing - TransactionSize;
+            TEST_CHECK(s_Writes == failing + hooks);
+            TEST_CHECK(s_LastAddress == TransactionCode + (hooks - 1) * FunctionWords * 4 && s_LastSize == patches[hooks - 1].HookSize);
+        }
+    }
+}
+
+void RunDetourPatchTests(bool)
+{
+    TestNearHook();
+    TestFarHook();
+    TestRelativeBranches();
+    TestWriteFailure();
+    TestRandomHooks();
+    TestCommitAll();
+    TestCommitRollback();
+}
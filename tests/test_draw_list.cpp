@@ -0,0 +1,524 @@
+// ImDrawList fast paths against the code they stand in for:
+// - AddRectFilledBatch()/AddLineBatch()/AddCircleFilledBatch() against one call per primitive. The suite is built a second
+//   time with 16-bit ImDrawIdx, where batches get split into chunks and ImDrawListFlags_AllowVtxOffset starts new commands,
+// - the shape cache of AddRectFilled()/AddCircleFilled() against tessellating the path every time,
+// - the ASCII path of ImFont::RenderText() against going through FindGlyph(),
+// - the SIMD normals of AddPolyline()/AddConvexPolyFilled() against the scalar ones. The suite is built a second time with
+//   IMGUI_ENABLE_SIMD_TESSELLATION, and compare_outputs.cmake checks both builds print the same draw_list_hashes.
+#include "Test.hpp"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <math.h>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Triangles as the renderer sees them, so different vertex sharing or command splits still compare equal.
+static void ExpandTriangles(const ImDrawList* draw_list, std::vector<ImDrawVert>& out)
+{
+    out.clear();
+    for (int cmd_n = 0; cmd_n < draw_list->CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawCmd& cmd = draw_list->CmdBuffer[cmd_n];
+        for (unsigned int i = 0; i < cmd.ElemCount; i++)
+            out.push_back(draw_list->VtxBuffer[cmd.VtxOffset + draw_list->IdxBuffer[cmd.IdxOffset + i]]);
+    }
+}
+
+// Same triangles, positions within 'tolerance', same colors and UV.
+static bool SameTriangles(const ImDrawList* a, const ImDrawList* b, float tolerance)
+{
+    std::vector<ImDrawVert> vtx_a, vtx_b;
+    ExpandTriangles(a, vtx_a);
+    ExpandTriangles(b, vtx_b);
+    if (vtx_a.size() != vtx_b.size())
+        return false;
+    for (size_t i = 0; i < vtx_a.size(); i++)
+    {
+        if (fabsf(vtx_a[i].pos.x - vtx_b[i].pos.x) > tolerance || fabsf(vtx_a[i].pos.y - vtx_b[i].pos.y) > tolerance)
+            return false;
+        if (vtx_a[i].col != vtx_b[i].col || memcmp(&vtx_a[i].uv, &vtx_b[i].uv, sizeof(ImVec2)) != 0)
+            return false;
+    }
+    return true;
+}
+
+static bool SameBuffers(const ImDrawList* a, const ImDrawList* b)
+{
+    return a->VtxBuffer.Size == b->VtxBuffer.Size && a->IdxBuffer.Size == b->IdxBuffer.Size
+        && memcmp(a->VtxBuffer.Data, b->VtxBuffer.Data, a->VtxBuffer.size_in_bytes()) == 0
+        && memcmp(a->IdxBuffer.Data, b->IdxBuffer.Data, a->IdxBuffer.size_in_bytes()) == 0;
+}
+
+static void BeginDrawList(ImDrawList* draw_list, ImDrawListFlags flags)
+{
+    draw_list->_ResetForNewFrame();
+    draw_list->Flags = flags;
+    draw_list->PushClipRectFullScreen();
+    draw_list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+}
+
+static const ImDrawListFlags s_FlagSets[] =
+{
+    ImDrawListFlags_AllowVtxOffset,
+    ImDrawListFlags_AllowVtxOffset | ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill,
+    ImDrawListFlags_AllowVtxOffset | ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedLinesUseTex | ImDrawListFlags_AntiAliasedFill,
+};
+
+static void BeginDrawListTests()
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2(1920, 1080);
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::NewFrame();
+}
+
+static void EndDrawListTests()
+{
+    ImGui::EndFrame();
+    ImGui::DestroyContext();
+}
+
+// FNV-1a over the vertex then the index buffer: bit exact, a single differing normal changes it.
+static uint32_t HashBuffers(const ImDrawList* draw_list, uint32_t hash)
+{
+    const uint8_t* data[2] = { (const uint8_t*)draw_list->VtxBuffer.Data, (const uint8_t*)draw_list->IdxBuffer.Data };
+    const size_t sizes[2] = { (size_t)draw_list->VtxBuffer.size_in_bytes(), (size_t)draw_list->IdxBuffer.size_in_bytes() };
+    for (int n = 0; n < 2; n++)
+        for (size_t i = 0; i < sizes[n]; i++)
+            hash = (hash ^ data[n][i]) * 16777619u;
+    return hash;
+}
+
+// Indices within the vertex buffer and finite positions: what a wrong SIMD tail or a NaN normal would break first.
+static bool ValidBuffers(const ImDrawList* draw_list)
+{
+    for (int cmd_n = 0; cmd_n < draw_list->CmdBuffer.Size; cmd_n++)
+    {
+        const ImDrawCmd& cmd = draw_list->CmdBuffer[cmd_n];
+        for (unsigned int i = 0; i < cmd.ElemCount; i++)
+            if (cmd.VtxOffset + draw_list->IdxBuffer[cmd.IdxOffset + i] >= (unsigned int)draw_list->VtxBuffer.Size)
+                return false;
+    }
+    for (int i = 0; i < draw_list->VtxBuffer.Size; i++)
+        if (!isfinite(draw_list->VtxBuffer[i].pos.x) || !isfinite(draw_list->VtxBuffer[i].pos.y))
+            return false;
+    return true;
+}
+
+static float RandomCoord(float range)
+{
+    return (float)(rand() % (int)(range * 10.0f)) / 10.0f;
+}
+
+// Whether a list has as many commands as its vertices need: with 16-bit indices, at least one per 64k vertices.
+static bool SplitForIndices(const ImDrawList* draw_list)
+{
+    int commands = 0;
+    for (int cmd_n = 0; cmd_n < draw_list->CmdBuffer.Size; cmd_n++)
+        commands += draw_list->CmdBuffer[cmd_n].ElemCount != 0 ? 1 : 0;
+    return sizeof(ImDrawIdx) != 2 || commands >= 1 + (draw_list->VtxBuffer.Size - 1) / (1 << 16);
+}
+
+static void TestBatches(ImDrawList* a, ImDrawList* b)
+{
+    srand(3);
+    // 16383 rectangles are one chunk with 16-bit indices, 40000 need more than 64k vertices
+    const int counts[] = { 1, 7, 1000, 16383, 16384, 40000 };
+    const float thicknesses[] = { 0.5f, 1.0f, 2.5f, 70.0f };
+    const float radii[] = { 0.3f, 3.0f, 50.0f };
+    int mismatches = 0, invalid = 0;
+    for (int count_n = 0; count_n < IM_ARRAYSIZE(counts); count_n++)
+        for (int flags_n = 0; flags_n < IM_ARRAYSIZE(s_FlagSets); flags_n++)
+        {
+            const int count = counts[count_n];
+            const ImDrawListFlags flags = s_FlagSets[flags_n];
+            std::vector<ImVec2> p1(count), p2(count);
+            std::vector<ImU32> cols(count);
+            for (int i = 0; i < count; i++)
+            {
+                p1[i] = ImVec2(RandomCoord(1920.0f), RandomCoord(1080.0f));
+                p2[i] = (i % 97 == 0) ? p1[i] : ImVec2(p1[i].x + RandomCoord(40.0f) - 20.0f, p1[i].y + RandomCoord(40.0f) - 20.0f);
+                cols[i] = (rand() % 5 == 0) ? 0x00FFFFFF : (0xFF000000 | (ImU32)rand());
+            }
+
+            // A rectangle first on odd counts, so the first chunk doesn't start at vertex 0
+            const bool offset = (count % 2) != 0;
+            auto begin = [&]()
+            {
+                BeginDrawList(a, flags);
+                BeginDrawList(b, flags);
+                if (offset)
+                {
+                    a->AddRectFilled(ImVec2(1, 1), ImVec2(9, 9), IM_COL32_WHITE);
+                    b->AddRectFilled(ImVec2(1, 1), ImVec2(9, 9), IM_COL32_WHITE);
+                }
+            };
+            auto compare = [&](float tolerance)
+            {
+                const bool valid = ValidBuffers(a) && ValidBuffers(b);
+                invalid += !valid || !SplitForIndices(b) ? 1 : 0;
+                mismatches += valid && !SameTriangles(a, b, tolerance) ? 1 : 0;
+            };
+
+            begin();
+            for (int i = 0; i < count; i++)
+                a->AddRectFilled(p1[i], p2[i], cols[i]);
+            b->AddRectFilledBatch(p1.data(), p2.data(), count, 0, cols.data());
+            compare(0.0f);
+
+            begin();
+            for (int i = 0; i < count; i++)
+                a->AddRectFilled(p1[i], p2[i], IM_COL32(0, 255, 0, 255));
+            b->AddRectFilledBatch(p1.data(), p2.data(), count, IM_COL32(0, 255, 0, 255));
+            compare(0.0f);
+
+            for (int thickness_n = 0; thickness_n < IM_ARRAYSIZE(thicknesses); thickness_n++)
+            {
+                begin();
+                for (int i = 0; i < count; i++)
+                    a->AddLine(p1[i], p2[i], cols[i], thicknesses[thickness_n]);
+                b->AddLineBatch(p1.data(), p2.data(), count, 0, thicknesses[thickness_n], cols.data());
+                compare(0.0f);
+            }
+
+            for (int radius_n = 0; radius_n < IM_ARRAYSIZE(radii); radius_n++)
+                for (int segments = 0; segments <= 12; segments += 12)
+                {
+                    if (count > 1000 && radii[radius_n] > 10.0f)
+                        continue;
+                    begin();
+                    for (int i = 0; i < count; i++)
+                        a->AddCircleFilled(p1[i], radii[radius_n], cols[i], segments);
+                    b->AddCircleFilledBatch(p1.data(), count, radii[radius_n], 0, cols.data(), segments);
+                    compare(1e-3f);
+                }
+        }
+    TEST_CHECK(mismatches == 0);
+    TEST_CHECK(invalid == 0);
+}
+
+static void TestShapeCache(ImDrawList* a, ImDrawList* b)
+{
+    srand(5);
+    const ImDrawFlags corner_flags[] = { 0, ImDrawFlags_RoundCornersTop, ImDrawFlags_RoundCornersLeft, ImDrawFlags_RoundCornersTopLeft,
+        ImDrawFlags_RoundCornersBottomRight | ImDrawFlags_RoundCornersTopLeft, ImDrawFlags_RoundCornersAll };
+    ImDrawShapeCache& cache = ImGui::GetDrawListSharedData()->ShapeCache;
+    cache.Hits = cache.Misses = 0;
+    int mismatches = 0;
+    for (int flags_n = 0; flags_n < 2; flags_n++)
+        for (int i = 0; i < 3000; i++)
+        {
+            const ImDrawListFlags flags = s_FlagSets[flags_n];
+            const ImVec2 p_min(RandomCoord(1920.0f), RandomCoord(1080.0f));
+            const ImVec2 p_max(p_min.x + RandomCoord(300.0f), p_min.y + RandomCoord(300.0f));
+            const ImU32 col = 0xFF000000 | (ImU32)rand();
+
+            // Same sizes come back often in a real frame: reuse a few radii so the cache gets hits as well as misses
+            const float rounding = (i % 2) ? (float)(rand() % 8) : RandomCoord(160.0f);
+            const ImDrawFlags rect_flags = corner_flags[rand() % IM_ARRAYSIZE(corner_flags)];
+            // AddRectFilled() draws square rectangles with PrimRect(), not through the path: nothing to compare
+            if (rounding >= 0.5f)
+            {
+                BeginDrawList(a, flags);
+                BeginDrawList(b, flags);
+                a->AddRectFilled(p_min, p_max, col, rounding, rect_flags);
+                b->PathRect(p_min, p_max, rounding, rect_flags);
+                b->PathFillConvex(col);
+                mismatches += !SameTriangles(a, b, 1e-3f) ? 1 : 0;
+            }
+
+            const float radius = (i % 2) ? (float)(1 + rand() % 8) : RandomCoord(160.0f);
+            int segments = (rand() % 3 == 0) ? rand() % 40 : 0;
+            BeginDrawList(a, flags);
+            BeginDrawList(b, flags);
+            a->AddCircleFilled(p_min, radius, col, segments);
+            if (segments <= 0)
+            {
+                b->_PathArcToFastEx(p_min, radius, 0, IM_DRAWLIST_ARCFAST_SAMPLE_MAX, 0);
+                b->_Path.Size--;
+            }
+            else
+            {
+                segments = ImClamp(segments, 3, IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_MAX);
+                b->PathArcTo(p_min, radius, 0.0f, IM_PI * 2.0f * ((float)segments - 1.0f) / (float)segments, segments - 1);
+            }
+            b->PathFillConvex(col);
+            if (radius > 0.0f)
+                mismatches += !SameTriangles(a, b, 1e-3f) ? 1 : 0;
+        }
+    TEST_CHECK(mismatches == 0);
+    TEST_CHECK(cache.Hits > 500 && cache.Misses > 5000);
+
+    // A shape drawn again is a hit, whatever its position; a radius a hair off is another shape
+    BeginDrawList(a, s_FlagSets[1]);
+    const unsigned int hits = cache.Hits, misses = cache.Misses;
+    a->AddCircleFilled(ImVec2(10.0f, 10.0f), 6.25f, IM_COL32_WHITE);
+    a->AddCircleFilled(ImVec2(500.5f, 80.0f), 6.25f, IM_COL32_WHITE);
+    a->AddCircleFilled(ImVec2(10.0f, 10.0f), 6.2501f, IM_COL32_WHITE);
+    TEST_CHECK(cache.Hits == hits + 1 && cache.Misses == misses + 2);
+}
+
+static const char* s_Texts[] =
+{
+    "Hello, world! 123 The quick brown fox jumps over the lazy dog.",
+    "Tabs\tand\tnewlines\nsecond line\r\nthird \x01\x7f ctrl",
+    "UTF-8: caf\xC3\xA9 na\xC3\xAFve \xE2\x80\xA6 done\nmix ASCII\xC3\xA9" "ABC",
+    "Long wrapped paragraph of text that should wrap several times when a small wrap width is used, with some punctuation: ;:,.!? and more.",
+};
+
+// Renders every text with many sizes, wrap widths and clip rectangles into one list per case.
+static void RenderTexts(ImFont* font, std::vector<ImDrawList*>& out)
+{
+    const float sizes[] = { 13.0f, 20.0f, 9.5f };
+    const float wrap_widths[] = { 0.0f, 60.0f, 200.0f, 1.0f };
+    const ImVec4 clip_rects[] = { ImVec4(-1e6f, -1e6f, 1e6f, 1e6f), ImVec4(30.0f, 5.0f, 120.0f, 40.0f), ImVec4(0.0f, 0.0f, 1280.0f, 720.0f) };
+    for (int text_n = 0; text_n < IM_ARRAYSIZE(s_Texts); text_n++)
+        for (int size_n = 0; size_n < IM_ARRAYSIZE(sizes); size_n++)
+            for (int wrap_n = 0; wrap_n < IM_ARRAYSIZE(wrap_widths); wrap_n++)
+                for (int clip_n = 0; clip_n < IM_ARRAYSIZE(clip_rects); clip_n++)
+                    for (int fine_clip = 0; fine_clip < 2; fine_clip++)
+                    {
+                        ImDrawList* draw_list = IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData());
+                        BeginDrawList(draw_list, ImDrawListFlags_AllowVtxOffset);
+                        font->RenderText(draw_list, sizes[size_n], ImVec2(10.3f, 7.7f), IM_COL32(255, 200, 100, 255), clip_rects[clip_n], s_Texts[text_n], NULL, wrap_widths[wrap_n], fine_clip != 0);
+                        out.push_back(draw_list);
+                    }
+}
+
+static void TestAsciiText()
+{
+    ImFont* font = ImGui::GetIO().Fonts->Fonts[0];
+    TEST_CHECK(font->AsciiGlyphs.Size == 128);
+
+    std::vector<ImDrawList*> fast, slow;
+    RenderTexts(font, fast);
+    ImVector<ImFontGlyphAscii> ascii_glyphs;
+    ascii_glyphs.swap(font->AsciiGlyphs);  // Empty table: every glyph goes through FindGlyph()
+    RenderTexts(font, slow);
+    ascii_glyphs.swap(font->AsciiGlyphs);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < fast.size(); i++)
+    {
+        mismatches += !SameBuffers(fast[i], slow[i]) ? 1 : 0;
+        IM_DELETE(fast[i]);
+        IM_DELETE(slow[i]);
+    }
+    TEST_CHECK(mismatches == 0);
+}
+
+// Point counts around the 4 wide kernels' tails, then large enough for the vector loops to dominate.
+static const int s_PointCounts[] = { 2, 3, 4, 5, 6, 7, 8, 9, 12, 13, 16, 17, 31, 100, 1000, 10000, 100000 };
+static const float s_Thicknesses[] = { 1.0f, 2.5f, 4.0f };    // Textured or thin, thick, textured thick
+
+// Random walk with repeated points (zero length segments) and U-turns (miters that don't get fixed).
+static void RandomPolyline(std::vector<ImVec2>& points, int count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    points.resize(count);
+    ImVec2 p(960.0f, 540.0f);
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0 && i % 11 == 0)
+            p = points[i - 1];
+        else if (i > 1 && i % 7 == 0)
+            p = points[i - 2];
+        else
+            p = ImVec2(ImClamp(p.x + (float)(rng() % 801) * 0.1f - 40.0f, 0.0f, 1920.0f), ImClamp(p.y + (float)(rng() % 801) * 0.1f - 40.0f, 0.0f, 1080.0f));
+        points[i] = p;
+    }
+}
+
+// Clockwise ellipse, as AddConvexPolyFilled() wants it for anti-aliasing.
+static void ConvexPolygon(std::vector<ImVec2>& points, int count)
+{
+    points.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        const float a = IM_PI * 2.0f * (float)i / (float)count;
+        points[i] = ImVec2(960.0f + cosf(a) * 700.0f, 540.0f + sinf(a) * 400.0f);
+    }
+}
+
+// Every stroke of 'points': each flag set, thickness, open and closed. Hash of all the buffers, 0 if one was invalid.
+static uint32_t HashPolylines(ImDrawList* draw_list, const std::vector<ImVec2>& points)
+{
+    uint32_t hash = 2166136261u;
+    for (int flags_n = 0; flags_n < IM_ARRAYSIZE(s_FlagSets); flags_n++)
+        for (int thickness_n = 0; thickness_n < IM_ARRAYSIZE(s_Thicknesses); thickness_n++)
+            for (int closed = 0; closed < 2; closed++)
+            {
+                BeginDrawList(draw_list, s_FlagSets[flags_n]);
+                draw_list->AddPolyline(points.data(), (int)points.size(), IM_COL32(255, 128, 0, 255), closed ? ImDrawFlags_Closed : 0, s_Thicknesses[thickness_n]);
+                if (draw_list->VtxBuffer.Size == 0 || !ValidBuffers(draw_list))
+                    return 0;
+                hash = HashBuffers(draw_list, hash);
+            }
+    return hash;
+}
+
+static uint32_t HashConvexFills(ImDrawList* draw_list, const std::vector<ImVec2>& points)
+{
+    uint32_t hash = 2166136261u;
+    for (int flags_n = 0; flags_n < 2; flags_n++)
+    {
+        BeginDrawList(draw_list, s_FlagSets[flags_n]);
+        draw_list->AddConvexPolyFilled(points.data(), (int)points.size(), IM_COL32(0, 128, 255, 255));
+        if (draw_list->VtxBuffer.Size == 0 || !ValidBuffers(draw_list))
+            return 0;
+        hash = HashBuffers(draw_list, hash);
+    }
+    return hash;
+}
+
+// Each build draws the same strokes and fills: valid buffers, and the same ones when drawn again.
+static void TestPolylines(ImDrawList* draw_list)
+{
+    std::vector<ImVec2> points;
+    for (int count_n = 0; count_n < IM_ARRAYSIZE(s_PointCounts); count_n++)
+    {
+        const int count = s_PointCounts[count_n];
+        if (sizeof(ImDrawIdx) == 2 && count * 4 >= (1 << 16))
+            continue;   // A single stroke doesn't get split, it must fit in 16-bit indices on its own
+        RandomPolyline(points, count, (uint32_t)count);
+        const uint32_t polylines = HashPolylines(draw_list, points);
+        TEST_CHECK(polylines != 0 && polylines == HashPolylines(draw_list, points));
+
+        if (count < 3)
+            continue;
+        ConvexPolygon(points, count);
+        const uint32_t fills = HashConvexFills(draw_list, points);
+        TEST_CHECK(fills != 0 && fills == HashConvexFills(draw_list, points));
+    }
+}
+
+static void BenchShapes(ImDrawList* draw_list)
+{
+    const ImDrawListFlags flags = s_FlagSets[2];
+    const int count = 10000;
+    std::vector<ImVec2> p1(count), p2(count);
+    for (int i = 0; i < count; i++)
+    {
+        p1[i] = ImVec2((float)(i % 1900), (float)(i / 19 % 1000));
+        p2[i] = ImVec2(p1[i].x + 5.0f, p1[i].y + 5.0f);
+    }
+
+    const double rects = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); for (int i = 0; i < count; i++) draw_list->AddRectFilled(p1[i], p2[i], IM_COL32_WHITE); });
+    const double rects_batch = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); draw_list->AddRectFilledBatch(p1.data(), p2.data(), count, IM_COL32_WHITE); });
+    const double lines = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); for (int i = 0; i < count; i++) draw_list->AddLine(p1[i], p2[i], IM_COL32_WHITE); });
+    const double lines_batch = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); draw_list->AddLineBatch(p1.data(), p2.data(), count, IM_COL32_WHITE); });
+    const double circles = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); for (int i = 0; i < count; i++) draw_list->AddCircleFilled(p1[i], 3.0f, IM_COL32_WHITE); });
+    const double circles_batch = BenchmarkBest(20, [&]() { BeginDrawList(draw_list, flags); draw_list->AddCircleFilledBatch(p1.data(), count, 3.0f, IM_COL32_WHITE); });
+    printf("  %d primitives, one call each -> batch: rect %.0f -> %.0f us, line %.0f -> %.0f us, circle %.0f -> %.0f us\n",
+        count, rects, rects_batch, lines, lines_batch, circles, circles_batch);
+
+    const double shapes = BenchmarkBest(20, [&]()
+    {
+        BeginDrawList(draw_list, flags);
+        for (int i = 0; i < 2000; i++)
+        {
+            const ImVec2 p((float)(i % 1000), (float)(i / 3));
+            draw_list->AddRectFilled(p, ImVec2(p.x + 20.0f + (float)(i % 50), p.y + 18.0f), IM_COL32(64, 128, 255, 255), 4.0f);
+            draw_list->AddCircleFilled(p, 5.0f, IM_COL32_WHITE);
+        }
+    });
+    printf("  2000 rounded rects + 2000 circles: %.0f us\n", shapes);
+}
+
+static void BenchText(ImDrawList* draw_list)
+{
+    ImFont* font = ImGui::GetIO().Fonts->Fonts[0];
+    std::string text;
+    for (int i = 0; i < 20; i++)
+        text += "Frame 1234 Window Label ##id value = 0.123456 (ms) [Button] Checkbox Slider\n";
+    const double ascii = BenchmarkBest(100, [&]()
+    {
+        BeginDrawList(draw_list, ImDrawListFlags_AllowVtxOffset);
+        font->RenderText(draw_list, 13.0f, ImVec2(0, 0), IM_COL32_WHITE, ImVec4(0, 0, 1e6f, 1e6f), text.c_str(), text.c_str() + text.size(), 0.0f, false);
+    });
+    ImVector<ImFontGlyphAscii> ascii_glyphs;
+    ascii_glyphs.swap(font->AsciiGlyphs);
+    const double generic = BenchmarkBest(100, [&]()
+    {
+        BeginDrawList(draw_list, ImDrawListFlags_AllowVtxOffset);
+        font->RenderText(draw_list, 13.0f, ImVec2(0, 0), IM_COL32_WHITE, ImVec4(0, 0, 1e6f, 1e6f), text.c_str(), text.c_str() + text.size(), 0.0f, false);
+    });
+    ascii_glyphs.swap(font->AsciiGlyphs);
+    printf("  %d characters of text: FindGlyph() %.1f us, ASCII table %.1f us\n", (int)text.size(), generic, ascii);
+}
+
+static void BenchPolylines(ImDrawList* draw_list)
+{
+#if defined(IMGUI_ENABLE_SIMD_TESSELLATION)
+    printf("  IMGUI_ENABLE_SIMD_TESSELLATION\n");
+#else
+    printf("  scalar tessellation\n");
+#endif
+    const int counts[] = { 4, 64, 1000, 10000, 100000 };
+    std::vector<ImVec2> points;
+    for (int count_n = 0; count_n < IM_ARRAYSIZE(counts); count_n++)
+    {
+        const int count = counts[count_n];
+        const int repeats = count > 10000 ? 20 : 200;
+        RandomPolyline(points, count, 1);
+        const double thin = BenchmarkBest(repeats, [&]() { BeginDrawList(draw_list, s_FlagSets[1]); draw_list->AddPolyline(points.data(), count, IM_COL32_WHITE, 0, 1.0f); });
+        const double thick = BenchmarkBest(repeats, [&]() { BeginDrawList(draw_list, s_FlagSets[1]); draw_list->AddPolyline(points.data(), count, IM_COL32_WHITE, 0, 2.5f); });
+        const double textured = BenchmarkBest(repeats, [&]() { BeginDrawList(draw_list, s_FlagSets[2]); draw_list->AddPolyline(points.data(), count, IM_COL32_WHITE, 0, 2.0f); });
+        ConvexPolygon(points, count);
+        const double fill = BenchmarkBest(repeats, [&]() { BeginDrawList(draw_list, s_FlagSets[1]); draw_list->AddConvexPolyFilled(points.data(), count, IM_COL32_WHITE); });
+        printf("  %6d points: polyline thin %.1f us, thick %.1f us, textured %.1f us, convex fill %.1f us\n", count, thin, thick, textured, fill);
+    }
+}
+
+void RunDrawListTests(bool bench)
+{
+    BeginDrawListTests();
+    {
+        ImDrawList a(ImGui::GetDrawListSharedData());
+        ImDrawList b(ImGui::GetDrawListSharedData());
+        TestBatches(&a, &b);
+        TestShapeCache(&a, &b);
+        TestAsciiText();
+        TestPolylines(&a);
+
+        if (bench)
+        {
+            BenchShapes(&a);
+            BenchText(&a);
+            BenchPolylines(&a);
+        }
+    }
+    EndDrawListTests();
+}
+
+// One line per point count, the same for every build whatever the tessellation kernels.
+void RunDrawListHashes(bool)
+{
+    BeginDrawListTests();
+    {
+        ImDrawList draw_list(ImGui::GetDrawListSharedData());
+        std::vector<ImVec2> points;
+        for (int count_n = 0; count_n < IM_ARRAYSIZE(s_PointCounts); count_n++)
+        {
+            const int count = s_PointCounts[count_n];
+            RandomPolyline(points, count, (uint32_t)count);
+            const uint32_t polylines = HashPolylines(&draw_list, points);
+            uint32_t fills = 0;
+            if (count >= 3)
+            {
+                ConvexPolygon(points, count);
+                fills = HashConvexFills(&draw_list, points);
+            }
+            printf("  %6d points: polylines %08x, convex fills %08x\n", count, polylines, fills);
+        }
+    }
+    EndDrawListTests();
+}
@@ -0,0 +1,601 @@
+// ImGui_ImplGcm_RenderDrawData() against the recording <cell/gcm.h> shim: the methods it emits for fixed draw lists,
+// what the RSX would fetch through them, and the frame counters.
+#include "Test.hpp"
+#include "GcmRecorder.hpp"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_impl_gcm.h"
+#include <string.h>
+#include <vector>
+
+// Stand-ins for the sce-cgc binaries linked into the backend: ucode sizes are multiples of the 16 byte instructions,
+// parameters are bound the way imgui_impl_gcm_vp.cg and imgui_impl_gcm_fp*.cg declare them.
+static uint32_t s_VertexUCode[4 * 7];
+static uint32_t s_FragmentUCode[4 * 5];
+static uint32_t s_FragmentAlphaUCode[4 * 3];
+static uint32_t s_FragmentColorUCode[4 * 2];
+static const _CGparameter s_VertexParameters[] =
+{
+    { "ProjMtx", CG_C },
+    { "position", CG_ATTR0 },
+    { "texcoord", (CGresource)(CG_ATTR0 + 8) },
+    { "color", (CGresource)(CG_ATTR0 + 3) },
+};
+static const _CGparameter s_FragmentParameters[] = { { "Texture", CG_TEXUNIT0 } };
+
+_CGprogram _binary_imgui_impl_gcm_vp_vpo_start = { s_VertexUCode, sizeof(s_VertexUCode), s_VertexParameters, IM_ARRAYSIZE(s_VertexParameters), 0 };
+_CGprogram _binary_imgui_impl_gcm_fp_fpo_start = { s_FragmentUCode, sizeof(s_FragmentUCode), s_FragmentParameters, IM_ARRAYSIZE(s_FragmentParameters), 0 };
+_CGprogram _binary_imgui_impl_gcm_fp_alpha_fpo_start = { s_FragmentAlphaUCode, sizeof(s_FragmentAlphaUCode), s_FragmentParameters, IM_ARRAYSIZE(s_FragmentParameters), 0 };
+_CGprogram _binary_imgui_impl_gcm_fp_color_fpo_start = { s_FragmentColorUCode, sizeof(s_FragmentColorUCode), NULL, 0, 0 };
+
+static const uint32_t s_LocalMemorySize = 4 << 20;
+static const uint8_t s_LabelIndex = 200;
+static const ImVec2 s_DisplaySize(1280.0f, 720.0f);
+static std::vector<uint8_t> s_MainMemory;     // Zero-copy vertex arena, must outlive the backend
+
+static void BeginDrawList(ImDrawList* draw_list)
+{
+    draw_list->_ResetForNewFrame();
+    draw_list->PushClipRectFullScreen();
+    draw_list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+}
+
+// What ImGui::Render() does with the lists of a frame
+static void SetupDrawData(ImDrawData* draw_data, ImDrawList** lists, int count)
+{
+    draw_data->Clear();
+    draw_data->Valid = true;
+    draw_data->CmdLists = lists;
+    draw_data->CmdListsCount = count;
+    draw_data->DisplayPos = ImVec2(0.0f, 0.0f);
+    draw_data->DisplaySize = s_DisplaySize;
+    draw_data->FramebufferScale = ImVec2(1.0f, 1.0f);
+    for (int n = 0; n < count; n++)
+    {
+        lists[n]->_PopUnusedDrawCmd();
+        draw_data->TotalVtxCount += lists[n]->VtxBuffer.Size;
+        draw_data->TotalIdxCount += lists[n]->IdxBuffer.Size;
+    }
+}
+
+// Vertices of a command, in the order its indices reference them
+static void AppendCommandVertices(const ImDrawList* draw_list, const ImDrawCmd& cmd, std::vector<ImDrawVert>& out)
+{
+    for (unsigned int i = 0; i < cmd.ElemCount; i++)
+        out.push_back(draw_list->VtxBuffer[cmd.VtxOffset + draw_list->IdxBuffer[cmd.IdxOffset + i]]);
+}
+
+// Vertices the recorded draws make the RSX fetch, through the position array (local or main memory) and the index array of each draw
+static void FetchDrawnVertices(std::vector<ImDrawVert>& out)
+{
+    out.clear();
+    const uint8_t* vtx_memory = NULL;
+    uint32_t vtx_offset = 0;
+    for (size_t i = 0; i < g_GcmRecorder.Methods.size(); i++)
+    {
+        const GcmMethod& method = g_GcmRecorder.Methods[i];
+        if (method.Method == CELL_GCM_NV4097_SET_VERTEX_DATA_ARRAY_OFFSET)
+        {
+            vtx_memory = (method.Args[0] & 0x80000000) ? g_GcmRecorder.MainMemory : g_GcmRecorder.LocalMemory;
+            vtx_offset = (method.Args[0] & 0x7FFFFFFF) - IM_OFFSETOF(ImDrawVert, pos);
+        }
+        if (method.Method != CELL_GCM_NV4097_SET_INDEX_ARRAY_ADDRESS)
+            continue;
+        const ImDrawIdx* indices = (const ImDrawIdx*)(g_GcmRecorder.LocalMemory + method.Args[0]);
+        const ImDrawVert* vertices = (const ImDrawVert*)(vtx_memory + vtx_offset);
+        for (uint32_t n = 0; n < method.Args[3]; n++)
+            out.push_back(vertices[indices[n]]);
+    }
+}
+
+static bool SameVertices(const std::vector<ImDrawVert>& a, const std::vector<ImDrawVert>& b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(ImDrawVert)) == 0);
+}
+
+static uint32_t CommandBytesSince(const uint32_t* mark)
+{
+    return (uint32_t)((const uint8_t*)g_GcmRecorder.Context.current - (const uint8_t*)mark);
+}
+
+// Two lists covering what RenderDrawData() has to tell apart: clip rect changes, a second texture, a list switch and a command clipped away.
+static void TestRenderStream(CellGcmTexture* user_texture)
+{
+    ImDrawList list0(ImGui::GetDrawListSharedData());
+    ImDrawList list1(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list0);
+    list0.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32(255, 0, 0, 255));
+    list0.AddRectFilled(ImVec2(60, 10), ImVec2(90, 50), IM_COL32(0, 255, 0, 255));
+    list0.PushClipRect(ImVec2(10, 20), ImVec2(200, 220));
+    list0.AddRectFilled(ImVec2(15, 25), ImVec2(100, 100), IM_COL32(0, 0, 255, 128));
+    list0.PopClipRect();
+    list0.AddRectFilled(ImVec2(300, 300), ImVec2(400, 400), IM_COL32_WHITE);
+
+    BeginDrawList(&list1);
+    list1.PushTextureID((ImTextureID)user_texture);
+    list1.AddTriangleFilled(ImVec2(500, 50), ImVec2(550, 90), ImVec2(450, 90), IM_COL32(0, 255, 255, 255));
+    list1.AddImage((ImTextureID)user_texture, ImVec2(500, 100), ImVec2(600, 200));
+    list1.PopTextureID();
+    list1.AddRectFilled(ImVec2(700, 100), ImVec2(800, 200), IM_COL32(255, 255, 0, 255));
+    list1.PushClipRect(ImVec2(2000, 2000), ImVec2(2100, 2100));
+    list1.AddRectFilled(ImVec2(2010, 2010), ImVec2(2050, 2050), IM_COL32_WHITE);
+    list1.PopClipRect();
+
+    ImDrawList* lists[] = { &list0, &list1 };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 2);
+    TEST_CHECK(list0.CmdBuffer.Size == 3 && list1.CmdBuffer.Size == 3);
+
+    g_GcmRecorder.Methods.clear();
+    const uint32_t* mark = g_GcmRecorder.Context.current;
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    const uint32_t written = CommandBytesSince(mark);
+    g_GcmRecorder.Execute();
+
+    // Every command but the clipped one is drawn, from a copy of the list data in local memory
+    std::vector<ImDrawVert> expected, drawn;
+    for (int cmd_n = 0; cmd_n < 3; cmd_n++)
+        AppendCommandVertices(&list0, list0.CmdBuffer[cmd_n], expected);
+    for (int cmd_n = 0; cmd_n < 2; cmd_n++)
+        AppendCommandVertices(&list1, list1.CmdBuffer[cmd_n], expected);
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(SameVertices(expected, drawn));
+
+    // State is only emitted when it changes: 3 scissors (full screen, clipped, full screen), the alpha program for the font atlas,
+    // the RGBA one for the user texture then the alpha one again, 3 texture binds, and vertex arrays for each list.
+    ImGui_ImplGcm_FrameStats stats;
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_INDEX_ARRAY_ADDRESS) == 5 && stats.DrawCalls == 5);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_SCISSOR_HORIZONTAL) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_SHADER_PROGRAM) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_TEXTURE_OFFSET) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_VERTEX_DATA_ARRAY_OFFSET) == 2);
+    TEST_CHECK(stats.StateChanges == 3 + 3 + 3 + 2);
+    TEST_CHECK(stats.CommandBytes == written);
+    TEST_CHECK(stats.UploadBytes == (uint32_t)(draw_data.TotalVtxCount * sizeof(ImDrawVert) + draw_data.TotalIdxCount * sizeof(ImDrawIdx)));
+    TEST_CHECK(stats.ZeroCopyBytes == 0 && stats.RingWaits == 0);
+
+    // The clipped scissor, in framebuffer space
+    const GcmMethod* scissor = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_SCISSOR_HORIZONTAL, 1);
+    TEST_CHECK(scissor != NULL && scissor->Args[0] == ((190u << 16) | 10) && scissor->Args[1] == ((200u << 16) | 20));
+
+    // The user texture goes through the RGBA program on its own unit setup
+    const GcmMethod* texture = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_TEXTURE_OFFSET, 1);
+    TEST_CHECK(texture != NULL && texture->Args[0] == user_texture->offset);
+    const GcmMethod* programs[3];
+    for (int n = 0; n < 3; n++)
+        programs[n] = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_SHADER_PROGRAM, n);
+    TEST_CHECK(programs[2] != NULL && programs[1]->Args[0] != programs[0]->Args[0] && programs[2]->Args[0] == programs[0]->Args[0]);
+
+    // The frame ends by releasing its region of the ring through the backend's label
+    const GcmMethod& last = g_GcmRecorder.Methods.back();
+    TEST_CHECK(last.Method == CELL_GCM_NV4097_SET_SEMAPHORE_OFFSET && last.Args[0] == (uint32_t)s_LabelIndex << 4);
+    TEST_CHECK(g_GcmRecorder.Labels[s_LabelIndex] == last.Args[1] && last.Args[1] != 0);
+}
+
+// One command per fragment program: the atlas (alpha), a user texture (RGBA) and no texture (color).
+// Fragment ucode sits 128 bytes aligned at the start of the backend's block, ahead of the font texture, and the color program
+// gets drawn without touching any texture unit. The vertex program goes through the command buffer.
+static void CheckShaders(CellGcmTexture* user_texture)
+{
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    list.PushTextureID((ImTextureID)user_texture);
+    list.AddRectFilled(ImVec2(60, 10), ImVec2(90, 50), IM_COL32_WHITE);
+    list.PopTextureID();
+    list.PushTextureID(NULL);
+    list.AddRectFilled(ImVec2(100, 10), ImVec2(150, 50), IM_COL32(255, 0, 0, 255));
+    list.AddTriangleFilled(ImVec2(200, 10), ImVec2(250, 50), ImVec2(150, 50), IM_COL32(0, 255, 0, 255));
+    list.PopTextureID();
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 1);
+    TEST_CHECK(list.CmdBuffer.Size == 3 && list.CmdBuffer[2].GetTexID() == NULL);
+
+    g_GcmRecorder.Execute();
+    g_GcmRecorder.Methods.clear();
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    g_GcmRecorder.Execute();
+
+    ImGui_ImplGcm_FrameStats stats;
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(stats.DrawCalls == 3 && g_GcmRecorder.Count(CELL_GCM_NV4097_SET_SHADER_PROGRAM) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_TEXTURE_OFFSET) == 2 && g_GcmRecorder.Count(CELL_GCM_NV4097_SET_TEXTURE_CONTROL0) == 2);
+    TEST_CHECK(stats.StateChanges == 1 + 3 + 2 + 1);
+
+    const uint32_t* ucodes[3] = { s_FragmentAlphaUCode, s_FragmentUCode, s_FragmentColorUCode };
+    const uint32_t ucode_sizes[3] = { sizeof(s_FragmentAlphaUCode), sizeof(s_FragmentUCode), sizeof(s_FragmentColorUCode) };
+    uint32_t offsets[3] = {};
+    for (int n = 0; n < 3; n++)
+    {
+        const GcmMethod* program = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_SHADER_PROGRAM, n);
+        if (program == NULL)
+            return;
+        offsets[n] = program->Args[0];
+        TEST_CHECK((offsets[n] & 127) == 0);
+        TEST_CHECK(memcmp(g_GcmRecorder.LocalMemory + offsets[n], ucodes[n], ucode_sizes[n]) == 0);
+    }
+    const uint32_t font_offset = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_TEXTURE_OFFSET, 0)->Args[0];
+    for (int a = 0; a < 3; a++)
+    {
+        TEST_CHECK(offsets[a] + ucode_sizes[a] <= font_offset);
+        for (int b = 0; b < 3; b++)
+            TEST_CHECK(a == b || offsets[a] + ucode_sizes[a] <= offsets[b] || offsets[b] + ucode_sizes[b] <= offsets[a]);
+    }
+
+    // Nothing touches the texture units between the color program and its draw
+    size_t i = 0;
+    while (g_GcmRecorder.Methods[i].Method != CELL_GCM_NV4097_SET_SHADER_PROGRAM || g_GcmRecorder.Methods[i].Args[0] != offsets[2])
+        i++;
+    for (; i < g_GcmRecorder.Methods.size(); i++)
+    {
+        const uint32_t method = g_GcmRecorder.Methods[i].Method;
+        TEST_CHECK(method < CELL_GCM_NV4097_SET_TEXTURE_OFFSET || method > CELL_GCM_NV4097_SET_TEXTURE_OFFSET + 16 * 32);
+    }
+
+    const GcmMethod* vertex_program = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_TRANSFORM_PROGRAM);
+    TEST_CHECK(vertex_program != NULL && vertex_program->Args.size() == IM_ARRAYSIZE(s_VertexUCode));
+    TEST_CHECK(vertex_program != NULL && memcmp(vertex_program->Args.data(), s_VertexUCode, sizeof(s_VertexUCode)) == 0);
+
+    std::vector<ImDrawVert> expected, drawn;
+    for (int cmd_n = 0; cmd_n < list.CmdBuffer.Size; cmd_n++)
+        AppendCommandVertices(&list, list.CmdBuffer[cmd_n], expected);
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(SameVertices(expected, drawn));
+}
+
+// cellGcmCgInitProgram() patches the binaries in place: once per process, however often device objects and the backend come and go.
+// Ucode is uploaded again after DestroyDeviceObjects(), and stays in place across InvalidateDeviceObjects().
+static void TestShaders(CellGcmTexture* user_texture)
+{
+    CGprogram programs[] = { &_binary_imgui_impl_gcm_vp_vpo_start, &_binary_imgui_impl_gcm_fp_fpo_start, &_binary_imgui_impl_gcm_fp_alpha_fpo_start, &_binary_imgui_impl_gcm_fp_color_fpo_start };
+    CheckShaders(user_texture);
+
+    ImGui_ImplGcm_InvalidateDeviceObjects();
+    ImGui_ImplGcm_NewFrame();
+    CheckShaders(user_texture);
+
+    ImGui_ImplGcm_DestroyDeviceObjects();
+    memset(g_GcmRecorder.LocalMemory, 0, 4096);
+    ImGui_ImplGcm_NewFrame();
+    CheckShaders(user_texture);
+
+    ImGui_ImplGcm_Shutdown();
+    memset(g_GcmRecorder.LocalMemory, 0, 4096);
+    ImGui_ImplGcm_Init(g_GcmRecorder.LocalMemory, s_LocalMemorySize - (64 << 10), s_LabelIndex);
+    ImGui_ImplGcm_NewFrame();
+    CheckShaders(user_texture);
+
+    for (size_t n = 0; n < IM_ARRAYSIZE(programs); n++)
+        TEST_CHECK(programs[n]->InitCount == 1);
+}
+
+// Callbacks: ImDrawCallback_ResetRenderState and user callbacks make everything get bound again.
+static int s_UserCallbackCalls = 0;
+static void UserCallback(const ImDrawList*, const ImDrawCmd*)
+{
+    s_UserCallbackCalls++;
+    cellGcmSetScissor(gCellGcmCurrentContext, 0, 0, 1, 1);
+}
+
+static void TestRenderCallbacks()
+{
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    list.AddCallback(ImDrawCallback_ResetRenderState, NULL);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    list.AddCallback(UserCallback, NULL);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 1);
+
+    g_GcmRecorder.Methods.clear();
+    s_UserCallbackCalls = 0;
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    g_GcmRecorder.Execute();
+
+    ImGui_ImplGcm_FrameStats stats;
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(s_UserCallbackCalls == 1);
+    TEST_CHECK(stats.DrawCalls == 3 && stats.StateChanges == 3 * 4);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_BLEND_ENABLE) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_TRANSFORM_PROGRAM) == 3);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_SCISSOR_HORIZONTAL) == 3 + 1);
+    TEST_CHECK(g_GcmRecorder.Count(CELL_GCM_NV4097_SET_SHADER_PROGRAM) == 3);
+}
+
+// A command buffer smaller than the frame: the context callback makes room, nothing gets lost.
+static void TestCommandBufferWrap()
+{
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list);
+    for (int i = 0; i < 200; i++)
+    {
+        list.PushClipRect(ImVec2((float)i, 0.0f), ImVec2((float)i + 100.0f, 100.0f));
+        list.AddRectFilled(ImVec2((float)i, 0.0f), ImVec2((float)i + 10.0f, 10.0f), IM_COL32_WHITE);
+        list.PopClipRect();
+    }
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 1);
+
+    g_GcmRecorder.Execute();
+    g_GcmRecorder.Methods.clear();
+    const int wraps = g_GcmRecorder.Wraps;
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    g_GcmRecorder.Execute();
+
+    ImGui_ImplGcm_FrameStats stats;
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(g_GcmRecorder.Wraps > wraps);
+    TEST_CHECK(stats.DrawCalls == 200 && g_GcmRecorder.Count(CELL_GCM_NV4097_SET_INDEX_ARRAY_ADDRESS) == 200);
+    TEST_CHECK(stats.StateChanges == 200 + 3);
+
+    std::vector<ImDrawVert> expected, drawn;
+    for (int cmd_n = 0; cmd_n < list.CmdBuffer.Size; cmd_n++)
+        AppendCommandVertices(&list, list.CmdBuffer[cmd_n], expected);
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(SameVertices(expected, drawn));
+}
+
+// The RSX falling behind: frames queue up to IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT, then the PPU flushes and waits on the label.
+static void TestRingWaits()
+{
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 1);
+
+    // RSX keeping up
+    ImGui_ImplGcm_FrameStats stats;
+    for (int frame = 0; frame < 10; frame++)
+    {
+        ImGui_ImplGcm_RenderDrawData(&draw_data);
+        g_GcmRecorder.Execute();
+        ImGui_ImplGcm_GetFrameStats(&stats);
+        TEST_CHECK(stats.RingWaits == 0);
+    }
+
+    // RSX stalled: the fourth frame waits for the first one
+    g_GcmRecorder.Stalled = true;
+    const int sleeps = g_GcmRecorder.Sleeps;
+    for (int frame = 0; frame < 4; frame++)
+    {
+        ImGui_ImplGcm_RenderDrawData(&draw_data);
+        ImGui_ImplGcm_GetFrameStats(&stats);
+        TEST_CHECK(stats.RingWaits == (frame < 3 ? 0u : 1u));
+    }
+    TEST_CHECK(g_GcmRecorder.Sleeps > sleeps && !g_GcmRecorder.Stalled);
+    g_GcmRecorder.Execute();
+}
+
+// Nothing to draw, or nowhere to draw it: no commands, zeroed counters.
+static void TestRenderNothing()
+{
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    BeginDrawList(&list);
+    list.AddRectFilled(ImVec2(10, 10), ImVec2(50, 50), IM_COL32_WHITE);
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    SetupDrawData(&draw_data, lists, 1);
+    draw_data.DisplaySize = ImVec2(0.0f, 0.0f);
+
+    const uint32_t* mark = g_GcmRecorder.Context.current;
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    ImGui_ImplGcm_FrameStats stats;
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(g_GcmRecorder.Context.current == mark);
+    TEST_CHECK(stats.DrawCalls == 0 && stats.CommandBytes == 0 && stats.UploadBytes == 0);
+}
+
+// The font atlas goes up as B8 until it gets custom rects, which the application may color after the build: then as A8R8G8B8.
+static void TestFontTexture()
+{
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    const CellGcmTexture* texture = (const CellGcmTexture*)atlas->TexID;
+    TEST_CHECK(texture != NULL && (texture->format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN)) == CELL_GCM_TEXTURE_B8);
+    TEST_CHECK(texture != NULL && texture->pitch == (uint32_t)atlas->TexWidth);
+
+    const int rect_id = atlas->AddCustomRectRegular(4, 4);
+    atlas->Build();
+    unsigned char* pixels;
+    int width, height;
+    atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+    const ImFontAtlasCustomRect* rect = atlas->GetCustomRectByIndex(rect_id);
+    for (int y = 0; y < rect->Height; y++)
+        for (int x = 0; x < rect->Width; x++)
+            ((ImU32*)pixels)[(rect->Y + y) * width + rect->X + x] = IM_COL32(255, 64 * y, 64 * x, 255);
+    TEST_CHECK(!atlas->TexPixelsUseColors);
+
+    ImGui_ImplGcm_InvalidateDeviceObjects();
+    ImGui_ImplGcm_NewFrame();
+    texture = (const CellGcmTexture*)atlas->TexID;
+    TEST_CHECK(texture != NULL && (texture->format & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN)) == CELL_GCM_TEXTURE_A8R8G8B8);
+    TEST_CHECK(texture != NULL && texture->pitch == (uint32_t)width * 4 && texture->width == width && texture->height == height);
+    if (texture != NULL)
+        TEST_CHECK(memcmp(g_GcmRecorder.LocalMemory + texture->offset, pixels, (size_t)width * height * 4) == 0);
+}
+
+static void BuildArenaFrame(ImDrawList* draw_list, int rects, ImU32 col)
+{
+    BeginDrawList(draw_list);
+    for (int i = 0; i < rects; i++)
+        draw_list->AddRectFilled(ImVec2((float)(i % 600), (float)(i % 400)), ImVec2((float)(i % 600) + 20.0f, (float)(i % 400) + 20.0f), col ^ (ImU32)(i & 0x7F));
+}
+
+// Zero-copy vertices: the RSX reads the lists' vertices in place, NewFrame() never waits for it, and a block only gets written again
+// once the frame that read it is done. Runs last, the arena stays registered until the backend shuts down.
+static void TestVtxArena()
+{
+    // Size the arena for two frames of the big list below, plus some room for small ones (same growth steps as 'list' goes through)
+    const int big_rects = 3000;
+    ImDrawList sizing_list(ImGui::GetDrawListSharedData());
+    BuildArenaFrame(&sizing_list, 10, IM_COL32_WHITE);
+    BuildArenaFrame(&sizing_list, big_rects, IM_COL32_WHITE);
+    const uint32_t big_block = (uint32_t)(sizing_list.VtxBuffer.Capacity * sizeof(ImDrawVert) + 16);
+    s_MainMemory.assign(2 * big_block + big_block / 2 + 256, 0);
+    g_GcmRecorder.MainMemory = s_MainMemory.data();
+    g_GcmRecorder.MainMemorySize = (uint32_t)s_MainMemory.size();
+    TEST_CHECK(ImGui_ImplGcm_SetVertexArena(s_MainMemory.data(), (unsigned int)s_MainMemory.size()));
+
+    ImDrawList list(ImGui::GetDrawListSharedData());
+    ImDrawList* lists[] = { &list };
+    ImDrawData draw_data;
+    ImGui_ImplGcm_FrameStats stats;
+    std::vector<ImDrawVert> expected, drawn;
+
+    // The RSX reads the arena in place: only indices get uploaded
+    g_GcmRecorder.Execute();
+    g_GcmRecorder.Methods.clear();
+    ImGui_ImplGcm_NewFrame();
+    BuildArenaFrame(&list, 10, IM_COL32(255, 0, 0, 255));
+    SetupDrawData(&draw_data, lists, 1);
+    TEST_CHECK(list._VtxArena != NULL);
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    g_GcmRecorder.Execute();
+    ImGui_ImplGcm_GetFrameStats(&stats);
+    TEST_CHECK(stats.ZeroCopyBytes == (uint32_t)(list.VtxBuffer.Size * sizeof(ImDrawVert)));
+    TEST_CHECK(stats.UploadBytes == (uint32_t)(list.IdxBuffer.Size * sizeof(ImDrawIdx)));
+    const GcmMethod* vtx_array = g_GcmRecorder.Find(CELL_GCM_NV4097_SET_VERTEX_DATA_ARRAY_OFFSET);
+    TEST_CHECK(vtx_array != NULL && (vtx_array->Args[0] & 0x80000000) != 0);
+    AppendCommandVertices(&list, list.CmdBuffer[0], expected);
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(SameVertices(expected, drawn));
+
+    // RSX stalled for three frames: no waits, each frame writes a block of its own, and what the RSX eventually reads is what each frame drew
+    g_GcmRecorder.Methods.clear();
+    g_GcmRecorder.Stalled = true;
+    const int sleeps = g_GcmRecorder.Sleeps;
+    const ImDrawVert* blocks[3];
+    expected.clear();
+    for (int frame = 0; frame < 3; frame++)
+    {
+        ImGui_ImplGcm_NewFrame();
+        BuildArenaFrame(&list, 10, IM_COL32(0, 64 * frame, 255, 255));
+        SetupDrawData(&draw_data, lists, 1);
+        AppendCommandVertices(&list, list.CmdBuffer[0], expected);
+        blocks[frame] = list.VtxBuffer.Data;
+        ImGui_ImplGcm_RenderDrawData(&draw_data);
+        ImGui_ImplGcm_GetFrameStats(&stats);
+        TEST_CHECK(stats.VtxArenaWaits == 0 && stats.RingWaits == 0 && stats.ZeroCopyBytes > 0);
+    }
+    TEST_CHECK(g_GcmRecorder.Sleeps == sleeps && g_GcmRecorder.Stalled);
+    TEST_CHECK(blocks[0] != blocks[1] && blocks[1] != blocks[2] && blocks[0] != blocks[2]);
+    g_GcmRecorder.Stalled = false;
+    g_GcmRecorder.Execute();
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(SameVertices(expected, drawn));
+
+    // Blocks come back once the label passed their frame
+    ImGui_ImplGcm_NewFrame();
+    BuildArenaFrame(&list, 10, IM_COL32_WHITE);
+    TEST_CHECK(list.VtxBuffer.Data == blocks[0]);
+
+    // Room for two frames of the big list: the third one waits, once, for the RSX to release the oldest block
+    BuildArenaFrame(&list, big_rects, IM_COL32_WHITE);
+    SetupDrawData(&draw_data, lists, 1);
+    TEST_CHECK(list._VtxArena != NULL);
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    g_GcmRecorder.Execute();
+    g_GcmRecorder.Methods.clear();
+    g_GcmRecorder.Stalled = true;
+    expected.clear();
+    size_t frame0_vertices = 0;
+    for (int frame = 0; frame < 3; frame++)
+    {
+        ImGui_ImplGcm_NewFrame();
+        BuildArenaFrame(&list, big_rects, IM_COL32(frame * 100, 0, 0, 255));
+        SetupDrawData(&draw_data, lists, 1);
+        TEST_CHECK(list._VtxArena != NULL);
+        for (int cmd_n = 0; cmd_n < list.CmdBuffer.Size; cmd_n++)
+            AppendCommandVertices(&list, list.CmdBuffer[cmd_n], expected);
+        if (frame == 0)
+            frame0_vertices = expected.size();
+        blocks[frame] = list.VtxBuffer.Data;
+        ImGui_ImplGcm_RenderDrawData(&draw_data);
+        ImGui_ImplGcm_GetFrameStats(&stats);
+        TEST_CHECK(stats.VtxArenaWaits == (frame < 2 ? 0u : 1u));
+        TEST_CHECK(stats.RingWaits == 0);
+    }
+    TEST_CHECK(blocks[2] == blocks[0]);
+
+    // Frame 0's block got rewritten by frame 2 once the RSX was done with it, the others are still what they drew
+    g_GcmRecorder.Execute();
+    FetchDrawnVertices(drawn);
+    TEST_CHECK(drawn.size() == expected.size() && frame0_vertices < expected.size());
+    drawn.erase(drawn.begin(), drawn.begin() + frame0_vertices);
+    expected.erase(expected.begin(), expected.begin() + frame0_vertices);
+    TEST_CHECK(SameVertices(expected, drawn));
+
+    // Device objects reset the label: blocks still pending get released instead of waiting on a fence that would never come back
+    g_GcmRecorder.Stalled = true;
+    ImGui_ImplGcm_NewFrame();
+    BuildArenaFrame(&list, big_rects, IM_COL32_WHITE);
+    SetupDrawData(&draw_data, lists, 1);
+    ImGui_ImplGcm_RenderDrawData(&draw_data);
+    BuildArenaFrame(&list, big_rects, IM_COL32_WHITE);
+    ImGui_ImplGcm_InvalidateDeviceObjects();
+    ImGui_ImplGcm_NewFrame();
+    const int sleeps_after_reset = g_GcmRecorder.Sleeps;
+    for (int frame = 0; frame < 3; frame++)
+    {
+        BuildArenaFrame(&list, big_rects, IM_COL32_WHITE);
+        SetupDrawData(&draw_data, lists, 1);
+        TEST_CHECK(list._VtxArena != NULL);
+        ImGui_ImplGcm_RenderDrawData(&draw_data);
+        g_GcmRecorder.Execute();
+        ImGui_ImplGcm_NewFrame();
+    }
+    TEST_CHECK(g_GcmRecorder.Sleeps == sleeps_after_reset);
+}
+
+void RunGcmRenderTests(bool)
+{
+    for (size_t i = 0; i < IM_ARRAYSIZE(s_VertexUCode); i++)
+        s_VertexUCode[i] = 0x56000000 + (uint32_t)i;
+    for (size_t i = 0; i < IM_ARRAYSIZE(s_FragmentUCode); i++)
+        s_FragmentUCode[i] = 0x46000000 + (uint32_t)i;
+    for (size_t i = 0; i < IM_ARRAYSIZE(s_FragmentAlphaUCode); i++)
+        s_FragmentAlphaUCode[i] = 0x41000000 + (uint32_t)i;
+    for (size_t i = 0; i < IM_ARRAYSIZE(s_FragmentColorUCode); i++)
+        s_FragmentColorUCode[i] = 0x43000000 + (uint32_t)i;
+
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = s_DisplaySize;
+    ImGui::GetDrawListSharedData()->ClipRectFullscreen = ImVec4(0.0f, 0.0f, s_DisplaySize.x, s_DisplaySize.y);
+    g_GcmRecorder.Reset(1 << 16, s_LocalMemorySize);
+    ImGui_ImplGcm_Init(g_GcmRecorder.LocalMemory, s_LocalMemorySize - (64 << 10), s_LabelIndex);
+    ImGui_ImplGcm_NewFrame();
+
+    // A user texture after the block given to the backend
+    CellGcmTexture user_texture;
+    memset(&user_texture, 0, sizeof(user_texture));
+    user_texture.format = CELL_GCM_TEXTURE_A8R8G8B8 | CELL_GCM_TEXTURE_LN;
+    user_texture.width = user_texture.height = 16;
+    user_texture.pitch = 16 * 4;
+    user_texture.offset = s_LocalMemorySize - (64 << 10);
+
+    TestShaders(&user_texture);
+    TestRenderStream(&user_texture);
+    TestRenderCallbacks();
+    TestRingWaits();
+    TestRenderNothing();
+    TestFontTexture();
+
+    // Last, on a command buffer too small for a frame
+    g_GcmRecorder.Execute();
+    g_GcmRecorder.CommandBuffer.resize(512);
+    g_GcmRecorder.Context.begin = g_GcmRecorder.Context.current = g_GcmRecorder.CommandBuffer.data();
+    g_GcmRecorder.Context.end = g_GcmRecorder.Context.begin + g_GcmRecorder.CommandBuffer.size();
+    g_GcmRecorder.Executed = g_GcmRecorder.Context.begin;
+    TestCommandBufferWrap();
+    TestVtxArena();
+
+    ImGui_ImplGcm_Shutdown();
+    ImGui::DestroyContext();
+}
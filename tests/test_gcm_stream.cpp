@@ -0,0 +1,218 @@
+// Vertex/index ring and texture swizzling of the GCM backend (imgui_impl_gcm_internal.h), with a host variable standing in for the RSX label.
+#include "Test.hpp"
+#include "imgui_impl_gcm_internal.h"
+#include <stdlib.h>
+#include <vector>
+
+// Plays the RSX: a wait releases frames up to the fence asked for, as if the back end had just written it.
+static void RingWaitForFence(const ImGui_ImplGcm_StreamRing* ring, uint32_t fence, void* user_data)
+{
+    (*(uint32_t*)user_data)++;
+    *ring->Label = fence;
+}
+
+static void TestRingSequence()
+{
+    uint8_t data[1000];
+    volatile uint32_t label = 0xDEAD;
+    uint32_t waits = 0;
+    unsigned int counted_waits = 0;
+    ImGui_ImplGcm_StreamRing ring;
+    ImGui_ImplGcm_StreamRingInit(&ring, data, 0x1000, sizeof(data), &label);
+    TEST_CHECK(label == 0);
+
+    // RSX keeps up: frames go back to back, then wrap to the start when the next one doesn't fit at the end
+    uint32_t expected = 0;
+    for (int frame = 0; frame < 20; frame++)
+    {
+        const uint32_t begin = ImGui_ImplGcm_StreamRingAlloc(&ring, 300, RingWaitForFence, (void*)&waits, &counted_waits);
+        if (expected + 300 > sizeof(data))
+            expected = 0;
+        TEST_CHECK(begin == expected);
+        expected = begin + 300;
+        label = ImGui_ImplGcm_StreamRingSubmit(&ring, begin, begin + 300);
+    }
+    TEST_CHECK(waits == 0 && counted_waits == 0);
+
+    // Too large to ever fit
+    TEST_CHECK(ImGui_ImplGcm_StreamRingAlloc(&ring, sizeof(data) + 1, RingWaitForFence, (void*)&waits, &counted_waits) == (uint32_t)-1);
+}
+
+static void TestRingFramesInFlight()
+{
+    uint8_t data[1 << 16];
+    volatile uint32_t label = 0;
+    uint32_t waits = 0;
+    unsigned int counted_waits = 0;
+    ImGui_ImplGcm_StreamRing ring;
+    ImGui_ImplGcm_StreamRingInit(&ring, data, 0, sizeof(data), &label);
+
+    // RSX stalled: small frames never overlap, but only IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT get queued before waiting on the oldest
+    uint32_t fences[IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT + 1];
+    for (int frame = 0; frame <= IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT; frame++)
+    {
+        const uint32_t begin = ImGui_ImplGcm_StreamRingAlloc(&ring, 64, RingWaitForFence, (void*)&waits, &counted_waits);
+        TEST_CHECK(begin == (uint32_t)frame * 64);
+        TEST_CHECK(waits == (frame < IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT ? 0u : 1u));
+        fences[frame] = ImGui_ImplGcm_StreamRingSubmit(&ring, begin, begin + 64);
+    }
+    TEST_CHECK(label == fences[0]);
+    TEST_CHECK(counted_waits == waits);
+    TEST_CHECK(ring.InFlightCount == IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT);
+}
+
+static void TestRingOverlap()
+{
+    uint8_t data[1000];
+    volatile uint32_t label = 0;
+    uint32_t waits = 0;
+    unsigned int counted_waits = 0;
+    ImGui_ImplGcm_StreamRing ring;
+    ImGui_ImplGcm_StreamRingInit(&ring, data, 0, sizeof(data), &label);
+
+    // The third frame wraps onto the first one, which the RSX may still be reading: wait for it, and only for it
+    const uint32_t f0 = ImGui_ImplGcm_StreamRingAlloc(&ring, 400, RingWaitForFence, (void*)&waits, &counted_waits);
+    const uint32_t fence0 = ImGui_ImplGcm_StreamRingSubmit(&ring, f0, f0 + 400);
+    const uint32_t f1 = ImGui_ImplGcm_StreamRingAlloc(&ring, 400, RingWaitForFence, (void*)&waits, &counted_waits);
+    ImGui_ImplGcm_StreamRingSubmit(&ring, f1, f1 + 400);
+    TEST_CHECK(f0 == 0 && f1 == 400 && waits == 0);
+
+    const uint32_t f2 = ImGui_ImplGcm_StreamRingAlloc(&ring, 400, RingWaitForFence, (void*)&waits, &counted_waits);
+    TEST_CHECK(f2 == 0);
+    TEST_CHECK(waits == 1 && label == fence0);
+    TEST_CHECK(ring.InFlightCount == 1);
+}
+
+static void TestRingFenceWrapAround()
+{
+    uint8_t data[256];
+    volatile uint32_t label = 0;
+    uint32_t waits = 0;
+    unsigned int counted_waits = 0;
+    ImGui_ImplGcm_StreamRing ring;
+    ImGui_ImplGcm_StreamRingInit(&ring, data, 0, sizeof(data), &label);
+
+    // Fences are compared as a signed difference, so they keep working once the counter wraps
+    ring.LastFence = 0xFFFFFFFE;
+    label = 0xFFFFFFFE;
+    uint32_t fences[4];
+    for (int frame = 0; frame < 4; frame++)
+    {
+        const uint32_t begin = ImGui_ImplGcm_StreamRingAlloc(&ring, 200, RingWaitForFence, (void*)&waits, &counted_waits);
+        fences[frame] = ImGui_ImplGcm_StreamRingSubmit(&ring, begin, begin + 200);
+        TEST_CHECK(waits == (uint32_t)frame);
+    }
+    TEST_CHECK(fences[0] == 0xFFFFFFFF && fences[1] == 0 && fences[3] == 2);
+    TEST_CHECK(!ImGui_ImplGcm_StreamRingFencePassed(&ring, fences[3]));
+    label = fences[3];
+    TEST_CHECK(ImGui_ImplGcm_StreamRingFencePassed(&ring, fences[0]));
+}
+
+// Random frame sizes against an RSX that lags behind by a random number of frames:
+// a region handed out must never overlap a frame whose fence the label hasn't reached.
+static void TestRingRandom()
+{
+    std::vector<uint8_t> data(4096);
+    volatile uint32_t label = 0;
+    uint32_t waits = 0;
+    unsigned int counted_waits = 0;
+    ImGui_ImplGcm_StreamRing ring;
+    ImGui_ImplGcm_StreamRingInit(&ring, data.data(), 0, (uint32_t)data.size(), &label);
+
+    struct Frame { uint32_t Begin, End, Fence; };
+    std::vector<Frame> submitted;
+    srand(1234);
+    int overlaps = 0;
+    for (int frame = 0; frame < 20000; frame++)
+    {
+        const uint32_t size = 16 + (uint32_t)(rand() % 2000);
+        const uint32_t begin = ImGui_ImplGcm_StreamRingAlloc(&ring, size, RingWaitForFence, (void*)&waits, &counted_waits);
+        TEST_CHECK(begin + size <= data.size());
+        for (size_t i = 0; i < submitted.size(); i++)
+            if (!ImGui_ImplGcm_StreamRingFencePassed(&ring, submitted[i].Fence) && begin < submitted[i].End && submitted[i].Begin < begin + size)
+                overlaps++;
+        TEST_CHECK(ring.InFlightCount < IMGUI_IMPL_GCM_FRAMES_IN_FLIGHT);
+
+        Frame submit = { begin, begin + size, ImGui_ImplGcm_StreamRingSubmit(&ring, begin, begin + size) };
+        submitted.push_back(submit);
+        if (submitted.size() > 8)
+            submitted.erase(submitted.begin());
+
+        // RSX catches up on some frames, at most to the last submitted one
+        if (rand() % 3 == 0)
+        {
+            const uint32_t behind = (uint32_t)(rand() % 3);
+            if ((int32_t)(ring.LastFence - behind - label) > 0)
+                label = ring.LastFence - behind;
+        }
+    }
+    TEST_CHECK(overlaps == 0);
+    TEST_CHECK(counted_waits == waits && waits > 0);
+}
+
+// Reference swizzle straight from the layout's definition: interleave x and y address bits, x first, while both dimensions have bits left.
+static uint32_t SwizzleOffsetReference(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+{
+    uint32_t offset = 0;
+    uint32_t bit = 0;
+    for (uint32_t w = width, h = height, i = 0; w > 1 || h > 1; w >>= 1, h >>= 1, i++)
+    {
+        if (w > 1)
+            offset |= ((x >> i) & 1) << bit++;
+        if (h > 1)
+            offset |= ((y >> i) & 1) << bit++;
+    }
+    return offset;
+}
+
+static void TestSwizzle()
+{
+    for (int bytes_per_pixel = 1; bytes_per_pixel <= 4; bytes_per_pixel += 3)
+        for (int width = 1; width <= 512; width *= 2)
+            for (int height = 1; height <= 512; height *= 2)
+            {
+                std::vector<uint8_t> src((size_t)width * height * bytes_per_pixel);
+                std::vector<uint8_t> dst(src.size(), 0xCD);
+                for (size_t i = 0; i < src.size(); i++)
+                    src[i] = (uint8_t)(i * 2654435761u >> 13);
+                ImGui_ImplGcm_SwizzleTexture(dst.data(), src.data(), width, height, bytes_per_pixel);
+
+                int mismatches = 0;
+                for (int y = 0; y < height; y++)
+                    for (int x = 0; x < width; x++)
+                    {
+                        const size_t linear = ((size_t)y * width + x) * bytes_per_pixel;
+                        const size_t swizzled = (size_t)SwizzleOffsetReference(x, y, width, height) * bytes_per_pixel;
+                        if (memcmp(&src[linear], &dst[swizzled], bytes_per_pixel) != 0)
+                            mismatches++;
+                    }
+                if (mismatches != 0)
+                    printf("swizzle %dx%d, %d bytes per pixel: %d mismatches\n", width, height, bytes_per_pixel, mismatches);
+                TEST_CHECK(mismatches == 0);
+            }
+}
+
+static void BenchSwizzle()
+{
+    for (int size = 512; size <= 4096; size *= 2)
+        for (int bytes_per_pixel = 1; bytes_per_pixel <= 4; bytes_per_pixel += 3)
+        {
+            std::vector<uint8_t> src((size_t)size * size * bytes_per_pixel, 0x5A);
+            std::vector<uint8_t> dst(src.size());
+            const double us = BenchmarkBest(size >= 2048 ? 3 : 10, [&]() { ImGui_ImplGcm_SwizzleTexture(dst.data(), src.data(), size, size, bytes_per_pixel); });
+            printf("  swizzle %4dx%-4d %d bpp: %8.0f us, %6.0f MB/s\n", size, size, bytes_per_pixel * 8, us, src.size() / us);
+        }
+}
+
+void RunGcmStreamTests(bool bench)
+{
+    TestRingSequence();
+    TestRingFramesInFlight();
+    TestRingOverlap();
+    TestRingFenceWrapAround();
+    TestRingRandom();
+    TestSwizzle();
+
+    if (bench)
+        BenchSwizzle();
+}
@@ -0,0 +1,115 @@
+// MemoryReader::ReadScatter against a host buffer: how requests get merged, and what happens when a merged read fails.
+#include "Test.hpp"
+#include "BufferReader.hpp"
+#include <string.h>
+#include <vector>
+
+static bool MatchesBuffer(const BufferReader& reader, uint32_t address, const void* data, uint32_t size)
+{
+    return memcmp(&reader.Data[address - reader.Base], data, size) == 0;
+}
+
+static void TestCoalescing()
+{
+    BufferReader reader(0x10000, 0x10000);
+    uint32_t values[64];
+    std::vector<MemoryReader::ReadRequest> requests;
+
+    // 64 words 8 bytes apart: 512 bytes, two windows
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        MemoryReader::ReadRequest request = { 0x10000 + i * 8, &values[i], 4 };
+        requests.push_back(request);
+    }
+    TEST_CHECK(reader.ReadScatter(requests.data(), requests.size()) == SUCCEEDED);
+    TEST_CHECK(reader.Reads == 2);
+    for (uint32_t i = 0; i < 64; i++)
+        TEST_CHECK(MatchesBuffer(reader, 0x10000 + i * 8, &values[i], 4));
+
+    // Unsorted and overlapping requests merge too, as long as the whole run fits in a window
+    reader.Reads = 0;
+    uint8_t bytes[3][16];
+    MemoryReader::ReadRequest unsorted[] = { { 0x100F0, bytes[0], 16 }, { 0x10008, bytes[1], 16 }, { 0x10010, bytes[2], 16 } };
+    TEST_CHECK(reader.ReadScatter(unsorted, 3) == SUCCEEDED);
+    TEST_CHECK(reader.Reads == 1);
+    for (int i = 0; i < 3; i++)
+        TEST_CHECK(MatchesBuffer(reader, unsorted[i].Address, bytes[i], 16));
+
+    // Requests further apart than the window are read one by one
+    reader.Reads = 0;
+    MemoryReader::ReadRequest far[] = { { 0x10000, bytes[0], 16 }, { 0x10000 + MemoryReader::ScatterWindowSize, bytes[1], 16 } };
+    TEST_CHECK(reader.ReadScatter(far, 2) == SUCCEEDED);
+    TEST_CHECK(reader.Reads == 2);
+
+    // A run exactly the size of the window still merges
+    reader.Reads = 0;
+    MemoryReader::ReadRequest edge[] = { { 0x10000, bytes[0], 16 }, { 0x10000 + MemoryReader::ScatterWindowSize - 16, bytes[1], 16 } };
+    TEST_CHECK(reader.ReadScatter(edge, 2) == SUCCEEDED);
+    TEST_CHECK(reader.Reads == 1);
+    TEST_CHECK(MatchesBuffer(reader, edge[1].Address, bytes[1], 16));
+
+    // Nothing to read
+    reader.Reads = 0;
+    TEST_CHECK(reader.ReadScatter(nullptr, 0) == SUCCEEDED && reader.Reads == 0);
+}
+
+static void TestFailedRead()
+{
+    BufferReader reader(0x10000, 0x1000);
+    reader.BadBegin = 0x10020;
+    reader.BadEnd = 0x10030;
+
+    // The merged read covers the bad range: every request is read on its own, only the bad one fails
+    uint32_t values[8];
+    memset(values, 0xCD, sizeof(values));
+    MemoryReader::ReadRequest requests[8];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        MemoryReader::ReadRequest request = { 0x10000 + i * 0x10, &values[i], 4 };
+        requests[i] = request;
+    }
+    TEST_CHECK(reader.ReadScatter(requests, 8) == BufferReader::ReadError);
+    TEST_CHECK(reader.Reads == 1 + 8);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        if (i == 2)
+            TEST_CHECK(values[i] == 0xCDCDCDCD);
+        else
+            TEST_CHECK(MatchesBuffer(reader, requests[i].Address, &values[i], 4));
+    }
+
+    // The error of the first request that failed is the one reported, and later runs are still read
+    reader.Reads = 0;
+    MemoryReader::ReadRequest outside[] = { { 0x20000, &values[0], 4 }, { 0x10024, &values[1], 4 }, { 0x10800, &values[2], 4 } };
+    TEST_CHECK(reader.ReadScatter(outside, 3) == BufferReader::ReadError);
+    TEST_CHECK(MatchesBuffer(reader, 0x10800, &values[2], 4));
+}
+
+static void BenchScatter()
+{
+    BufferReader reader(0x10000, 0x100000);
+    std::vector<uint32_t> values(4096);
+    std::vector<MemoryReader::ReadRequest> requests;
+    for (uint32_t i = 0; i < values.size(); i++)
+    {
+        MemoryReader::ReadRequest request = { 0x10000 + i * 12, &values[i], 4 };
+        requests.push_back(request);
+    }
+
+    reader.Reads = 0;
+    reader.ReadScatter(requests.data(), requests.size());
+    const int scatterReads = reader.Reads;
+    const double scatter = BenchmarkBest(20, [&]() { reader.ReadScatter(requests.data(), requests.size()); });
+    const double single = BenchmarkBest(20, [&]() { for (size_t i = 0; i < requests.size(); i++) reader.ReadRange(requests[i].Address, requests[i].Destination, requests[i].Size); });
+    printf("  %d values: %d merged reads %.1f us, one read each %.1f us (host memcpy, the syscall per read is what this saves on the console)\n",
+        (int)requests.size(), scatterReads, scatter, single);
+}
+
+void RunMemoryReaderTests(bool bench)
+{
+    TestCoalescing();
+    TestFailedRead();
+
+    if (bench)
+        BenchScatter();
+}
@@ -0,0 +1,118 @@
+// Single producer / single consumer queue carrying pad samples from the PlayStation 3 input thread to NewFrame() (imgui_impl_playstation3_internal.h).
+#include "Test.hpp"
+#include "imgui_impl_playstation3_internal.h"
+#include <string.h>
+#include <thread>
+
+// Every byte of the sample derives from 'sequence': a torn read can't pass for another sample.
+static void MakeSample(ImGui_ImplPlaystation3_PadSample* sample, uint32_t sequence)
+{
+    unsigned char* bytes = (unsigned char*)sample;
+    for (size_t n = 0; n < sizeof(*sample); n++)
+        bytes[n] = (unsigned char)((sequence >> ((n % 4) * 8)) + n * 37);
+}
+
+// Sequence the sample was made from, or ~0u if it isn't one MakeSample() could have made.
+static uint32_t SampleSequence(const ImGui_ImplPlaystation3_PadSample& sample)
+{
+    const unsigned char* bytes = (const unsigned char*)&sample;
+    uint32_t sequence = 0;
+    for (int n = 0; n < 4; n++)
+        sequence |= (uint32_t)(unsigned char)(bytes[n] - n * 37) << (n * 8);
+    ImGui_ImplPlaystation3_PadSample expected;
+    MakeSample(&expected, sequence);
+    return memcmp(&expected, &sample, sizeof(sample)) == 0 ? sequence : ~0u;
+}
+
+// One thread: first in first out, full at IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE, and indices wrapping around 2^32 change nothing.
+static void TestQueueOrder()
+{
+    const uint32_t starts[] = { 0, 0xFFFFFFFFu - IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE / 2 };
+    for (int n = 0; n < IM_ARRAYSIZE(starts); n++)
+    {
+        ImGui_ImplPlaystation3_PadQueue queue;
+        memset(&queue, 0, sizeof(queue));
+        queue.Head = queue.Tail = starts[n];
+        ImGui_ImplPlaystation3_PadSample sample;
+        TEST_CHECK(!ImGui_ImplPlaystation3_PadQueuePop(&queue, &sample));
+
+        // Fill it: the sample past capacity is refused and leaves the queue as it was
+        uint32_t pushed = 0, popped = 0;
+        for (; pushed < IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE; pushed++)
+        {
+            MakeSample(&sample, pushed);
+            TEST_CHECK(ImGui_ImplPlaystation3_PadQueuePush(&queue, sample));
+        }
+        MakeSample(&sample, 0xDEAD);
+        TEST_CHECK(!ImGui_ImplPlaystation3_PadQueuePush(&queue, sample));
+        TEST_CHECK(queue.Head - queue.Tail == IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE);
+
+        // Drain half, then run a few thousand uneven push/pop rounds through the ring
+        int errors = 0;
+        for (int round = 0; round < 5000; round++)
+        {
+            const int pops = (round == 0) ? IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE / 2 : 1 + round % 5;
+            const int pushes = 1 + (round * 7) % 5;
+            for (int i = 0; i < pops && ImGui_ImplPlaystation3_PadQueuePop(&queue, &sample); i++)
+                errors += SampleSequence(sample) != popped++ ? 1 : 0;
+            for (int i = 0; i < pushes; i++)
+            {
+                MakeSample(&sample, pushed);
+                const bool room = queue.Head - queue.Tail < IMGUI_IMPL_PLAYSTATION3_INPUT_QUEUE;
+                errors += ImGui_ImplPlaystation3_PadQueuePush(&queue, sample) != room ? 1 : 0;
+                pushed += room ? 1 : 0;
+            }
+        }
+        while (ImGui_ImplPlaystation3_PadQueuePop(&queue, &sample))
+            errors += SampleSequence(sample) != popped++ ? 1 : 0;
+        TEST_CHECK(errors == 0);
+        TEST_CHECK(popped == pushed && queue.Head == queue.Tail && queue.Head == starts[n] + pushed);
+    }
+}
+
+// Two threads, the producer retrying when full: every sample arrives once, whole and in order.
+static void TestQueueThreads()
+{
+    static ImGui_ImplPlaystation3_PadQueue queue;
+    memset(&queue, 0, sizeof(queue));
+    const uint32_t count = 500000;
+
+    std::thread producer([=]()
+    {
+        ImGui_ImplPlaystation3_PadSample sample;
+        for (uint32_t sequence = 0; sequence < count; sequence++)
+        {
+            MakeSample(&sample, sequence);
+            while (!ImGui_ImplPlaystation3_PadQueuePush(&queue, sample))
+                std::this_thread::yield();
+        }
+    });
+
+    uint32_t received = 0;
+    int errors = 0;
+    while (received < count)
+    {
+        ImGui_ImplPlaystation3_PadSample sample;
+        if (!ImGui_ImplPlaystation3_PadQueuePop(&queue, &sample))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const uint32_t sequence = SampleSequence(sample);
+        if (sequence != received && errors++ < 5)
+            printf("pad queue: sample %u arrived as %u\n", received, sequence);
+        received++;
+    }
+    producer.join();
+
+    ImGui_ImplPlaystation3_PadSample sample;
+    TEST_CHECK(errors == 0);
+    TEST_CHECK(!ImGui_ImplPlaystation3_PadQueuePop(&queue, &sample));
+    TEST_CHECK(queue.Head == count && queue.Tail == count);
+}
+
+void RunPadQueueTests(bool)
+{
+    TestQueueOrder();
+    TestQueueThreads();
+}
@@ -0,0 +1,185 @@
+// Translation of cellPad states into ImGuiKey_Gamepad* values by the PlayStation 3 platform backend (imgui_impl_playstation3_internal.h).
+#include "Test.hpp"
+#include "imgui_impl_playstation3_internal.h"
+#include <string.h>
+
+// Every button, as cellPad reports it: which byte, which bit, and the key it must drive
+struct ButtonCase
+{
+    int             Digital;            // 1: button[CELL_PAD_BTN_OFFSET_DIGITAL1], 2: button[CELL_PAD_BTN_OFFSET_DIGITAL2]
+    unsigned char   Bit;
+    ImGuiKey        Key;
+};
+
+static const ButtonCase s_Buttons[] =
+{
+    { 1, 1 << 0, ImGuiKey_GamepadBack },        // SELECT
+    { 1, 1 << 1, ImGuiKey_GamepadL3 },
+    { 1, 1 << 2, ImGuiKey_GamepadR3 },
+    { 1, 1 << 3, ImGuiKey_GamepadStart },
+    { 1, 1 << 4, ImGuiKey_GamepadDpadUp },
+    { 1, 1 << 5, ImGuiKey_GamepadDpadRight },
+    { 1, 1 << 6, ImGuiKey_GamepadDpadDown },
+    { 1, 1 << 7, ImGuiKey_GamepadDpadLeft },
+    { 2, 1 << 0, ImGuiKey_GamepadL2 },
+    { 2, 1 << 1, ImGuiKey_GamepadR2 },
+    { 2, 1 << 2, ImGuiKey_GamepadL1 },
+    { 2, 1 << 3, ImGuiKey_GamepadR1 },
+    { 2, 1 << 4, ImGuiKey_GamepadFaceUp },      // TRIANGLE
+    { 2, 1 << 5, ImGuiKey_GamepadFaceRight },   // CIRCLE
+    { 2, 1 << 6, ImGuiKey_GamepadFaceDown },    // CROSS
+    { 2, 1 << 7, ImGuiKey_GamepadFaceLeft },    // SQUARE
+};
+
+static void CenteredSample(ImGui_ImplPlaystation3_PadSample* sample, unsigned char connected_mask)
+{
+    memset(sample, 0, sizeof(*sample));
+    sample->ConnectedMask = connected_mask;
+    for (int port = 0; port < IMGUI_IMPL_PLAYSTATION3_MAX_PADS; port++)
+    {
+        ImGui_ImplPlaystation3_PadState& pad = sample->Pads[port];
+        pad.LeftX = pad.LeftY = pad.RightX = pad.RightY = 0x80;
+    }
+}
+
+static float Value(const float* values, ImGuiKey key)
+{
+    return values[key - ImGuiKey_GamepadStart];
+}
+
+// Number of keys with a non-zero value
+static int Active(const float* values)
+{
+    int count = 0;
+    for (int n = 0; n < IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS; n++)
+        count += values[n] != 0.0f ? 1 : 0;
+    return count;
+}
+
+// Each button drives its own key and nothing else, from any port.
+static void TestButtons()
+{
+    ImGui_ImplPlaystation3_PadSample sample;
+    float values[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS];
+
+    CenteredSample(&sample, 0x01);
+    TEST_CHECK(ImGui_ImplPlaystation3_TranslatePadSample(sample, values));
+    TEST_CHECK(Active(values) == 0);
+
+    for (int n = 0; n < IM_ARRAYSIZE(s_Buttons); n++)
+        for (int port = 0; port < IMGUI_IMPL_PLAYSTATION3_MAX_PADS; port++)
+        {
+            const ButtonCase& button = s_Buttons[n];
+            CenteredSample(&sample, (unsigned char)(1 << port));
+            (button.Digital == 1 ? sample.Pads[port].Digital1 : sample.Pads[port].Digital2) = button.Bit;
+            memset(values, 0xFF, sizeof(values));
+            const bool connected = ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+            if (!connected || Value(values, button.Key) != 1.0f || Active(values) != 1)
+                printf("Digital%d bit 0x%02X on port %d: expected key %d alone\n", button.Digital, button.Bit, port, (int)button.Key);
+            TEST_CHECK(connected && Value(values, button.Key) == 1.0f && Active(values) == 1);
+        }
+
+    // All of them at once: every button key is down, no stick key
+    CenteredSample(&sample, 0x01);
+    sample.Pads[0].Digital1 = sample.Pads[0].Digital2 = 0xFF;
+    ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+    TEST_CHECK(Active(values) == IM_ARRAYSIZE(s_Buttons));
+    TEST_CHECK(Value(values, ImGuiKey_GamepadLStickLeft) == 0.0f && Value(values, ImGuiKey_GamepadRStickDown) == 0.0f);
+}
+
+// Every axis position of every stick: one direction at most, nothing inside the dead-zone, monotonic past it, full deflection reaches 1.
+static void TestSticks()
+{
+    struct StickCase { int Axis; ImGuiKey Negative; ImGuiKey Positive; };
+    static const StickCase sticks[] =
+    {
+        { 0, ImGuiKey_GamepadLStickLeft, ImGuiKey_GamepadLStickRight },
+        { 1, ImGuiKey_GamepadLStickUp,   ImGuiKey_GamepadLStickDown },
+        { 2, ImGuiKey_GamepadRStickLeft, ImGuiKey_GamepadRStickRight },
+        { 3, ImGuiKey_GamepadRStickUp,   ImGuiKey_GamepadRStickDown },
+    };
+
+    ImGui_ImplPlaystation3_PadSample sample;
+    float values[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS];
+    for (int n = 0; n < IM_ARRAYSIZE(sticks); n++)
+    {
+        const StickCase& stick = sticks[n];
+        float previous_negative = 2.0f, previous_positive = -1.0f;
+        int errors = 0;
+        for (int axis = 0; axis <= 255; axis++)
+        {
+            CenteredSample(&sample, 0x04);
+            ImGui_ImplPlaystation3_PadState& pad = sample.Pads[2];
+            unsigned char* axes[4] = { &pad.LeftX, &pad.LeftY, &pad.RightX, &pad.RightY };
+            *axes[stick.Axis] = (unsigned char)axis;
+            ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+
+            const float negative = Value(values, stick.Negative), positive = Value(values, stick.Positive);
+            const int deflection = axis - 0x80;
+            bool ok = negative >= 0.0f && negative <= 1.0f && positive >= 0.0f && positive <= 1.0f;
+            ok &= Active(values) <= 1 && (negative == 0.0f || positive == 0.0f);
+            ok &= negative <= previous_negative && positive >= previous_positive;
+            if (deflection >= -IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE && deflection <= IMGUI_IMPL_PLAYSTATION3_STICK_DEADZONE)
+                ok &= negative == 0.0f && positive == 0.0f;
+            else
+                ok &= (deflection < 0 ? negative : positive) > 0.0f;
+            if (!ok)
+            {
+                printf("stick axis %d at %d: %f / %f\n", stick.Axis, axis, negative, positive);
+                errors++;
+            }
+            previous_negative = negative;
+            previous_positive = positive;
+        }
+        TEST_CHECK(errors == 0);
+
+        // Both ends saturate
+        CenteredSample(&sample, 0x01);
+        unsigned char* axes[4] = { &sample.Pads[0].LeftX, &sample.Pads[0].LeftY, &sample.Pads[0].RightX, &sample.Pads[0].RightY };
+        *axes[stick.Axis] = 0;
+        ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+        TEST_CHECK(Value(values, stick.Negative) == 1.0f);
+        *axes[stick.Axis] = 255;
+        ImGui_ImplPlaystation3_TranslatePadSample(sample, values);
+        TEST_CHECK(Value(values, stick.Positive) == 1.0f);
+    }
+}
+
+// Several pads: buttons add up, each stick direction follows the pad pushing it furthest, disconnected ports don't count.
+static void TestMerge()
+{
+    ImGui_ImplPlaystation3_PadSample sample;
+    float values[IMGUI_IMPL_PLAYSTATION3_GAMEPAD_KEYS];
+
+    CenteredSample(&sample, (1 << 0) | (1 << 3) | (1 << 6));
+    sample.Pads[0].Digital2 = 1 << 6;           // CROSS
+    sample.Pads[3].Digital1 = 1 << 4;           // UP
+    sample.Pads[6].Digital2 = 1 << 6;           // CROSS again
+    sample.Pads[0].LeftX = 200;
+    sample.Pads[3].LeftX = 250;
+    sample.Pads[6].LeftX = 10;                  // Other direction, kept apart
+    sample.Pads[6].RightY = 60;
+    TEST_CHECK(ImGui_ImplPlaystation3_TranslatePadSample(sample, values));
+    TEST_CHECK(Value(values, ImGuiKey_GamepadFaceDown) == 1.0f && Value(values, ImGuiKey_GamepadDpadUp) == 1.0f);
+    TEST_CHECK(Value(values, ImGuiKey_GamepadLStickRight) == ImGui_ImplPlaystation3_StickValue(250, +1));
+    TEST_CHECK(Value(values, ImGuiKey_GamepadLStickLeft) == ImGui_ImplPlaystation3_StickValue(10, -1));
+    TEST_CHECK(Value(values, ImGuiKey_GamepadRStickUp) == ImGui_ImplPlaystation3_StickValue(60, -1));
+    TEST_CHECK(Active(values) == 5);
+
+    // Same pads unplugged: their stale states must not leak through
+    sample.ConnectedMask = 1 << 1;
+    TEST_CHECK(ImGui_ImplPlaystation3_TranslatePadSample(sample, values));
+    TEST_CHECK(Active(values) == 0);
+
+    // Nothing connected at all
+    sample.ConnectedMask = 0;
+    TEST_CHECK(!ImGui_ImplPlaystation3_TranslatePadSample(sample, values));
+    TEST_CHECK(Active(values) == 0);
+}
+
+void RunPadStateTests(bool)
+{
+    TestButtons();
+    TestSticks();
+    TestMerge();
+}
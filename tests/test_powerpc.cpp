@@ -0,0 +1,314 @@
+// PowerPC encoder/decoder used by Detour: fields of assembled branches, branch reach, and relocated branches still reaching their target.
+#include "Test.hpp"
+#include "PowerPC.hpp"
+#include <random>
+#include <vector>
+
+static void TestDecode()
+{
+    PowerPC::Instruction decoded = PowerPC::Decode(POWERPC_B(0x100, false, true));
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_Branch);
+    TEST_CHECK(decoded.Displacement == 0x100 && decoded.Linked && !decoded.Absolute);
+    TEST_CHECK(decoded.BranchOptions == POWERPC_BRANCH_OPTIONS_ALWAYS);
+
+    decoded = PowerPC::Decode(POWERPC_B(PowerPC::MinBranchDisplacement, false, false));
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_Branch && decoded.Displacement == PowerPC::MinBranchDisplacement && !decoded.Linked);
+    decoded = PowerPC::Decode(POWERPC_B(PowerPC::MaxBranchDisplacement, false, false));
+    TEST_CHECK(decoded.Displacement == PowerPC::MaxBranchDisplacement);
+    decoded = PowerPC::Decode(POWERPC_B(0x1000, true, false));
+    TEST_CHECK(decoded.Absolute && decoded.Displacement == 0x1000);
+
+    // bne cr0, -0x20
+    decoded = PowerPC::Decode(POWERPC_BC(4, 2, -0x20, false, false));
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_BranchConditional);
+    TEST_CHECK(decoded.BranchOptions == 4 && decoded.ConditionRegisterBit == 2 && decoded.Displacement == -0x20);
+    decoded = PowerPC::Decode(POWERPC_BC(16, 0, 0x7FFC, false, true));
+    TEST_CHECK(decoded.BranchOptions == 16 && decoded.Displacement == 0x7FFC && decoded.Linked);
+    decoded = PowerPC::Decode(POWERPC_BC(12, 0, -0x8000, false, false));
+    TEST_CHECK(decoded.Displacement == -0x8000);
+
+    // blr, bctrl
+    decoded = PowerPC::Decode(0x4E800020);
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_BranchConditionalToRegister && decoded.BranchOptions == 20 && !decoded.Linked);
+    decoded = PowerPC::Decode(POWERPC_BCCTR(20, 0, 1));
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_BranchConditionalToRegister && decoded.Linked);
+
+    // li r3, 0 / mtctr r0
+    TEST_CHECK(PowerPC::Decode(POWERPC_LI(POWERPC_REGISTERINDEX_R3, 0)).Type == PowerPC::InstructionType_Other);
+    TEST_CHECK(PowerPC::Decode(POWERPC_MTCTR(POWERPC_REGISTERINDEX_R0)).Type == PowerPC::InstructionType_Other);
+}
+
+static void TestBranchRange()
+{
+    const uint32_t address = 0x10000000;
+    TEST_CHECK(PowerPC::IsInBranchRange(address, address));
+    TEST_CHECK(PowerPC::IsInBranchRange(address, address + PowerPC::MaxBranchDisplacement));
+    TEST_CHECK(!PowerPC::IsInBranchRange(address, address + PowerPC::MaxBranchDisplacement + 4));
+    TEST_CHECK(PowerPC::IsInBranchRange(address, address + PowerPC::MinBranchDisplacement));
+    TEST_CHECK(!PowerPC::IsInBranchRange(address, address + PowerPC::MinBranchDisplacement - 4));
+    TEST_CHECK(!PowerPC::IsInBranchRange(address, address + 2));
+
+    // Wraps around the address space like the hardware does
+    TEST_CHECK(PowerPC::IsInBranchRange(0x00000100, 0xFFFFFF00));
+}
+
+static void TestAssembleBranch()
+{
+    uint32_t code[8];
+    const uint32_t address = 0x10000000;
+
+    TEST_CHECK(PowerPC::AssembleBranch(nullptr, address, address + 0x1000, false, true) == 4);
+    TEST_CHECK(PowerPC::AssembleBranch(code, address, address - 0x1000, true, true) == 4);
+    PowerPC::Instruction decoded = PowerPC::Decode(code[0]);
+    TEST_CHECK(decoded.Type == PowerPC::InstructionType_Branch && decoded.Displacement == -0x1000 && decoded.Linked);
+
+    // Far: lis/ori/mtctr/bctr, plus std/ld around them to preserve the register
+    TEST_CHECK(PowerPC::AssembleBranch(nullptr, address, 0x30000000, false, false) == 16);
+    TEST_CHECK(PowerPC::AssembleBranch(code, address, 0x30001234, true, true) == 24);
+    TEST_CHECK(code[1] == POWERPC_LIS(POWERPC_REGISTERINDEX_R0, 0x3000));
+    TEST_CHECK(code[2] == POWERPC_ORI(POWERPC_REGISTERINDEX_R0, POWERPC_REGISTERINDEX_R0, 0x1234));
+    TEST_CHECK(code[5] == POWERPC_BCCTR(20, 0, 1));
+}
+
+static void TestRelocateSize()
+{
+    uint32_t code[PowerPC::MaxRelocatedSize / sizeof(uint32_t)];
+    const uint32_t address = 0x10000000;
+
+    // Position independent code is copied as is
+    const uint32_t li = POWERPC_LI(POWERPC_REGISTERINDEX_R3, 1);
+    TEST_CHECK(PowerPC::Relocate(code, li, address, 0x30000000) == 4 && code[0] == li);
+    TEST_CHECK(PowerPC::Relocate(code, 0x4E800020, address, 0x30000000) == 4 && code[0] == 0x4E800020);
+
+    // bdnz: fine while the target stays in range, refused when it would need the count register
+    TEST_CHECK(PowerPC::Relocate(nullptr, POWERPC_BC(16, 0, -0x10, false, false), address, address + 0x100000) == 12);
+    TEST_CHECK(PowerPC::Relocate(code, POWERPC_BC(16, 0, -0x10, false, false), address, 0x30000000) == 0);
+
+    // Every relocation fits in MaxRelocatedSize
+    const uint32_t instructions[] = {
+        POWERPC_B(-0x10, false, false), POWERPC_B(0x10, false, true), POWERPC_B(4, false, true),
+        POWERPC_BC(12, 2, 0x40, false, false), POWERPC_BC(4, 2, 0x40, false, true), POWERPC_BC(20, 31, 4, false, true),
+    };
+    for (size_t i = 0; i < sizeof(instructions) / sizeof(instructions[0]); i++)
+        TEST_CHECK(PowerPC::Relocate(nullptr, instructions[i], address, 0x30000000) <= PowerPC::MaxRelocatedSize);
+}
+
+// Where a relocated sequence ends up, found by stepping through it: only the instructions Relocate() emits are understood.
+struct RelocatedExit
+{
+    uint32_t     Address;            // First address outside the sequence control reaches
+    uint32_t     LinkRegister;
+    bool         Valid;              // false if the sequence contains something unexpected
+};
+
+// 'taken' is the outcome of every condition tested on the way, as the original instruction would have seen it.
+static RelocatedExit StepRelocated(const uint32_t* code, size_t size, uint32_t address, bool taken, uint32_t linkRegister)
+{
+    RelocatedExit exit = { 0, linkRegister, false };
+    uint32_t registers[32] = { 0 };
+    uint32_t countRegister = 0;
+    uint32_t pc = address;
+
+    for (int steps = 0; steps < 64 && pc >= address && pc < address + size; steps++)
+    {
+        const uint32_t instruction = code[(pc - address) / sizeof(uint32_t)];
+        const PowerPC::Instruction decoded = PowerPC::Decode(instruction);
+        const uint32_t rD = (instruction >> POWERPC_BIT32(10)) & MASK_N_BITS(5);
+        const uint32_t rA = (instruction >> POWERPC_BIT32(15)) & MASK_N_BITS(5);
+        const bool always = (decoded.BranchOptions & POWERPC_BRANCH_OPTIONS_ALWAYS) == POWERPC_BRANCH_OPTIONS_ALWAYS;
+        uint32_t next = pc + sizeof(uint32_t);
+
+        if (decoded.Type == PowerPC::InstructionType_Branch || decoded.Type == PowerPC::InstructionType_BranchConditional)
+        {
+            if (decoded.Type == PowerPC::InstructionType_Branch || always || taken)
+                next = decoded.Absolute ? (uint32_t)decoded.Displacement : pc + decoded.Displacement;
+            if (decoded.Linked)
+                exit.LinkRegister = pc + sizeof(uint32_t);
+        }
+        else if (decoded.Type == PowerPC::InstructionType_BranchConditionalToRegister)
+        {
+            if ((instruction & POWERPC_EXOPCODE(0x3FF)) != POWERPC_EXOPCODE_BCCTR)
+                return exit;
+            if (always || taken)
+                next = countRegister;
+            if (decoded.Linked)
+                exit.LinkRegister = pc + sizeof(uint32_t);
+        }
+        else if ((instruction & POWERPC_OPCODE_MASK) == POWERPC_OPCODE_ADDIS && rA == 0)
+            registers[rD] = (instruction & 0xFFFF) << 16;
+        else if ((instruction & POWERPC_OPCODE_MASK) == POWERPC_OPCODE_ORI)
+            registers[rA] = registers[rD] | (instruction & 0xFFFF);
+        else if (instruction == POWERPC_MTCTR(rD))
+            countRegister = registers[rD];
+        else if (instruction == POWERPC_MTLR(rD))
+            exit.LinkRegister = registers[rD];
+        else if ((instruction & POWERPC_OPCODE_MASK) != POWERPC_OPCODE_STD && (instruction & POWERPC_OPCODE_MASK) != POWERPC_OPCODE_LD)
+            return exit;
+
+        pc = next;
+    }
+
+    exit.Address = pc;
+    exit.Valid = true;
+    return exit;
+}
+
+/***
+* Relocates an instruction and steps through the result: a taken branch reaches the original target, a call returns right after the
+* relocated sequence, a condition not taken falls through, and a bdnz out of the trampoline's reach is refused.
+* @param size Receives the size of the relocated sequence.
+* @returns number of failed checks
+*/
+static int CheckRelocated(uint32_t instruction, uint32_t address, uint32_t relocatedAddress, size_t* size)
+{
+    const uint32_t callerLinkRegister = 0xCAFE0000;
+    const PowerPC::Instruction original = PowerPC::Decode(instruction);
+    const uint32_t target = original.Absolute ? (uint32_t)original.Displacement : address + original.Displacement;
+    const bool conditional = original.Type == PowerPC::InstructionType_BranchConditional
+        && (original.BranchOptions & POWERPC_BRANCH_OPTIONS_ALWAYS) != POWERPC_BRANCH_OPTIONS_ALWAYS;
+    const bool decrements_count = original.Type == PowerPC::InstructionType_BranchConditional && !original.Absolute
+        && (original.BranchOptions & POWERPC_BRANCH_OPTIONS_NO_DECREMENT) == 0;
+
+    uint32_t code[PowerPC::MaxRelocatedSize / sizeof(uint32_t) + 1];
+    *size = PowerPC::Relocate(code, instruction, address, relocatedAddress);
+    int errors = 0;
+    errors += *size != PowerPC::Relocate(nullptr, instruction, address, relocatedAddress) ? 1 : 0;
+    errors += *size > PowerPC::MaxRelocatedSize ? 1 : 0;
+
+    // The target of the relocated branch would need the count register, absolute branches are copied as is
+    if (decrements_count && !PowerPC::IsInBranchRange(relocatedAddress + 2 * sizeof(uint32_t), target))
+        return errors + (*size != 0 ? 1 : 0);
+    if (*size == 0)
+        return errors + 1;
+
+    // bl $+4 only reads the program counter: the link register gets the original return address, the code carries on
+    if (original.Linked && !original.Absolute && target == address + sizeof(uint32_t) && !conditional)
+    {
+        const RelocatedExit exit = StepRelocated(code, *size, relocatedAddress, true, callerLinkRegister);
+        return errors + (!exit.Valid || exit.Address != relocatedAddress + *size || exit.LinkRegister != target ? 1 : 0);
+    }
+
+    // Taken: reaches the original target, a call returns right after the relocated sequence
+    RelocatedExit exit = StepRelocated(code, *size, relocatedAddress, true, callerLinkRegister);
+    errors += !exit.Valid || exit.Address != target ? 1 : 0;
+    errors += exit.LinkRegister != (original.Linked ? relocatedAddress + (uint32_t)*size : callerLinkRegister) ? 1 : 0;
+
+    // Not taken: falls through to the end of the sequence
+    if (conditional)
+    {
+        exit = StepRelocated(code, *size, relocatedAddress, false, callerLinkRegister);
+        errors += !exit.Valid || exit.Address != relocatedAddress + *size ? 1 : 0;
+    }
+    return errors;
+}
+
+// Relocates every branch form, near and far from where it was, and checks the relocated code goes where the original did.
+static void TestRelocateRoundTrip()
+{
+    const uint32_t forms[] = {
+        POWERPC_B(0x1000, false, false),                // b
+        POWERPC_B(-0x1000, false, true),                // bl
+        POWERPC_B(0x01FFFFFC, false, false),            // b, furthest forward
+        POWERPC_B(-0x02000000, false, true),            // bl, furthest backward
+        POWERPC_B(0x2000, true, false),                 // ba
+        POWERPC_B(0x2000, true, true),                  // bla
+        POWERPC_B(4, false, true),                      // bl $+4
+        POWERPC_BC(20, 31, 4, false, true),             // bcl 20, 31, $+4
+        POWERPC_BC(20, 0, -0x40, false, false),         // bc always
+        POWERPC_BC(12, 2, 0x40, false, false),          // beq
+        POWERPC_BC(4, 0, -0x8000, false, true),         // bgel, furthest backward
+        POWERPC_BC(12, 1, 0x7FFC, false, false),        // bgt, furthest forward
+        POWERPC_BC(12, 2, 0x100, true, false),          // beqa
+        POWERPC_BC(16, 0, -0x10, false, false),         // bdnz
+        POWERPC_BC(0, 2, 0x20, false, true),            // bdnzfl
+    };
+    const uint32_t address = 0x10010000;
+    const uint32_t relocatedAddresses[] = { address + 0x100, address - 0x00800000, address + 0x01F00000, 0x30000000, 0x00001000 };
+
+    for (size_t form_n = 0; form_n < sizeof(forms) / sizeof(forms[0]); form_n++)
+        for (size_t relocated_n = 0; relocated_n < sizeof(relocatedAddresses) / sizeof(relocatedAddresses[0]); relocated_n++)
+        {
+            size_t size;
+            const int errors = CheckRelocated(forms[form_n], address, relocatedAddresses[relocated_n], &size);
+            if (errors != 0)
+                printf("relocate 0x%08X from 0x%08X to 0x%08X: %d failed checks\n", forms[form_n], address, relocatedAddresses[relocated_n], errors);
+            TEST_CHECK(errors == 0);
+        }
+}
+
+// A random b, bc or bl anywhere, or a bdnz or 'bl $+4'.
+static uint32_t RandomBranch(std::mt19937& rng)
+{
+    static const uint8_t conditions[] = { 4, 12, 20, 16, 18, 0, 8, 2, 10 };     // bne/beq/always/bdnz/bdz/bdnzf/bdnzt/bdzf/bdzt
+    switch (rng() % 6)
+    {
+    case 0:  return POWERPC_B((int32_t)(rng() & 0x03FFFFFC) - 0x02000000, rng() % 8 == 0, rng() % 2);                               // b, bl, ba, bla
+    case 1:
+    case 2:  return POWERPC_BC(conditions[rng() % sizeof(conditions)], rng() % 32, (int32_t)(rng() & 0xFFFC) - 0x8000, rng() % 8 == 0, rng() % 2);
+    case 3:  return POWERPC_BC(16, 0, (int32_t)(rng() & 0xFFFC) - 0x8000, false, false);                                            // bdnz
+    case 4:  return rng() % 2 ? POWERPC_B(4, false, true) : POWERPC_BC(20, 31, 4, false, true);                                     // bl/bcl $+4
+    default: return POWERPC_B((int32_t)(rng() & 0x0000FFFC) - 0x8000, false, false);                                               // short b
+    }
+}
+
+// Thousands of random branches relocated near (in reach of a single 'b' back to the target) and anywhere in the address space.
+static void TestRelocateSweep()
+{
+    std::mt19937 rng(2024);
+    int errors = 0;
+    size_t near = 0, far = 0, refused = 0;
+    for (int n = 0; n < 50000; n++)
+    {
+        const uint32_t instruction = RandomBranch(rng);
+        const uint32_t address = rng() & ~3u;
+        const uint32_t relocatedAddress = n % 2 ? address + ((int32_t)(rng() & 0x01FFFFFC) - 0x01000000) : rng() & ~3u;
+
+        size_t size;
+        const int failed = CheckRelocated(instruction, address, relocatedAddress, &size);
+        if (failed != 0 && errors < 5)
+            printf("relocate 0x%08X from 0x%08X to 0x%08X: %d failed checks\n", instruction, address, relocatedAddress, failed);
+        errors += failed;
+        near += size == 4 ? 1 : 0;
+        far += size > 12 ? 1 : 0;
+        refused += size == 0 ? 1 : 0;
+    }
+    TEST_CHECK(errors == 0);
+    TEST_CHECK(near > 5000 && far > 5000 && refused > 1000);
+}
+
+// Relocating the instructions a hook overwrites, the bulk of assembling a trampoline.
+static void BenchRelocate()
+{
+    std::mt19937 rng(7);
+    const int count = 100000;
+    std::vector<uint32_t> instructions(count), addresses(count), relocated(count);
+    for (int n = 0; n < count; n++)
+    {
+        // Mostly plain instructions, like the prologue of a function
+        instructions[n] = rng() % 4 ? POWERPC_LI(POWERPC_REGISTERINDEX_R3, rng() & 0x7FFF) : RandomBranch(rng);
+        addresses[n] = rng() & ~3u;
+        relocated[n] = n % 2 ? addresses[n] + 0x100000 : rng() & ~3u;
+    }
+    std::vector<uint32_t> code(PowerPC::MaxRelocatedSize / sizeof(uint32_t));
+    size_t total = 0;
+    const double us = BenchmarkBest(10, [&]()
+    {
+        total = 0;
+        for (int n = 0; n < count; n++)
+            total += PowerPC::Relocate(code.data(), instructions[n], addresses[n], relocated[n]);
+    });
+    printf("  relocate %d instructions: %8.0f us, %5.1f ns each (%zu bytes)\n", count, us, us * 1000.0 / count, total);
+}
+
+void RunPowerPCTests(bool bench)
+{
+    TestDecode();
+    TestBranchRange();
+    TestAssembleBranch();
+    TestRelocateSize();
+    TestRelocateRoundTrip();
+    TestRelocateSweep();
+
+    if (bench)
+        BenchRelocate();
+}
@@ -0,0 +1,196 @@
+// The PSGL backend's redundant state filter, through a GL dispatch table recording what reaches "GL".
+#include "Test.hpp"
+#include "imgui_impl_psgl_internal.h"
+#include <random>
+#include <string.h>
+
+// Stand-ins for the GL enums the backend tracks, values don't matter
+static const unsigned int s_Capabilities[] = { 0xBE2, 0xB44, 0xB71, 0xB90, 0xB50, 0xB57, 0xC11, 0xDE1 };
+static const unsigned int s_ClientStates[] = { 0x8074, 0x8078, 0x8076, 0x8075 };
+
+// GL as the recorder sees it: current state, and how many calls reached it
+struct GLRecorder
+{
+    bool            Capabilities[IM_ARRAYSIZE(s_Capabilities)];
+    bool            ClientStates[IM_ARRAYSIZE(s_ClientStates)];
+    unsigned int    Texture;
+    int             Scissor[4];
+    int             Calls;
+};
+static GLRecorder s_GL;
+
+static int IndexOf(const unsigned int* list, int count, unsigned int value)
+{
+    for (int n = 0; n < count; n++)
+        if (list[n] == value)
+            return n;
+    return -1;
+}
+
+static void RecordSetCapability(unsigned int cap, bool enable)      { s_GL.Capabilities[IndexOf(s_Capabilities, IM_ARRAYSIZE(s_Capabilities), cap)] = enable; s_GL.Calls++; }
+static void RecordSetClientState(unsigned int array, bool enable)   { s_GL.ClientStates[IndexOf(s_ClientStates, IM_ARRAYSIZE(s_ClientStates), array)] = enable; s_GL.Calls++; }
+static void RecordBindTexture(unsigned int texture)                 { s_GL.Texture = texture; s_GL.Calls++; }
+static void RecordScissor(int x, int y, int w, int h)               { s_GL.Scissor[0] = x; s_GL.Scissor[1] = y; s_GL.Scissor[2] = w; s_GL.Scissor[3] = h; s_GL.Calls++; }
+static const ImGui_ImplPSGL_StateFuncs s_RecordFuncs = { RecordSetCapability, RecordSetClientState, RecordBindTexture, RecordScissor };
+
+static void InitFilter(ImGui_ImplPSGL_StateFilter* filter, ImGui_ImplPSGL_FrameStats* stats)
+{
+    memset(&s_GL, 0, sizeof(s_GL));
+    memset(stats, 0, sizeof(*stats));
+    ImGui_ImplPSGL_StateFilterInit(filter, &s_RecordFuncs, s_Capabilities, IM_ARRAYSIZE(s_Capabilities), s_ClientStates, IM_ARRAYSIZE(s_ClientStates));
+}
+
+// Each kind of state: issued while unknown, skipped (and counted) when unchanged, issued again once changed or invalidated.
+static void TestFilterBasics()
+{
+    ImGui_ImplPSGL_StateFilter filter;
+    ImGui_ImplPSGL_FrameStats stats;
+    InitFilter(&filter, &stats);
+
+    // Unknown state is always issued, even when it would match what GL happens to have
+    ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[0], false, &stats);
+    ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[0], false, &stats);
+    ImGui_ImplPSGL_StateFilterBindTexture(&filter, 0, &stats);
+    ImGui_ImplPSGL_StateFilterSetScissor(&filter, 0, 0, 0, 0, &stats);
+    TEST_CHECK(s_GL.Calls == 4);
+
+    // Same again: nothing reaches GL
+    ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[0], false, &stats);
+    ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[0], false, &stats);
+    ImGui_ImplPSGL_StateFilterBindTexture(&filter, 0, &stats);
+    ImGui_ImplPSGL_StateFilterSetScissor(&filter, 0, 0, 0, 0, &stats);
+    TEST_CHECK(s_GL.Calls == 4);
+    TEST_CHECK(stats.ElidedStateToggles == 2 && stats.ElidedTextureBinds == 1 && stats.ElidedScissors == 1);
+
+    // Bits are tracked one by one: another capability is still unknown
+    ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[7], false, &stats);
+    ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[3], false, &stats);
+    TEST_CHECK(s_GL.Calls == 6);
+
+    // Changes go through, each scissor component counts
+    ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[0], true, &stats);
+    ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[0], true, &stats);
+    ImGui_ImplPSGL_StateFilterBindTexture(&filter, 7, &stats);
+    for (int n = 0; n < 4; n++)
+    {
+        int scissor[4] = { 0, 0, 0, 0 };
+        scissor[n] = 1;
+        ImGui_ImplPSGL_StateFilterSetScissor(&filter, scissor[0], scissor[1], scissor[2], scissor[3], &stats);
+    }
+    TEST_CHECK(s_GL.Calls == 6 + 3 + 4);
+    TEST_CHECK(s_GL.Capabilities[0] && s_GL.ClientStates[0] && s_GL.Texture == 7 && s_GL.Scissor[3] == 1);
+
+    // A user callback may have changed anything: after invalidating, everything is issued again once
+    ImGui_ImplPSGL_StateFilterInvalidate(&filter);
+    const int calls = s_GL.Calls;
+    for (int repeat = 0; repeat < 2; repeat++)
+    {
+        ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[0], true, &stats);
+        ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[0], true, &stats);
+        ImGui_ImplPSGL_StateFilterBindTexture(&filter, 7, &stats);
+        ImGui_ImplPSGL_StateFilterSetScissor(&filter, 0, 0, 0, 1, &stats);
+    }
+    TEST_CHECK(s_GL.Calls == calls + 4);
+}
+
+// Random calls against a model of GL: the filter never lets GL drift from what was asked, and only skips calls that changed nothing.
+static void TestFilterRandom()
+{
+    ImGui_ImplPSGL_StateFilter filter;
+    ImGui_ImplPSGL_FrameStats stats;
+    InitFilter(&filter, &stats);
+    std::mt19937 rng(1234);
+
+    // What the caller asked for, and whether GL is known to have it
+    bool capabilities[IM_ARRAYSIZE(s_Capabilities)] = {};
+    bool client_states[IM_ARRAYSIZE(s_ClientStates)] = {};
+    bool capabilities_known[IM_ARRAYSIZE(s_Capabilities)] = {};
+    bool client_states_known[IM_ARRAYSIZE(s_ClientStates)] = {};
+    unsigned int texture = 0;
+    int scissor[4] = {};
+    bool texture_known = false, scissor_known = false;
+    int expected_calls = 0;
+    unsigned int expected_elided = 0;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        const int op = (int)(rng() % 100);
+        if (op < 2)
+        {
+            // User callback: GL state gets scrambled behind the filter's back
+            ImGui_ImplPSGL_StateFilterInvalidate(&filter);
+            for (int n = 0; n < IM_ARRAYSIZE(s_Capabilities); n++)
+                s_GL.Capabilities[n] = (rng() & 1) != 0;
+            s_GL.Texture = rng() % 4;
+            memset(capabilities_known, 0, sizeof(capabilities_known));
+            memset(client_states_known, 0, sizeof(client_states_known));
+            texture_known = scissor_known = false;
+            continue;
+        }
+        if (op < 40)
+        {
+            const int n = (int)(rng() % IM_ARRAYSIZE(s_Capabilities));
+            const bool enable = (rng() & 1) != 0;
+            const bool redundant = capabilities_known[n] && capabilities[n] == enable;
+            expected_calls += redundant ? 0 : 1;
+            expected_elided += redundant ? 1 : 0;
+            ImGui_ImplPSGL_StateFilterSetCapability(&filter, s_Capabilities[n], enable, &stats);
+            capabilities[n] = enable;
+            capabilities_known[n] = true;
+        }
+        else if (op < 60)
+        {
+            const int n = (int)(rng() % IM_ARRAYSIZE(s_ClientStates));
+            const bool enable = (rng() & 1) != 0;
+            const bool redundant = client_states_known[n] && client_states[n] == enable;
+            expected_calls += redundant ? 0 : 1;
+            expected_elided += redundant ? 1 : 0;
+            ImGui_ImplPSGL_StateFilterSetClientState(&filter, s_ClientStates[n], enable, &stats);
+            client_states[n] = enable;
+            client_states_known[n] = true;
+        }
+        else if (op < 80)
+        {
+            const unsigned int value = rng() % 4;
+            const bool redundant = texture_known && texture == value;
+            expected_calls += redundant ? 0 : 1;
+            ImGui_ImplPSGL_StateFilterBindTexture(&filter, value, &stats);
+            texture = value;
+            texture_known = true;
+        }
+        else
+        {
+            int value[4];
+            for (int n = 0; n < 4; n++)
+                value[n] = (int)(rng() % 2);
+            const bool redundant = scissor_known && memcmp(value, scissor, sizeof(value)) == 0;
+            expected_calls += redundant ? 0 : 1;
+            ImGui_ImplPSGL_StateFilterSetScissor(&filter, value[0], value[1], value[2], value[3], &stats);
+            memcpy(scissor, value, sizeof(value));
+            scissor_known = true;
+        }
+
+        // Whatever the filter knows about matches GL
+        bool in_sync = true;
+        for (int n = 0; n < IM_ARRAYSIZE(s_Capabilities); n++)
+            in_sync &= !capabilities_known[n] || s_GL.Capabilities[n] == capabilities[n];
+        for (int n = 0; n < IM_ARRAYSIZE(s_ClientStates); n++)
+            in_sync &= !client_states_known[n] || s_GL.ClientStates[n] == client_states[n];
+        in_sync &= !texture_known || s_GL.Texture == texture;
+        in_sync &= !scissor_known || memcmp(s_GL.Scissor, scissor, sizeof(scissor)) == 0;
+        if (!in_sync)
+        {
+            TEST_CHECK(in_sync);
+            break;
+        }
+    }
+    TEST_CHECK(s_GL.Calls == expected_calls);
+    TEST_CHECK(stats.ElidedStateToggles == expected_elided);
+    TEST_CHECK(stats.ElidedTextureBinds > 0 && stats.ElidedScissors > 0);
+}
+
+void RunPsglStateTests(bool)
+{
+    TestFilterBasics();
+    TestFilterRandom();
+}
@@ -0,0 +1,168 @@
+// StubIndex against the linear scan it replaces, on synthetic import/export tables.
+#include "Test.hpp"
+#include "StubIndex.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Backing storage of a synthetic table: every library owns its fnid and stub arrays.
+struct SyntheticLibrary
+{
+    char                     Name[32];
+    std::vector<uint32_t>    Fnids;
+    std::vector<opd_s*>      Stubs;
+};
+
+static std::vector<opd_s> s_Opds(4096);
+
+static void BuildLibraries(std::vector<SyntheticLibrary>& libraries, int libraryCount, int functionsPerLibrary)
+{
+    srand(42);
+    libraries.resize(libraryCount);
+    int opd = 0;
+    for (int l = 0; l < libraryCount; l++)
+    {
+        SyntheticLibrary& library = libraries[l];
+        // Every few libraries reuse a name, as a module importing from the same library twice would
+        snprintf(library.Name, sizeof(library.Name), "cellLibrary%d", l % 7 == 6 ? l - 1 : l);
+        for (int f = 0; f < functionsPerLibrary; f++)
+        {
+            // Small fnid range so the same fnid shows up in many libraries, and sometimes twice in one
+            library.Fnids.push_back((uint32_t)(rand() % 512) * 0x01010101u);
+            library.Stubs.push_back(&s_Opds[opd++ % s_Opds.size()]);
+        }
+    }
+}
+
+template<typename StubT>
+static void FillTable(std::vector<StubT>& table, std::vector<SyntheticLibrary>& libraries, int16_t ssize)
+{
+    table.assign(libraries.size() + 1, StubT());
+    memset(table.data(), 0, table.size() * sizeof(StubT));
+    for (size_t l = 0; l < libraries.size(); l++)
+    {
+        table[l].ssize = ssize;
+        table[l].name = libraries[l].Name;
+        table[l].fnid = libraries[l].Fnids.data();
+        table[l].stub = libraries[l].Stubs.data();
+    }
+    // The last entry stays zeroed: its size doesn't match, which ends the table
+}
+
+// What the hooks did before StubIndex: walk every stub, first match wins.
+static opd_s* FindLinear(const std::vector<SyntheticLibrary>& libraries, const char* library, uint32_t fnid)
+{
+    for (size_t l = 0; l < libraries.size(); l++)
+    {
+        if (strcmp(libraries[l].Name, library) != 0)
+            continue;
+        for (size_t f = 0; f < libraries[l].Fnids.size(); f++)
+            if (libraries[l].Fnids[f] == fnid)
+                return libraries[l].Stubs[f];
+    }
+    return nullptr;
+}
+
+static int CompareWithLinearScan(const StubIndex& index, const std::vector<SyntheticLibrary>& libraries, int libraryCount)
+{
+    int mismatches = 0;
+    char name[32];
+    // One library name past the end, and every fnid of the range plus some outside it
+    for (int l = 0; l <= libraryCount; l++)
+    {
+        snprintf(name, sizeof(name), "cellLibrary%d", l);
+        for (uint32_t fnid = 0; fnid < 520; fnid++)
+            if (index.Find(name, fnid * 0x01010101u) != FindLinear(libraries, name, fnid * 0x01010101u))
+                mismatches++;
+    }
+    return mismatches;
+}
+
+static void TestImports()
+{
+    const int libraryCount = 40;
+    std::vector<SyntheticLibrary> libraries;
+    BuildLibraries(libraries, libraryCount, 60);
+    std::vector<importStub_s> table;
+    FillTable(table, libraries, IMPORT_STUB_SIZE);
+    for (size_t l = 0; l < libraries.size(); l++)
+        table[l].imports = (int16_t)libraries[l].Fnids.size();
+
+    StubIndex index;
+    TEST_CHECK(!index.IsBuilt());
+    TEST_CHECK(index.Find("cellLibrary0", libraries[0].Fnids[0]) == nullptr);
+
+    index.BuildImports(table.data());
+    TEST_CHECK(index.IsBuilt());
+    TEST_CHECK(index.GetCount() > 0 && index.GetCount() < (size_t)libraryCount * 60);
+    TEST_CHECK(CompareWithLinearScan(index, libraries, libraryCount) == 0);
+
+    index.Clear();
+    TEST_CHECK(!index.IsBuilt() && index.GetCount() == 0);
+    TEST_CHECK(index.Find("cellLibrary0", libraries[0].Fnids[0]) == nullptr);
+
+    // Empty tables
+    index.BuildImports(nullptr);
+    TEST_CHECK(index.IsBuilt() && index.GetCount() == 0);
+    TEST_CHECK(index.Find("cellLibrary0", libraries[0].Fnids[0]) == nullptr);
+    index.BuildImports(&table[libraries.size()]);
+    TEST_CHECK(index.IsBuilt() && index.GetCount() == 0);
+}
+
+static void TestExports()
+{
+    const int libraryCount = 12;
+    std::vector<SyntheticLibrary> libraries;
+    BuildLibraries(libraries, libraryCount, 100);
+    std::vector<exportStub_s> table;
+    FillTable(table, libraries, EXPORT_STUB_SIZE);
+    for (size_t l = 0; l < libraries.size(); l++)
+        table[l].exports = (int16_t)libraries[l].Fnids.size();
+
+    // A table of the other kind ends right away
+    std::vector<importStub_s> wrongSize;
+    FillTable(wrongSize, libraries, EXPORT_STUB_SIZE);
+    StubIndex index;
+    index.BuildImports(wrongSize.data());
+    TEST_CHECK(index.GetCount() == 0);
+
+    // Rebuilding replaces the previous content
+    index.BuildExports(table.data());
+    TEST_CHECK(CompareWithLinearScan(index, libraries, libraryCount) == 0);
+}
+
+static void BenchLookup()
+{
+    const int libraryCount = 40;
+    std::vector<SyntheticLibrary> libraries;
+    BuildLibraries(libraries, libraryCount, 60);
+    std::vector<importStub_s> table;
+    FillTable(table, libraries, IMPORT_STUB_SIZE);
+    for (size_t l = 0; l < libraries.size(); l++)
+        table[l].imports = (int16_t)libraries[l].Fnids.size();
+
+    std::vector<const char*> names;
+    std::vector<uint32_t> fnids;
+    for (int i = 0; i < 1000; i++)
+    {
+        const SyntheticLibrary& library = libraries[rand() % libraryCount];
+        names.push_back(library.Name);
+        fnids.push_back(library.Fnids[rand() % library.Fnids.size()]);
+    }
+
+    StubIndex index;
+    uintptr_t sink = 0;
+    const double build = BenchmarkBest(20, [&]() { index.BuildImports(table.data()); });
+    const double indexed = BenchmarkBest(20, [&]() { for (size_t i = 0; i < names.size(); i++) sink += (uintptr_t)index.Find(names[i], fnids[i]); });
+    const double linear = BenchmarkBest(20, [&]() { for (size_t i = 0; i < names.size(); i++) sink += (uintptr_t)FindLinear(libraries, names[i], fnids[i]); });
+    printf("  %d stubs: build %.1f us, 1000 lookups %.1f us (linear scan %.1f us)%s\n", libraryCount * 60, build, indexed, linear, sink == 1 ? " " : "");
+}
+
+void RunStubIndexTests(bool bench)
+{
+    TestImports();
+    TestExports();
+
+    if (bench)
+        BenchLookup();
+}
@@ -0,0 +1,218 @@
+// Cached CalcTextSize() results (io.ConfigTextSizeCache) against measuring the text every time.
+#include "Test.hpp"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <string>
+
+static void NewFrame()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    unsigned char* pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+    ImGui::NewFrame();
+}
+
+// What CalcTextSize() returns with the cache off.
+static ImVec2 UncachedTextSize(const char* text, bool hide_text_after_double_hash = false, float wrap_width = -1.0f)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.ConfigTextSizeCache = false;
+    const ImVec2 size = ImGui::CalcTextSize(text, NULL, hide_text_after_double_hash, wrap_width);
+    io.ConfigTextSizeCache = true;
+    return size;
+}
+
+static bool SameSize(const ImVec2& a, const ImVec2& b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+// First lookup of a text misses, the next ones hit and return the same size. Empty ranges don't go through the cache.
+static void TestHitsMisses()
+{
+    const ImGuiTextSizeCache& cache = GImGui->TextSizeCache;
+    const ImVec2 expected = UncachedTextSize("Hello, world");
+    const ImU32 hits = cache.Hits, misses = cache.Misses;
+
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("Hello, world"), expected));
+    TEST_CHECK(cache.Hits == hits && cache.Misses == misses + 1);
+    for (int i = 0; i < 3; i++)
+        TEST_CHECK(SameSize(ImGui::CalcTextSize("Hello, world"), expected));
+    TEST_CHECK(cache.Hits == hits + 3 && cache.Misses == misses + 1);
+
+    // Same text through an explicit end, then a prefix of it: the length is part of the key
+    const char* text = "Hello, world";
+    TEST_CHECK(SameSize(ImGui::CalcTextSize(text, text + 12), expected));
+    TEST_CHECK(SameSize(ImGui::CalcTextSize(text, text + 5), UncachedTextSize("Hello")));
+    TEST_CHECK(cache.Hits == hits + 4 && cache.Misses == misses + 2);
+
+    ImGui::CalcTextSize(text, text);
+    TEST_CHECK(cache.Hits == hits + 4 && cache.Misses == misses + 2);
+}
+
+// The key selects a set of IMGUI_TEXT_SIZE_CACHE_WAYS entries: a new key replaces the least recently used one of its set only.
+static void TestEviction()
+{
+    ImGuiTextSizeCache cache;
+    bool hit;
+    ImGuiID keys[IMGUI_TEXT_SIZE_CACHE_WAYS + 1];
+    for (int n = 0; n < IMGUI_TEXT_SIZE_CACHE_WAYS + 1; n++)
+        keys[n] = 5 + (ImGuiID)n * IMGUI_TEXT_SIZE_CACHE_SETS;  // All in set 5
+
+    for (int n = 0; n < IMGUI_TEXT_SIZE_CACHE_WAYS; n++)
+    {
+        ImGuiTextSizeCacheEntry* entry = cache.GetEntry(keys[n], keys[n] * 7, 10, &hit);
+        TEST_CHECK(!hit);
+        entry->Size = ImVec2((float)n, 1.0f);
+    }
+    TEST_CHECK(cache.GetEntry(6, 42, 10, &hit) != NULL && !hit);  // Another set
+    TEST_CHECK(cache.GetEntry(keys[0], keys[0] * 7, 10, &hit)->Size.x == 0.0f && hit);
+
+    // The set is full: keys[1] is now the least recently used
+    cache.GetEntry(keys[IMGUI_TEXT_SIZE_CACHE_WAYS], keys[IMGUI_TEXT_SIZE_CACHE_WAYS] * 7, 10, &hit);
+    TEST_CHECK(!hit);
+    for (int n = 2; n < IMGUI_TEXT_SIZE_CACHE_WAYS; n++)
+        TEST_CHECK(cache.GetEntry(keys[n], keys[n] * 7, 10, &hit)->Size.x == (float)n && hit);
+    TEST_CHECK(cache.GetEntry(keys[0], keys[0] * 7, 10, &hit)->Size.x == 0.0f && hit);
+    TEST_CHECK(cache.GetEntry(6, 42, 10, &hit) != NULL && hit);
+    cache.GetEntry(keys[1], keys[1] * 7, 10, &hit);
+    TEST_CHECK(!hit);
+    TEST_CHECK(cache.Hits == 5 && cache.Misses == IMGUI_TEXT_SIZE_CACHE_WAYS + 3);
+
+    // Through CalcTextSize(): many more texts than entries push the first one out
+    ImGuiTextSizeCache& context_cache = GImGui->TextSizeCache;
+    ImGui::CalcTextSize("Label 0");
+    for (int n = 1; n < IMGUI_TEXT_SIZE_CACHE_SETS * IMGUI_TEXT_SIZE_CACHE_WAYS * 8; n++)
+        ImGui::CalcTextSize(("Label " + std::to_string(n)).c_str());
+    const ImU32 misses = context_cache.Misses;
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("Label 0"), UncachedTextSize("Label 0")));
+    TEST_CHECK(context_cache.Misses == misses + 1);
+}
+
+// An entry only matches on its key, its second hash and its length: texts colliding on one of them get their own entry.
+static void TestCollisions()
+{
+    ImGuiTextSizeCache cache;
+    bool hit;
+    cache.GetEntry(1234, 1, 8, &hit)->Size = ImVec2(80.0f, 13.0f);
+    TEST_CHECK(!hit);
+
+    ImGuiTextSizeCacheEntry* entry = cache.GetEntry(1234, 2, 8, &hit);      // Same key, different second hash
+    TEST_CHECK(!hit && entry->Check == 2);
+    entry->Size = ImVec2(40.0f, 13.0f);
+    entry = cache.GetEntry(1234, 1, 9, &hit);                               // Same hashes, different length
+    TEST_CHECK(!hit && entry->TextLen == 9);
+    entry->Size = ImVec2(90.0f, 13.0f);
+
+    TEST_CHECK(cache.GetEntry(1234, 1, 8, &hit)->Size.x == 80.0f && hit);
+    TEST_CHECK(cache.GetEntry(1234, 2, 8, &hit)->Size.x == 40.0f && hit);
+    TEST_CHECK(cache.GetEntry(1234, 1, 9, &hit)->Size.x == 90.0f && hit);
+}
+
+// Labels are measured up to their ## or ###: "OK##a" and "OK###b" share the entry of "OK", unless the whole text is asked for.
+static void TestHiddenLabels()
+{
+    const ImGuiTextSizeCache& cache = GImGui->TextSizeCache;
+    const ImVec2 ok = UncachedTextSize("OK");
+    ImGui::CalcTextSize("OK");
+    const ImU32 hits = cache.Hits, misses = cache.Misses;
+
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("OK##a", NULL, true), ok));
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("OK##b", NULL, true), ok));
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("OK###c", NULL, true), ok));
+    TEST_CHECK(cache.Hits == hits + 3 && cache.Misses == misses);
+
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("OK##a"), UncachedTextSize("OK##a")));
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("OK##b"), UncachedTextSize("OK##b")));
+    TEST_CHECK(ImGui::CalcTextSize("OK##a").x > ok.x);
+    TEST_CHECK(cache.Misses == misses + 2);
+}
+
+// Wrap width and font size are part of the key: each one gets the size measured with it.
+static void TestWrapAndScale()
+{
+    const ImGuiTextSizeCache& cache = GImGui->TextSizeCache;
+    const char* text = "A paragraph long enough to wrap a few times at the narrow widths, and not at all at the wide one.";
+    const float wrap_widths[] = { -1.0f, 60.0f, 61.0f, 200.0f, 1000.0f };
+    ImVec2 sizes[IM_ARRAYSIZE(wrap_widths)];
+    for (int n = 0; n < IM_ARRAYSIZE(wrap_widths); n++)
+        sizes[n] = UncachedTextSize(text, false, wrap_widths[n]);
+    TEST_CHECK(sizes[1].y > sizes[3].y && sizes[3].y > sizes[4].y);
+
+    const ImU32 misses = cache.Misses;
+    for (int pass = 0; pass < 2; pass++)
+        for (int n = 0; n < IM_ARRAYSIZE(wrap_widths); n++)
+            TEST_CHECK(SameSize(ImGui::CalcTextSize(text, NULL, false, wrap_widths[n]), sizes[n]));
+    TEST_CHECK(cache.Misses == misses + IM_ARRAYSIZE(wrap_widths));
+
+    const ImVec2 unscaled = ImGui::CalcTextSize("Scaled");
+    ImGui::Begin("Scale");
+    const float scales[] = { 2.0f, 0.5f, 1.25f };
+    for (int n = 0; n < IM_ARRAYSIZE(scales); n++)
+    {
+        ImGui::SetWindowFontScale(scales[n]);
+        const ImVec2 expected = UncachedTextSize("Scaled");
+        TEST_CHECK(SameSize(ImGui::CalcTextSize("Scaled"), expected) && !SameSize(expected, unscaled));
+        TEST_CHECK(SameSize(ImGui::CalcTextSize("Scaled"), expected));
+    }
+    ImGui::SetWindowFontScale(1.0f);
+    TEST_CHECK(SameSize(ImGui::CalcTextSize("Scaled"), unscaled));
+    ImGui::End();
+}
+
+// Keys hold the font pointer, which a rebuilt atlas may hand out again: NewFrame() drops the entries once BuildCount changed.
+static void TestAtlasRebuild()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    const ImGuiTextSizeCache& cache = GImGui->TextSizeCache;
+    const ImVec2 before = ImGui::CalcTextSize("Rebuilt");
+    ImGui::EndFrame();
+
+    // Same font size, wider glyphs: the key may well be the same as before the rebuild
+    const int build_count = io.Fonts->BuildCount;
+    io.Fonts->Clear();
+    ImFontConfig config;
+    config.GlyphExtraSpacing.x = 2.0f;
+    io.Fonts->AddFontDefault(&config);
+    NewFrame();
+    TEST_CHECK(io.Fonts->BuildCount != build_count);
+
+    ImU32 hits = cache.Hits, misses = cache.Misses;
+    const ImVec2 rebuilt = ImGui::CalcTextSize("Rebuilt");
+    TEST_CHECK(SameSize(rebuilt, UncachedTextSize("Rebuilt")) && rebuilt.x > before.x);
+    TEST_CHECK(cache.Hits == hits && cache.Misses == misses + 1);
+
+    // Remapping a character changes sizes of the same font, at the same address: it counts as a rebuild
+    ImGui::EndFrame();
+    const int remap_count = io.Fonts->BuildCount;
+    io.Fonts->Fonts[0]->AddRemapChar('R', 0x4E00);    // Not in the font: 'R' advances by 1 px
+    NewFrame();
+    TEST_CHECK(io.Fonts->BuildCount != remap_count);
+
+    hits = cache.Hits;
+    misses = cache.Misses;
+    const ImVec2 remapped = ImGui::CalcTextSize("Rebuilt");
+    TEST_CHECK(SameSize(remapped, UncachedTextSize("Rebuilt")) && remapped.x < rebuilt.x);
+    TEST_CHECK(cache.Hits == hits && cache.Misses == misses + 1);
+}
+
+void RunTextSizeCacheTests(bool)
+{
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = NULL;
+    io.DisplaySize = ImVec2(1920, 1080);
+    io.ConfigTextSizeCache = true;
+    NewFrame();
+
+    TestHitsMisses();
+    TestEviction();
+    TestCollisions();
+    TestHiddenLabels();
+    TestWrapAndScale();
+    TestAtlasRebuild();
+
+    ImGui::EndFrame();
+    ImGui::DestroyContext();
+}
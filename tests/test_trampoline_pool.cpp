@@ -0,0 +1,159 @@
+// Trampoline slots handed out to Detour hooks by the prx hook example's TrampolinePool.
+#include "Test.hpp"
+#include "TrampolinePool.hpp"
+#include <random>
+#include <string.h>
+#include <vector>
+
+// Capacity is what the buffer holds in whole slots, up to MaxSlots. Nothing is in use at first.
+static void TestCapacity()
+{
+    struct CapacityCase { size_t BufferSize; size_t Capacity; };
+    const CapacityCase cases[] =
+    {
+        { 0,                                            0 },
+        { TrampolinePool::SlotSize - 1,                 0 },
+        { TrampolinePool::SlotSize,                     1 },
+        { TrampolinePool::SlotSize * 64,                64 },
+        { TrampolinePool::SlotSize * 65 - 1,            64 },
+        { TrampolinePool::SlotSize * TrampolinePool::MaxSlots, TrampolinePool::MaxSlots },
+        { TrampolinePool::SlotSize * 1000,              TrampolinePool::MaxSlots },
+    };
+    std::vector<uint8_t> buffer(TrampolinePool::SlotSize * 1000);
+    for (size_t n = 0; n < sizeof(cases) / sizeof(cases[0]); n++)
+    {
+        TrampolinePool pool(buffer.data(), cases[n].BufferSize);
+        TEST_CHECK(pool.GetCapacity() == cases[n].Capacity && pool.GetUsedCount() == 0);
+
+        // Exactly 'Capacity' slots come out, then the pool is exhausted and stays so
+        size_t allocated = 0;
+        while (allocated <= cases[n].Capacity && pool.Allocate() != nullptr)
+            allocated++;
+        TEST_CHECK(allocated == cases[n].Capacity && pool.GetUsedCount() == cases[n].Capacity);
+        TEST_CHECK(pool.Allocate() == nullptr && pool.GetUsedCount() == cases[n].Capacity);
+    }
+}
+
+// Slots tile the buffer lowest address first, and only slots the pool handed out can be freed, once.
+static void TestAllocateFree()
+{
+    std::vector<uint8_t> buffer(TrampolinePool::SlotSize * 64);
+    uint8_t* base = buffer.data();
+    TrampolinePool pool(base, buffer.size());
+
+    uint8_t* slots[64];
+    for (int n = 0; n < 64; n++)
+    {
+        slots[n] = pool.Allocate();
+        TEST_CHECK(slots[n] == base + n * TrampolinePool::SlotSize);
+        TEST_CHECK(pool.GetUsedCount() == (size_t)n + 1);
+    }
+    TEST_CHECK(pool.Allocate() == nullptr);
+
+    // Pointers that aren't a live slot are refused and change nothing
+    TEST_CHECK(!pool.Free(nullptr));
+    TEST_CHECK(!pool.Free(base - TrampolinePool::SlotSize));
+    TEST_CHECK(!pool.Free(base + buffer.size()));
+    TEST_CHECK(!pool.Free(slots[3] + 4));
+    TEST_CHECK(pool.GetUsedCount() == 64);
+
+    TEST_CHECK(pool.Free(slots[10]));
+    TEST_CHECK(pool.GetUsedCount() == 63);
+    TEST_CHECK(!pool.Free(slots[10]));              // Twice
+    TEST_CHECK(pool.GetUsedCount() == 63);
+
+    for (int n = 0; n < 64; n++)
+        if (n != 10)
+            TEST_CHECK(pool.Free(slots[n]));
+    TEST_CHECK(pool.GetUsedCount() == 0);
+    TEST_CHECK(!pool.Free(slots[0]));
+}
+
+// Freed slots come back first, most recently freed first: unhooking lets the next hook reuse the slot.
+static void TestReuse()
+{
+    std::vector<uint8_t> buffer(TrampolinePool::SlotSize * 8);
+    TrampolinePool pool(buffer.data(), buffer.size());
+
+    uint8_t* slots[8];
+    for (int n = 0; n < 4; n++)
+        slots[n] = pool.Allocate();
+
+    TEST_CHECK(pool.Free(slots[1]));
+    TEST_CHECK(pool.Allocate() == slots[1]);
+
+    TEST_CHECK(pool.Free(slots[0]));
+    TEST_CHECK(pool.Free(slots[2]));
+    TEST_CHECK(pool.Allocate() == slots[2]);
+    TEST_CHECK(pool.Allocate() == slots[0]);
+    TEST_CHECK(pool.Allocate() == buffer.data() + 4 * TrampolinePool::SlotSize);   // Then the untouched ones
+    TEST_CHECK(pool.GetUsedCount() == 5);
+}
+
+// Hooks installed and removed in random order, many times over the pool's capacity, like Detour::Hook()/UnHook() would:
+// no slot is ever handed to two live hooks, the counts follow, and the pool only runs out when every slot is live.
+static void TestHookCycles()
+{
+    const size_t capacity = 64;
+    std::vector<uint8_t> buffer(TrampolinePool::SlotSize * capacity, 0);
+    TrampolinePool pool(buffer.data(), buffer.size());
+    std::mt19937 rng(7);
+
+    // Each live hook stamps its id over its whole slot, as a trampoline write would, and checks it's still there when it unhooks
+    struct Hook { uint8_t* Slot; uint32_t Id; };
+    std::vector<Hook> live;
+    uint32_t next_id = 1;
+    int errors = 0, exhausted = 0;
+    for (int cycle = 0; cycle < 20000; cycle++)
+    {
+        // Phases leaning towards hooking then unhooking, so the pool keeps going from empty to full and back
+        const bool hook = live.empty() || (rng() % 100) < ((cycle / 1000) % 2 == 0 ? 70u : 30u);
+        if (hook)
+        {
+            uint8_t* slot = pool.Allocate();
+            if (slot == nullptr)
+            {
+                errors += live.size() != capacity ? 1 : 0;
+                exhausted++;
+                continue;
+            }
+            const bool in_buffer = slot >= buffer.data() && slot + TrampolinePool::SlotSize <= buffer.data() + buffer.size();
+            errors += !in_buffer || (size_t)(slot - buffer.data()) % TrampolinePool::SlotSize != 0 ? 1 : 0;
+            Hook h = { slot, next_id++ };
+            for (size_t n = 0; n < TrampolinePool::SlotSize; n += 4)
+                memcpy(slot + n, &h.Id, 4);
+            live.push_back(h);
+        }
+        else
+        {
+            const size_t index = rng() % live.size();
+            const Hook h = live[index];
+            for (size_t n = 0; n < TrampolinePool::SlotSize; n += 4)
+                errors += memcmp(h.Slot + n, &h.Id, 4) != 0 ? 1 : 0;
+            errors += !pool.Free(h.Slot) ? 1 : 0;
+            errors += pool.Free(h.Slot) ? 1 : 0;    // Unhooking twice must not free the slot again
+            live[index] = live.back();
+            live.pop_back();
+        }
+        errors += pool.GetUsedCount() != live.size() ? 1 : 0;
+    }
+    TEST_CHECK(errors == 0);
+    TEST_CHECK(exhausted > 100 && next_id > 5000);
+
+    // Unhook the rest: the whole pool is available again
+    for (size_t n = 0; n < live.size(); n++)
+        TEST_CHECK(pool.Free(live[n].Slot));
+    TEST_CHECK(pool.GetUsedCount() == 0 && pool.GetCapacity() == capacity);
+    size_t allocated = 0;
+    while (allocated <= capacity && pool.Allocate() != nullptr)
+        allocated++;
+    TEST_CHECK(allocated == capacity);
+}
+
+void RunTrampolinePoolTests(bool)
+{
+    TestCapacity();
+    TestAllocateFree();
+    TestReuse();
+    TestHookCycles();
+}
@@ -0,0 +1,226 @@
+// ImDrawList building into an ImDrawVtxArena (_ReserveVtxBuffer, _ClearFreeVtxBuffer) must give the same lists as the ImVector path,
+// whether the arena keeps up, runs out, or gets detached.
+#include "Test.hpp"
+#include "imgui.h"
+#include "imgui_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+// malloc() backed arena counting its calls, refusing allocations past 'Limit' live bytes
+struct CountingArena
+{
+    ImDrawVtxArena          Hook;
+    int                     Allocs;
+    int                     Frees;
+    int                     LiveBlocks;
+    size_t                  LiveBytes;
+    size_t                  Limit;
+};
+
+struct CountingArenaBlock
+{
+    size_t                  Size;
+    size_t                  _Padding;
+};
+
+static void* CountingArenaAlloc(size_t sz, void* user_data)
+{
+    CountingArena* arena = (CountingArena*)user_data;
+    if (arena->LiveBytes + sz > arena->Limit)
+        return NULL;
+    CountingArenaBlock* block = (CountingArenaBlock*)malloc(sizeof(CountingArenaBlock) + sz);
+    block->Size = sz;
+    memset(block + 1, 0xCD, sz); // Stale data, as if the block was used before
+    arena->Allocs++;
+    arena->LiveBlocks++;
+    arena->LiveBytes += sz;
+    return block + 1;
+}
+
+static void CountingArenaFree(void* ptr, void* user_data)
+{
+    CountingArena* arena = (CountingArena*)user_data;
+    if (ptr == NULL)
+        return;
+    CountingArenaBlock* block = (CountingArenaBlock*)ptr - 1;
+    arena->Frees++;
+    arena->LiveBlocks--;
+    arena->LiveBytes -= block->Size;
+    free(block);
+}
+
+static void InitArena(CountingArena* arena, size_t limit)
+{
+    memset(arena, 0, sizeof(*arena));
+    arena->Hook.AllocFunc = CountingArenaAlloc;
+    arena->Hook.FreeFunc = CountingArenaFree;
+    arena->Hook.UserData = arena;
+    arena->Limit = limit;
+}
+
+// Enough primitives for VtxBuffer to grow several times over
+static void BuildFrame(ImDrawList* draw_list, int frame)
+{
+    draw_list->_ResetForNewFrame();
+    draw_list->PushClipRectFullScreen();
+    draw_list->PushTextureID(ImGui::GetIO().Fonts->TexID);
+    for (int i = 0; i < 40 + frame * 10; i++)
+    {
+        const float x = (float)(i * 13 % 700), y = (float)(i * 29 % 500);
+        draw_list->AddRectFilled(ImVec2(x, y), ImVec2(x + 40.0f, y + 20.0f), IM_COL32(i * 7, 255 - i, 128, 255), 4.0f);
+        draw_list->AddCircleFilled(ImVec2(x + 20.0f, y + 60.0f), 12.0f + (float)(i % 5), IM_COL32_WHITE, 24);
+        draw_list->AddLine(ImVec2(x, y), ImVec2(x + 100.0f, y + 37.0f), IM_COL32(255, 0, 0, 200), 1.5f);
+        if (i % 8 == 0)
+        {
+            draw_list->PushClipRect(ImVec2(x, y), ImVec2(x + 200.0f, y + 200.0f));
+            draw_list->AddBezierCubic(ImVec2(x, y), ImVec2(x + 50.0f, y - 40.0f), ImVec2(x + 90.0f, y + 80.0f), ImVec2(x + 150.0f, y), IM_COL32(0, 255, 0, 255), 2.0f);
+            draw_list->PopClipRect();
+        }
+    }
+    draw_list->PopTextureID();
+    draw_list->PopClipRect();
+    draw_list->_PopUnusedDrawCmd();
+}
+
+static bool SameDrawList(const ImDrawList& a, const ImDrawList& b)
+{
+    if (a.VtxBuffer.Size != b.VtxBuffer.Size || a.IdxBuffer.Size != b.IdxBuffer.Size || a.CmdBuffer.Size != b.CmdBuffer.Size)
+        return false;
+    if (a.VtxBuffer.Size > 0 && memcmp(a.VtxBuffer.Data, b.VtxBuffer.Data, a.VtxBuffer.size_in_bytes()) != 0)
+        return false;
+    if (a.IdxBuffer.Size > 0 && memcmp(a.IdxBuffer.Data, b.IdxBuffer.Data, a.IdxBuffer.size_in_bytes()) != 0)
+        return false;
+    for (int n = 0; n < a.CmdBuffer.Size; n++)
+    {
+        const ImDrawCmd& ca = a.CmdBuffer[n];
+        const ImDrawCmd& cb = b.CmdBuffer[n];
+        if (memcmp(&ca.ClipRect, &cb.ClipRect, sizeof(ca.ClipRect)) != 0 || ca.TextureId != cb.TextureId)
+            return false;
+        if (ca.VtxOffset != cb.VtxOffset || ca.IdxOffset != cb.IdxOffset || ca.ElemCount != cb.ElemCount)
+            return false;
+    }
+    return true;
+}
+
+// Arena lists match heap lists frame after frame, and move to a fresh block on every reset so the GPU can keep reading the previous one.
+static void TestArenaFrames()
+{
+    ImDrawListSharedData* shared_data = ImGui::GetDrawListSharedData();
+    CountingArena arena;
+    InitArena(&arena, (size_t)-1);
+    ImDrawList arena_list(shared_data);
+    ImDrawList heap_list(shared_data);
+
+    const ImDrawVert* previous = NULL;
+    for (int frame = 0; frame < 6; frame++)
+    {
+        shared_data->VtxArena = &arena.Hook;
+        const int allocs = arena.Allocs;
+        BuildFrame(&arena_list, frame);
+        shared_data->VtxArena = NULL;
+        BuildFrame(&heap_list, frame);
+
+        TEST_CHECK(arena_list._VtxArena == &arena.Hook && heap_list._VtxArena == NULL);
+        TEST_CHECK(SameDrawList(arena_list, heap_list));
+        TEST_CHECK(arena.LiveBlocks == 1 && arena.LiveBytes == (size_t)arena_list.VtxBuffer.Capacity * sizeof(ImDrawVert));
+        TEST_CHECK(arena.Allocs == arena.Frees + 1);
+        if (frame == 0)
+            TEST_CHECK(arena.Allocs > 1); // Grew through the arena, each old block handed back
+        else
+            TEST_CHECK(arena.Allocs > allocs && arena_list.VtxBuffer.Data != previous);
+        previous = arena_list.VtxBuffer.Data;
+    }
+
+    // The frame without growth: exactly one block swap
+    shared_data->VtxArena = &arena.Hook;
+    BuildFrame(&arena_list, 0);
+    const int allocs = arena.Allocs;
+    BuildFrame(&arena_list, 0);
+    TEST_CHECK(arena.Allocs == allocs + 1 && arena.LiveBlocks == 1);
+    shared_data->VtxArena = NULL;
+
+    arena_list._ClearFreeMemory();
+    TEST_CHECK(arena.LiveBlocks == 0 && arena.LiveBytes == 0 && arena_list._VtxArena == NULL);
+    TEST_CHECK(arena_list.VtxBuffer.Data == NULL && arena_list.VtxBuffer.Capacity == 0);
+}
+
+// A full arena: the list falls back to the heap mid-frame and stays correct.
+static void TestArenaFull()
+{
+    ImDrawListSharedData* shared_data = ImGui::GetDrawListSharedData();
+    CountingArena arena;
+    InitArena(&arena, 4096);
+    ImDrawList arena_list(shared_data);
+    ImDrawList heap_list(shared_data);
+
+    shared_data->VtxArena = &arena.Hook;
+    BuildFrame(&arena_list, 3);
+    shared_data->VtxArena = NULL;
+    BuildFrame(&heap_list, 3);
+    TEST_CHECK(arena.Allocs > 0);
+    TEST_CHECK(arena_list._VtxArena == NULL && arena.LiveBlocks == 0);
+    TEST_CHECK(SameDrawList(arena_list, heap_list));
+
+    // Once on the heap, a list stays there even with room in the arena again
+    arena.Limit = (size_t)-1;
+    shared_data->VtxArena = &arena.Hook;
+    BuildFrame(&arena_list, 3);
+    shared_data->VtxArena = NULL;
+    TEST_CHECK(arena_list._VtxArena == NULL && arena.LiveBlocks == 0);
+    TEST_CHECK(SameDrawList(arena_list, heap_list));
+}
+
+// Arena detached from the shared data (backend shut down): the next reset moves the list to the heap and hands the block back.
+static void TestArenaDetach()
+{
+    ImDrawListSharedData* shared_data = ImGui::GetDrawListSharedData();
+    CountingArena arena;
+    InitArena(&arena, (size_t)-1);
+    ImDrawList arena_list(shared_data);
+    ImDrawList heap_list(shared_data);
+
+    shared_data->VtxArena = &arena.Hook;
+    BuildFrame(&arena_list, 1);
+    shared_data->VtxArena = NULL;
+    TEST_CHECK(arena_list._VtxArena == &arena.Hook && arena.LiveBlocks == 1);
+    const int capacity = arena_list.VtxBuffer.Capacity;
+
+    BuildFrame(&arena_list, 2);
+    BuildFrame(&heap_list, 2);
+    TEST_CHECK(arena_list._VtxArena == NULL && arena.LiveBlocks == 0 && arena.Allocs == arena.Frees);
+    TEST_CHECK(arena_list.VtxBuffer.Capacity >= capacity);
+    TEST_CHECK(SameDrawList(arena_list, heap_list));
+
+    // Arena storage can't be swapped into another ImVector: DeIndexAllBuffers() frees it first
+    shared_data->VtxArena = &arena.Hook;
+    BuildFrame(&arena_list, 1);
+    shared_data->VtxArena = NULL;
+    BuildFrame(&heap_list, 1);
+    ImDrawList* arena_lists[] = { &arena_list };
+    ImDrawList* heap_lists[] = { &heap_list };
+    ImDrawData arena_data, heap_data;
+    arena_data.CmdLists = arena_lists;
+    arena_data.CmdListsCount = 1;
+    heap_data.CmdLists = heap_lists;
+    heap_data.CmdListsCount = 1;
+    arena_data.DeIndexAllBuffers();
+    heap_data.DeIndexAllBuffers();
+    TEST_CHECK(arena_list._VtxArena == NULL && arena.LiveBlocks == 0);
+    TEST_CHECK(arena_data.TotalVtxCount == heap_data.TotalVtxCount && SameDrawList(arena_list, heap_list));
+}
+
+void RunVtxArenaTests(bool)
+{
+    ImGui::CreateContext();
+    ImGui::GetIO().DisplaySize = ImVec2(1280.0f, 720.0f);
+    ImDrawListSharedData* shared_data = ImGui::GetDrawListSharedData();
+    shared_data->ClipRectFullscreen = ImVec4(0.0f, 0.0f, 1280.0f, 720.0f);
+    shared_data->SetCircleTessellationMaxError(ImGui::GetStyle().CircleTessellationMaxError);
+    shared_data->InitialFlags = ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill | ImDrawListFlags_AllowVtxOffset;
+
+    TestArenaFrames();
+    TestArenaFull();
+    TestArenaDetach();
+
+    ImGui::DestroyContext();
+}
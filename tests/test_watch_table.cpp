@@ -0,0 +1,186 @@
+// WatchTable against a host buffer: how watches get coalesced into ranges, change and valid bits, refresh intervals and failed reads.
+#include "Test.hpp"
+#include "BufferReader.hpp"
+#include "WatchTable.hpp"
+#include <string.h>
+
+static const uint32_t s_Base = 0x10000;
+
+template<typename T>
+static T ReadBuffer(const BufferReader& reader, uint32_t address)
+{
+    T value;
+    memcpy(&value, &reader.Data[address - reader.Base], sizeof(T));
+    return value;
+}
+
+static void TestCoalescing()
+{
+    BufferReader reader(s_Base, 0x2000);
+    WatchTable* table = new WatchTable(reader);
+
+    // Within MaxGap of each other: one range, overlapping watches share their bytes
+    const int a = table->Add(s_Base + 0, WatchTable::Type_UInt32);
+    const int b = table->Add(s_Base + 1, WatchTable::Type_UInt8);
+    const int c = table->Add(s_Base + 8, WatchTable::Type_Int16);
+    const int d = table->Add(s_Base + 70, WatchTable::Type_Float);
+    // Further away: a range of its own
+    const int e = table->Add(s_Base + 200, WatchTable::Type_Bytes, 1, 24);
+    // Every watch within the gap of the previous one, but more than MaxRangeSize in total: split
+    int chain[20];
+    for (int i = 0; i < 20; i++)
+        chain[i] = table->Add(s_Base + 2000 + i * 60, WatchTable::Type_UInt32);
+    TEST_CHECK(table->GetCount() == 25);
+
+    table->Update();
+    TEST_CHECK(table->GetRangeCount() == 4);
+    TEST_CHECK(reader.Reads == 4);
+
+    TEST_CHECK(table->Get<uint32_t>(a) == ReadBuffer<uint32_t>(reader, s_Base + 0));
+    TEST_CHECK(table->Get<uint8_t>(b) == ReadBuffer<uint8_t>(reader, s_Base + 1));
+    TEST_CHECK(table->Get<int16_t>(c) == ReadBuffer<int16_t>(reader, s_Base + 8));
+    TEST_CHECK(memcmp(table->GetData(d), &reader.Data[70], 4) == 0);
+    TEST_CHECK(table->GetSize(e) == 24 && memcmp(table->GetData(e), &reader.Data[200], 24) == 0);
+    TEST_CHECK(table->GetType(e) == WatchTable::Type_Bytes);
+    for (int i = 0; i < 20; i++)
+        TEST_CHECK(table->Get<uint32_t>(chain[i]) == ReadBuffer<uint32_t>(reader, s_Base + 2000 + i * 60));
+
+    // Invalid sizes
+    TEST_CHECK(table->Add(s_Base, WatchTable::Type_Bytes, 1, 0) == WatchTable::InvalidHandle);
+    TEST_CHECK(table->Add(s_Base, WatchTable::Type_Bytes, 1, WatchTable::MaxRangeSize + 1) == WatchTable::InvalidHandle);
+
+    delete table;
+}
+
+static void TestChangeBits()
+{
+    BufferReader reader(s_Base, 0x1000);
+    WatchTable* table = new WatchTable(reader);
+    const int a = table->Add(s_Base + 0x10, WatchTable::Type_UInt32);
+    const int b = table->Add(s_Base + 0x14, WatchTable::Type_UInt32);
+    const int c = table->Add(s_Base + 0x800, WatchTable::Type_Double);
+    TEST_CHECK(!table->IsValid(a) && !table->IsValid(c));
+
+    // First read: everything changed
+    table->Update();
+    TEST_CHECK(table->IsValid(a) && table->IsValid(b) && table->IsValid(c));
+    TEST_CHECK(table->HasChanged(a) && table->HasChanged(b) && table->HasChanged(c));
+
+    // Nothing moved
+    table->Update();
+    TEST_CHECK(!table->HasChanged(a) && !table->HasChanged(b) && !table->HasChanged(c));
+    TEST_CHECK(table->GetChangedBits()[0] == 0);
+
+    // One byte of b moved: only b changed, in the same range as a
+    reader.Data[0x16] ^= 0xFF;
+    table->Update();
+    TEST_CHECK(!table->HasChanged(a) && table->HasChanged(b) && !table->HasChanged(c));
+    TEST_CHECK(table->GetChangedBits()[0] == (1u << b));
+    TEST_CHECK(table->Get<uint32_t>(b) == ReadBuffer<uint32_t>(reader, s_Base + 0x14));
+
+    // Adding a watch rebuilds the ranges: every watch reports a change on its next read
+    const int d = table->Add(s_Base + 0x18, WatchTable::Type_UInt8);
+    table->Update();
+    TEST_CHECK(table->HasChanged(a) && table->HasChanged(b) && table->HasChanged(c) && table->HasChanged(d));
+
+    // Removed watches lose their bits
+    table->Remove(b);
+    TEST_CHECK(!table->IsValid(b));
+    table->Update();
+    TEST_CHECK(table->GetCount() == 3 && !table->HasChanged(b));
+
+    table->Clear();
+    table->Update();
+    TEST_CHECK(table->GetCount() == 0 && table->GetRangeCount() == 0 && !table->IsValid(a));
+
+    delete table;
+}
+
+static void TestRefreshInterval()
+{
+    BufferReader reader(s_Base, 0x1000);
+    WatchTable* table = new WatchTable(reader);
+
+    // Alone in its range: read every third update
+    const int slow = table->Add(s_Base + 0x800, WatchTable::Type_UInt32, 3);
+    table->Update();
+    TEST_CHECK(reader.Reads == 1);
+    for (int i = 0; i < 6; i++)
+        table->Update();
+    TEST_CHECK(reader.Reads == 3);
+
+    // Changes show up on the next read, not before
+    reader.Data[0x800] ^= 0xFF;
+    table->Update();
+    table->Update();
+    TEST_CHECK(!table->HasChanged(slow) && table->Get<uint32_t>(slow) != ReadBuffer<uint32_t>(reader, s_Base + 0x800));
+    table->Update();
+    TEST_CHECK(table->HasChanged(slow) && table->Get<uint32_t>(slow) == ReadBuffer<uint32_t>(reader, s_Base + 0x800));
+
+    // Sharing a range with a watch read every update: read every update as well
+    table->Add(s_Base + 0x804, WatchTable::Type_UInt32, 1);
+    reader.Reads = 0;
+    for (int i = 0; i < 5; i++)
+        table->Update();
+    TEST_CHECK(reader.Reads == 5);
+
+    delete table;
+}
+
+static void TestFailedRead()
+{
+    BufferReader reader(s_Base, 0x1000);
+    WatchTable* table = new WatchTable(reader);
+    const int a = table->Add(s_Base + 0x100, WatchTable::Type_UInt32);
+    const int b = table->Add(s_Base + 0x800, WatchTable::Type_UInt32);
+
+    // Never read successfully: not valid
+    reader.ScribbleOnError = true;
+    reader.BadBegin = s_Base + 0x800;
+    reader.BadEnd = s_Base + 0x804;
+    table->Update();
+    TEST_CHECK(table->IsValid(a) && !table->IsValid(b) && !table->HasChanged(b));
+
+    // A failed read keeps the last values and reports no change
+    reader.BadBegin = s_Base + 0x100;
+    reader.BadEnd = s_Base + 0x104;
+    const uint32_t before = table->Get<uint32_t>(a);
+    reader.Data[0x100] ^= 0xFF;
+    table->Update();
+    TEST_CHECK(table->IsValid(a) && !table->HasChanged(a) && table->Get<uint32_t>(a) == before);
+    TEST_CHECK(table->IsValid(b) && table->HasChanged(b));
+
+    // Back: the change shows up
+    reader.BadBegin = reader.BadEnd = 0;
+    table->Update();
+    TEST_CHECK(table->HasChanged(a) && !table->HasChanged(b));
+    TEST_CHECK(table->Get<uint32_t>(a) == ReadBuffer<uint32_t>(reader, s_Base + 0x100));
+
+    delete table;
+}
+
+static void TestFullTable()
+{
+    BufferReader reader(s_Base, 0x1000);
+    WatchTable* table = new WatchTable(reader);
+    for (size_t i = 0; i < WatchTable::MaxWatches; i++)
+        TEST_CHECK(table->Add(s_Base + (uint32_t)i * 8, WatchTable::Type_UInt64) == (int)i);
+    TEST_CHECK(table->Add(s_Base, WatchTable::Type_UInt8) == WatchTable::InvalidHandle);
+
+    // 256 contiguous 8 byte watches: two ranges of at most MaxRangeSize bytes
+    table->Update();
+    TEST_CHECK(table->GetRangeCount() == 2 && reader.Reads == 2);
+    for (size_t i = 0; i < WatchTable::MaxWatches; i++)
+        TEST_CHECK(table->HasChanged((int)i) && table->Get<uint64_t>((int)i) == ReadBuffer<uint64_t>(reader, s_Base + (uint32_t)i * 8));
+
+    delete table;
+}
+
+void RunWatchTableTests(bool)
+{
+    TestCoalescing();
+    TestChangeBits();
+    TestRefreshInterval();
+    TestFailedRead();
+    TestFullTable();
+}